@@ -0,0 +1,357 @@
+/**
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <QAbstractTableModel>
+#include <QImage>
+#include <QPainter>
+
+#include <KChartChart>
+#include <KChartGlobal>
+#include <KChartCartesianAxis>
+#include <KChartCartesianCoordinatePlane>
+#include <KChartPolarCoordinatePlane>
+#include <KChartLineDiagram>
+#include <KChartBarDiagram>
+#include <KChartPlotter>
+#include <KChartStockDiagram>
+#include <KChartPieDiagram>
+#include <KChartPolarDiagram>
+#include <KChartDataValueAttributes>
+#include <KChartTextAttributes>
+#include <KChartTextLayoutItem>
+
+#include <KChartCartesianDiagramDataCompressor_p.h>
+
+#include <cmath>
+
+using namespace KChart;
+
+/*
+ * The benchmarks are meant to be run with one of the machine readable
+ * output formats of QTestLib, e.g.
+ *     KChartBenchmarks -o kchart-benchmarks.xml,xml
+ * The "run_kchart_benchmarks" build target does exactly that.
+ */
+
+// A read-only model that computes its values on the fly, so that even the
+// 1M point data sets do not need any storage.
+class BenchmarkModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Kind {
+        Values,     // one value per cell
+        XYPairs,    // column pairs of (x, y) values, as used by Plotter
+        OHLC        // column quadruples of (open, high, low, close) values
+    };
+
+    BenchmarkModel( int rows, int columns, Kind kind, QObject* parent = nullptr )
+        : QAbstractTableModel( parent ),
+          m_rows( rows ),
+          m_columns( columns ),
+          m_kind( kind )
+    {
+    }
+
+    int rowCount( const QModelIndex& parent = QModelIndex() ) const override
+    {
+        return parent.isValid() ? 0 : m_rows;
+    }
+
+    int columnCount( const QModelIndex& parent = QModelIndex() ) const override
+    {
+        return parent.isValid() ? 0 : m_columns;
+    }
+
+    QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const override
+    {
+        if ( role != Qt::DisplayRole || !index.isValid() )
+            return QVariant();
+        const int row = index.row();
+        const int column = index.column();
+        switch ( m_kind ) {
+        case XYPairs:
+            if ( column % 2 == 0 )
+                return qreal( row );
+            return value( row, column / 2 );
+        case OHLC: {
+            const qreal base = value( row, column / 4 ) + 5.0;
+            switch ( column % 4 ) {
+            case 0: return base - 0.5;
+            case 1: return base + 1.0;
+            case 2: return base - 1.0;
+            default: return base + 0.5;
+            }
+        }
+        case Values:
+            break;
+        }
+        return value( row, column );
+    }
+
+private:
+    static qreal value( int row, int dataset )
+    {
+        return 10.0 + 5.0 * std::sin( row * 0.01 + dataset ) + ( ( row * 7 + dataset * 13 ) % 11 ) * 0.1;
+    }
+
+    int m_rows;
+    int m_columns;
+    Kind m_kind;
+};
+
+class BenchKChart : public QObject
+{
+    Q_OBJECT
+private:
+    enum DiagramType {
+        Line,
+        Bar,
+        Plot,
+        Stock,
+        Pie,
+        Polar
+    };
+
+    static void addSizeRows()
+    {
+        QTest::newRow( "1k" ) << 1000;
+        QTest::newRow( "100k" ) << 100000;
+        QTest::newRow( "1M" ) << 1000000;
+    }
+
+    // Creates a chart showing \a points values in a diagram of the given type.
+    // The chart owns the diagram, the model is a child of the chart.
+    static Chart* createChart( DiagramType type, int points )
+    {
+        Chart* chart = new Chart( nullptr );
+        AbstractDiagram* diagram = nullptr;
+        BenchmarkModel* model = nullptr;
+        switch ( type ) {
+        case Line:
+            model = new BenchmarkModel( points / DataSets, DataSets, BenchmarkModel::Values, chart );
+            diagram = new LineDiagram();
+            break;
+        case Bar:
+            model = new BenchmarkModel( points / DataSets, DataSets, BenchmarkModel::Values, chart );
+            diagram = new BarDiagram();
+            break;
+        case Plot:
+            model = new BenchmarkModel( points / DataSets, DataSets * 2, BenchmarkModel::XYPairs, chart );
+            diagram = new Plotter();
+            break;
+        case Stock: {
+            model = new BenchmarkModel( points / DataSets, DataSets * 4, BenchmarkModel::OHLC, chart );
+            StockDiagram* stock = new StockDiagram();
+            stock->setType( StockDiagram::OpenHighLowClose );
+            diagram = stock;
+            break;
+        }
+        case Pie:
+            // a pie shows the values of one row, one slice per column
+            model = new BenchmarkModel( 1, points, BenchmarkModel::Values, chart );
+            chart->replaceCoordinatePlane( new PolarCoordinatePlane( chart ) );
+            diagram = new PieDiagram();
+            break;
+        case Polar:
+            model = new BenchmarkModel( points / DataSets, DataSets, BenchmarkModel::Values, chart );
+            chart->replaceCoordinatePlane( new PolarCoordinatePlane( chart ) );
+            diagram = new PolarDiagram();
+            break;
+        }
+        diagram->setModel( model );
+        chart->coordinatePlane()->replaceDiagram( diagram );
+        return chart;
+    }
+
+    void benchmarkPaint( DiagramType type )
+    {
+        QFETCH( int, points );
+        QScopedPointer<Chart> chart( createChart( type, points ) );
+        QImage image( ImageSize, QImage::Format_ARGB32_Premultiplied );
+        QPainter painter( &image );
+        // the first paint lays out the chart and fills the caches
+        chart->paint( &painter, image.rect() );
+        QBENCHMARK {
+            chart->paint( &painter, image.rect() );
+        }
+    }
+
+    static const int DataSets = 4;
+    static const QSize ImageSize;
+
+private slots:
+    void benchmarkCompressorIngestion_data()
+    {
+        QTest::addColumn<int>( "points" );
+        addSizeRows();
+    }
+
+    void benchmarkCompressorIngestion()
+    {
+        QFETCH( int, points );
+        BenchmarkModel model( points / DataSets, DataSets, BenchmarkModel::Values );
+        QBENCHMARK {
+            CartesianDiagramDataCompressor compressor;
+            compressor.setApproximationMode( CartesianDiagramDataCompressor::Precise );
+            compressor.setModel( &model );
+            compressor.setResolution( ImageSize.width(), ImageSize.height() );
+            const int rows = compressor.modelDataRows();
+            const int columns = compressor.modelDataColumns();
+            for ( int row = 0; row < rows; ++row )
+                for ( int column = 0; column < columns; ++column )
+                    compressor.data( CartesianDiagramDataCompressor::CachePosition( row, column ) );
+            compressor.dataBoundaries();
+        }
+    }
+
+    void benchmarkPaintLine_data() { benchmarkCompressorIngestion_data(); }
+    void benchmarkPaintLine() { benchmarkPaint( Line ); }
+
+    void benchmarkPaintBar_data() { benchmarkCompressorIngestion_data(); }
+    void benchmarkPaintBar() { benchmarkPaint( Bar ); }
+
+    void benchmarkPaintPlotter_data() { benchmarkCompressorIngestion_data(); }
+    void benchmarkPaintPlotter() { benchmarkPaint( Plot ); }
+
+    void benchmarkPaintStock_data() { benchmarkCompressorIngestion_data(); }
+    void benchmarkPaintStock() { benchmarkPaint( Stock ); }
+
+    void benchmarkPaintPie_data()
+    {
+        // one slice per point; beyond a few thousand slices a pie is just noise
+        // and the benchmark would only measure the slice label collision checks
+        QTest::addColumn<int>( "points" );
+        QTest::newRow( "100" ) << 100;
+        QTest::newRow( "1k" ) << 1000;
+        QTest::newRow( "10k" ) << 10000;
+    }
+    void benchmarkPaintPie() { benchmarkPaint( Pie ); }
+
+    void benchmarkPaintPolar_data() { benchmarkCompressorIngestion_data(); }
+    void benchmarkPaintPolar() { benchmarkPaint( Polar ); }
+
+    void benchmarkAttributeLookup()
+    {
+        QScopedPointer<Chart> chart( createChart( Line, 1000 ) );
+        AbstractDiagram* diagram = chart->coordinatePlane()->diagram();
+        // mix global, per dataset and per index attributes like real charts do
+        DataValueAttributes dva = diagram->dataValueAttributes();
+        dva.setDecimalDigits( 2 );
+        diagram->setDataValueAttributes( dva );
+        diagram->setDataValueAttributes( 1, dva );
+        diagram->setDataValueAttributes( diagram->model()->index( 10, 2 ), dva );
+        const QAbstractItemModel* model = diagram->model();
+        const int rows = model->rowCount();
+        const int columns = model->columnCount();
+        QBENCHMARK {
+            for ( int row = 0; row < rows; ++row ) {
+                for ( int column = 0; column < columns; ++column ) {
+                    const QModelIndex index = model->index( row, column );
+                    diagram->dataValueAttributes( index );
+                    diagram->pen( index );
+                    diagram->brush( index );
+                }
+            }
+        }
+    }
+
+    void benchmarkLabelLayout()
+    {
+        QScopedPointer<Chart> chart( new Chart( nullptr ) );
+        chart->resize( ImageSize );
+        TextLayoutItem item( QString(), TextAttributes(), chart.data(),
+                             KChartEnums::MeasureOrientationMinimum, Qt::AlignCenter );
+        int i = 0;
+        QBENCHMARK {
+            // a new text invalidates the cached size of the item
+            item.setText( QString::number( 1000.0 + ( i++ % 1000 ) * 0.37, 'f', 2 ) );
+            item.sizeHint();
+        }
+    }
+
+    void benchmarkLabelPaint()
+    {
+        QScopedPointer<Chart> chart( createChart( Line, 1000 ) );
+        AbstractDiagram* diagram = chart->coordinatePlane()->diagram();
+        DataValueAttributes dva = diagram->dataValueAttributes();
+        dva.setVisible( true );
+        diagram->setDataValueAttributes( dva );
+        QImage image( ImageSize, QImage::Format_ARGB32_Premultiplied );
+        QPainter painter( &image );
+        chart->paint( &painter, image.rect() );
+        QBENCHMARK {
+            chart->paint( &painter, image.rect() );
+        }
+    }
+
+    void benchmarkAxisLayout()
+    {
+        QScopedPointer<Chart> chart( createChart( Line, 100000 ) );
+        AbstractCartesianDiagram* diagram =
+            qobject_cast<AbstractCartesianDiagram*>( chart->coordinatePlane()->diagram() );
+        QVERIFY( diagram );
+        CartesianAxis* xAxis = new CartesianAxis( diagram );
+        xAxis->setPosition( CartesianAxis::Bottom );
+        diagram->addAxis( xAxis );
+        CartesianAxis* yAxis = new CartesianAxis( diagram );
+        yAxis->setPosition( CartesianAxis::Left );
+        diagram->addAxis( yAxis );
+        QImage image( ImageSize, QImage::Format_ARGB32_Premultiplied );
+        QPainter painter( &image );
+        chart->paint( &painter, image.rect() );
+        QBENCHMARK {
+            xAxis->setCachedSizeDirty();
+            yAxis->setCachedSizeDirty();
+            xAxis->sizeHint();
+            yAxis->sizeHint();
+        }
+    }
+
+    void benchmarkReverseMapper_data()
+    {
+        QTest::addColumn<int>( "points" );
+        QTest::newRow( "1k" ) << 1000;
+        QTest::newRow( "100k" ) << 100000;
+    }
+
+    void benchmarkReverseMapper()
+    {
+        QFETCH( int, points );
+        QScopedPointer<Chart> chart( createChart( Bar, points ) );
+        AbstractDiagram* diagram = chart->coordinatePlane()->diagram();
+        QImage image( ImageSize, QImage::Format_ARGB32_Premultiplied );
+        QPainter painter( &image );
+        // painting fills the reverse mapper
+        chart->paint( &painter, image.rect() );
+        const QRect area( QPoint( 0, 0 ), ImageSize );
+        QBENCHMARK {
+            for ( int x = area.left(); x < area.right(); x += 16 )
+                diagram->indexesAt( QPoint( x, area.center().y() ) );
+            diagram->indexesIn( QRect( area.center(), QSize( 64, 64 ) ) );
+        }
+    }
+};
+
+const QSize BenchKChart::ImageSize( 800, 600 );
+
+QTEST_MAIN(BenchKChart)
+
+#include "main.moc"
@@ -23,7 +23,9 @@
 #include <QStandardItem>
 #include <QStandardItemModel>
 
+#include <KChartAttributesModel.h>
 #include <KChartCartesianDiagramDataCompressor_p.h>
+#include <KChartSharedModelDataCache_p.h>
 
 typedef KChart::CartesianDiagramDataCompressor::CachePosition CachePosition;
 
@@ -37,6 +39,27 @@ struct Match {
     QModelIndex index;
 };
 
+// derives the values of its second column from the first, as cached
+class DerivedColumnModel : public QStandardItemModel
+{
+public:
+    DerivedColumnModel( int rows, int columns )
+        : QStandardItemModel( rows, columns )
+    {
+    }
+
+    QVariant data( const QModelIndex& index, int role ) const override
+    {
+        if ( role == Qt::DisplayRole && index.column() == 1 ) {
+            const QSharedPointer< KChart::SharedModelDataCache > cache = KChart::SharedModelDataCache::find( this );
+            if ( cache ) {
+                return 2 * cache->value( QModelIndex(), index.row(), 0 );
+            }
+        }
+        return QStandardItemModel::data( index, role );
+    }
+};
+
 class CartesianDiagramDataCompressorTests : public QObject
 {
     Q_OBJECT
@@ -190,11 +213,169 @@ private slots:
                   "datasetDimension == 1 should restore the old column count" );
     }
 
+    void extentsTest()
+    {
+        typedef QPair< QPointF, QPointF > Boundaries;
+        const Boundaries initial = compressor.dataBoundaries();
+        QCOMPARE( initial.first.y(), 1.0 );
+        QCOMPARE( initial.second.y(), 1.0 );
+
+        // changing single values only updates the trees...
+        model.setData( model.index( 42, 3 ), 11.0 );
+        QVERIFY( !compressor.m_extentsDirty );
+        const Boundaries raised = compressor.dataBoundaries();
+        QVERIFY( raised.second.y() > 1.0 );
+        model.setData( model.index( 42, 3 ), -4.0 );
+        const Boundaries lowered = compressor.dataBoundaries();
+        QVERIFY( lowered.first.y() < 1.0 );
+        QCOMPARE( lowered.second.y(), 1.0 );
+        QVERIFY( !compressor.m_extentsDirty );
+
+        // ...and so does appending rows
+        QList< QStandardItem* > items;
+        for ( int column = 0; column < ColumnCount; ++column ) {
+            QStandardItem* item = new QStandardItem();
+            item->setData( 100, Qt::DisplayRole );
+            items.append( item );
+        }
+        model.appendRow( items );
+        QVERIFY( !compressor.m_extentsDirty );
+        const Boundaries appended = compressor.dataBoundaries();
+        QVERIFY( appended.second.y() > 1.0 );
+
+        // the incrementally updated extents need to match a full scan
+        compressor.m_extentsDirty = true;
+        QCOMPARE( compressor.dataBoundaries(), appended );
+
+        // inserting rows in the middle requires a full scan
+        model.insertRow( 10 );
+        QVERIFY( compressor.m_extentsDirty );
+    }
+
+    void stackedSumsTest()
+    {
+        using namespace KChart;
+        QStandardItemModel values( 5, 3 );
+        int next = 1;
+        for ( int row = 0; row < values.rowCount(); ++row ) {
+            for ( int column = 0; column < values.columnCount(); ++column ) {
+                values.setData( values.index( row, column ), next++ );
+            }
+        }
+        CartesianDiagramDataCompressor sums;
+        sums.setModel( &values );
+        sums.setResolution( 100, 100 );
+        compareStackedSums( sums, values );
+
+        // a rolling window keeps the number of rows, but every row is another one
+        values.removeRow( 0 );
+        QList< QStandardItem* > items;
+        for ( int column = 0; column < values.columnCount(); ++column ) {
+            QStandardItem* item = new QStandardItem();
+            item->setData( next++, Qt::DisplayRole );
+            items.append( item );
+        }
+        values.appendRow( items );
+        compareStackedSums( sums, values );
+
+        // so does replacing a dataset
+        values.removeColumn( 1 );
+        values.insertColumn( 1 );
+        for ( int row = 0; row < values.rowCount(); ++row ) {
+            values.setData( values.index( row, 1 ), -10 * row );
+        }
+        compareStackedSums( sums, values );
+    }
+
+    void sharedCacheTest()
+    {
+        using namespace KChart;
+        QStandardItemModel values( 20, 2 );
+        for ( int row = 0; row < 20; ++row ) {
+            values.setData( values.index( row, 0 ), row );
+            values.setData( values.index( row, 1 ), -row );
+        }
+        AttributesModel* lineAttributes = new AttributesModel( &values, nullptr );
+        AttributesModel* barAttributes = new AttributesModel( &values, nullptr );
+        CartesianDiagramDataCompressor lines;
+        CartesianDiagramDataCompressor bars;
+        lines.setModel( lineAttributes );
+        lines.setResolution( 100, 100 );
+        bars.setModel( barAttributes );
+        bars.setResolution( 100, 100 );
+
+        // both diagrams read the values of one cache, and keep no copy of their own
+        QVERIFY( lines.m_sharedCache );
+        QCOMPARE( lines.m_sharedCache, bars.m_sharedCache );
+        QCOMPARE( lines.m_sharedCache, SharedModelDataCache::find( &values ) );
+        QVERIFY( !lines.m_modelCache.model() );
+        QCOMPARE( lines.data( CachePosition( 7, 0 ) ).value, 7.0 );
+        QCOMPARE( bars.data( CachePosition( 7, 1 ) ).value, -7.0 );
+
+        // changes reach both diagrams
+        values.setData( values.index( 7, 0 ), 70 );
+        QCOMPARE( lines.data( CachePosition( 7, 0 ) ).value, 70.0 );
+        QCOMPARE( bars.data( CachePosition( 7, 0 ) ).value, 70.0 );
+        values.insertRow( 3 );
+        values.setData( values.index( 3, 0 ), 33 );
+        QCOMPARE( lines.data( CachePosition( 3, 0 ) ).value, 33.0 );
+        QCOMPARE( bars.data( CachePosition( 8, 0 ) ).value, 70.0 );
+
+        // the cache goes away with the last diagram using it
+        lines.setModel( nullptr );
+        bars.setModel( nullptr );
+        delete lineAttributes;
+        delete barAttributes;
+        QVERIFY( !SharedModelDataCache::find( &values ) );
+    }
+
+    void sharedCacheReentrancyTest()
+    {
+        using namespace KChart;
+        DerivedColumnModel values( 10, 2 );
+        for ( int row = 0; row < 10; ++row ) {
+            values.setData( values.index( row, 0 ), row );
+        }
+        const QSharedPointer< SharedModelDataCache > cache = SharedModelDataCache::attach( &values );
+        cache->addTable( QModelIndex() );
+
+        // the model is read without the cache locked, so it may use the cache itself
+        QCOMPARE( cache->value( QModelIndex(), 5, 1 ), 10.0 );
+        QCOMPARE( cache->value( QModelIndex(), 5, 0 ), 5.0 );
+        values.setData( values.index( 6, 0 ), 60 );
+        QCOMPARE( cache->value( QModelIndex(), 6, 1 ), 120.0 );
+        QCOMPARE( cache->value( QModelIndex(), 6, 0 ), 60.0 );
+    }
+
     void cleanupTestCase()
     {
     }
 
 private:
+    // the sums of the compressor need to match those calculated from the model
+    void compareStackedSums( const KChart::CartesianDiagramDataCompressor& sums,
+                             const QStandardItemModel& values )
+    {
+        QCOMPARE( sums.modelDataRows(), values.rowCount() );
+        for ( int row = 0; row < values.rowCount(); ++row ) {
+            qreal positive = 0.0;
+            qreal negative = 0.0;
+            for ( int column = 0; column < values.columnCount(); ++column ) {
+                const qreal value = values.data( values.index( row, column ) ).toReal();
+                if ( value >= 0.0 ) {
+                    positive += value;
+                } else {
+                    negative += value;
+                }
+                const KChart::CartesianDiagramDataCompressor::StackedSums& stacked
+                    = sums.stackedSums( CachePosition( row, column ) );
+                QCOMPARE( stacked.positive, positive );
+                QCOMPARE( stacked.negative, negative );
+            }
+            QCOMPARE( sums.rowSums( row ).total(), positive + negative );
+        }
+    }
+
     KChart::CartesianDiagramDataCompressor compressor;
     QStandardItemModel model;
     static const int RowCount;
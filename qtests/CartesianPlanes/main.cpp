@@ -18,6 +18,7 @@
  */
 
 #include <QtTest/QtTest>
+#include <QPainter>
 #include <QStandardItemModel>
 #include <QPointF>
 #include <QPair>
@@ -25,12 +26,60 @@
 #include <KChartChart>
 #include <KChartCartesianCoordinatePlane>
 #include <KChartBarDiagram>
+#include <KChartCartesianAxis>
 #include <KChartPlotter>
 #include <KChartGridAttributes>
+#include <KChartPerfObserver>
 
 
 using namespace KChart;
 
+// a plane with its own idea of how to translate points
+class ShiftedPlane : public CartesianCoordinatePlane
+{
+public:
+    ShiftedPlane()
+    {
+        setHasCustomTranslate( true );
+    }
+
+    const QPointF translate( const QPointF& diagramPoint ) const override
+    {
+        return CartesianCoordinatePlane::translate( diagramPoint ) + QPointF( 3.0, -4.0 );
+    }
+    using CartesianCoordinatePlane::translate;
+};
+
+// remembers which diagrams were painted in which thread, and their lookup counters
+class PaintRecorder : public PerfObserver
+{
+public:
+    ~PaintRecorder()
+    {
+        setObserver( nullptr );
+    }
+
+    void phaseFinished( Phase phase, const QObject* source, qint64, qint64 ) override
+    {
+        if ( phase == DiagramPaintPhase ) {
+            QMutexLocker locker( &mutex );
+            paintThreads.insert( source, QThread::currentThread() );
+        }
+    }
+
+    void counterReported( Counter counter, const QObject* source, qint64, qint64 ) override
+    {
+        if ( counter == DataLookupsCounter ) {
+            QMutexLocker locker( &mutex );
+            lookupReports.insert( source );
+        }
+    }
+
+    QMutex mutex;
+    QMultiHash< const QObject*, QThread* > paintThreads;
+    QSet< const QObject* > lookupReports;
+};
+
 class NumericDataModel : public QStandardItemModel
 {
     Q_OBJECT
@@ -88,6 +137,10 @@ private slots:
     void testGlobalGridAttributesSettings();
     void testGridAttributesSettings();
     void testAxesCalcModesSettings();
+    void testBatchTranslate();
+    void testBatchTranslateInSubclass();
+    void testParallelPainting();
+    void testIncrementalLayout();
 
 private:
     void doTestRangeSettings( AbstractCartesianDiagram *diagram, const QPointF &min, const QPointF &max );
@@ -290,6 +343,156 @@ void TestCartesianPlanes::testAxesCalcModesSettings()
 }
 
 
+void TestCartesianPlanes::testBatchTranslate()
+{
+    QList< QPointF > data;
+    data << QPointF( 1.0, 2.0 ) << QPointF( 10.0, 50.0 ) << QPointF( 100.0, 0.5 ) << QPointF( 1000.0, 7.0 );
+    m_model->setXyValues( data );
+    m_plane->addDiagram( m_plotter );
+
+    QVector< qreal > keys;
+    QVector< qreal > values;
+    for ( const QPointF& point : qAsConst( data ) ) {
+        keys << point.x();
+        values << point.y();
+    }
+
+    const QList< CartesianCoordinatePlane::AxesCalcMode > modes = QList< CartesianCoordinatePlane::AxesCalcMode >()
+        << CartesianCoordinatePlane::Linear << CartesianCoordinatePlane::Logarithmic;
+    for ( CartesianCoordinatePlane::AxesCalcMode mode : modes ) {
+        m_plane->setAxesCalcModes( mode );
+        // lay out the planes to set up the transformation
+        QImage image( 400, 300, QImage::Format_ARGB32 );
+        QPainter painter( &image );
+        m_chart->paint( &painter, image.rect() );
+
+        const QPolygonF points = m_plane->translate( keys, values );
+        QCOMPARE( points.count(), data.count() );
+        for ( int i = 0; i < data.count(); ++i ) {
+            QCOMPARE( points.at( i ), m_plane->translate( data.at( i ) ) );
+        }
+    }
+}
+
+void TestCartesianPlanes::testParallelPainting()
+{
+    QCOMPARE( m_chart->isParallelPaintingEnabled(), false );
+
+    QList< qreal > barValues;
+    barValues << 3.0 << 7.0 << -2.0 << 5.0 << 4.0;
+    m_model->setYValues( barValues );
+    m_chart->coordinatePlane()->replaceDiagram( m_bars );
+
+    NumericDataModel plotterModel;
+    QList< QPointF > plotterValues;
+    plotterValues << QPointF( 0.0, 1.0 ) << QPointF( 1.0, 6.0 ) << QPointF( 2.5, -1.0 ) << QPointF( 4.0, 2.0 );
+    plotterModel.setXyValues( plotterValues );
+    m_plotter->setModel( &plotterModel );
+    m_plane->addDiagram( m_plotter );
+
+    QImage serial( 400, 300, QImage::Format_ARGB32_Premultiplied );
+    serial.fill( Qt::white );
+    {
+        QPainter painter( &serial );
+        m_chart->paint( &painter, serial.rect() );
+    }
+    const QModelIndex barIndex = m_model->index( 1, 0 );
+    const QRect serialBarRect = m_bars->visualRect( barIndex );
+    QVERIFY( serialBarRect.isValid() );
+
+    m_chart->setParallelPaintingEnabled( true );
+    QImage parallel( serial.size(), serial.format() );
+    parallel.fill( Qt::white );
+    PaintRecorder recorder;
+    PerfObserver::setObserver( &recorder );
+    {
+        QPainter painter( &parallel );
+        m_chart->paint( &painter, parallel.rect() );
+    }
+    PerfObserver::setObserver( nullptr );
+
+    // each diagram was painted once, into its layer, and not again when compositing
+    QCOMPARE( recorder.paintThreads.count( m_bars ), 1 );
+    QCOMPARE( recorder.paintThreads.count( m_plotter ), 1 );
+    QVERIFY( recorder.paintThreads.value( m_bars ) != recorder.paintThreads.value( m_plotter ) );
+    // ...and the layer jobs report their data lookups, too
+    QVERIFY( recorder.lookupReports.contains( m_bars ) );
+    QVERIFY( recorder.lookupReports.contains( m_plotter ) );
+
+    // compositing the layers may round antialiased pixels differently
+    for ( int y = 0; y < serial.height(); ++y ) {
+        for ( int x = 0; x < serial.width(); ++x ) {
+            const QRgb a = serial.pixel( x, y );
+            const QRgb b = parallel.pixel( x, y );
+            QVERIFY( qAbs( qRed( a ) - qRed( b ) ) <= 2 );
+            QVERIFY( qAbs( qGreen( a ) - qGreen( b ) ) <= 2 );
+            QVERIFY( qAbs( qBlue( a ) - qBlue( b ) ) <= 2 );
+        }
+    }
+    // the reverse mapping recorded while painting in layers is applied as well
+    QCOMPARE( m_bars->visualRect( barIndex ), serialBarRect );
+
+    m_plane->takeDiagram( m_plotter );
+    m_plotter->setModel( m_model );
+}
+
+void TestCartesianPlanes::testIncrementalLayout()
+{
+    m_model->setYValues( QList< qreal >() << 1.0 << 5.0 << 3.0 );
+    m_plane->addDiagram( m_bars );
+    CartesianAxis *axis = new CartesianAxis( m_bars );
+    axis->setPosition( CartesianAxis::Bottom );
+    m_bars->addAxis( axis );
+
+    m_chart->resize( 400, 300 );
+    QImage image( m_chart->size(), QImage::Format_ARGB32 );
+    {
+        QPainter painter( &image );
+        m_chart->paint( &painter, m_chart->geometry() );
+    }
+    QLayout *const axisLayout = axis->parentLayout();
+    QVERIFY( axisLayout );
+    const QRect planeGeometry = m_plane->geometry();
+    const QRect axisGeometry = axis->geometry();
+
+    // a title makes the axis higher at the expense of the plane, right away
+    axis->setTitleText( QStringLiteral( "A title" ) );
+    QVERIFY( axis->geometry().height() > axisGeometry.height() );
+    QVERIFY( m_plane->geometry().height() < planeGeometry.height() );
+    QCOMPARE( m_plane->geometry().width(), planeGeometry.width() );
+    // ...without rebuilding the layouts
+    QCOMPARE( axis->parentLayout(), axisLayout );
+
+    // neither does a new size
+    QImage larger( 500, 400, QImage::Format_ARGB32 );
+    {
+        QPainter painter( &larger );
+        m_chart->paint( &painter, larger.rect() );
+    }
+    QVERIFY( m_plane->geometry().width() > planeGeometry.width() );
+    QCOMPARE( axis->parentLayout(), axisLayout );
+
+    m_plane->takeDiagram( m_bars );
+    QVERIFY( !axis->parentLayout() );
+    m_bars->setParent( m_chart );
+}
+
+void TestCartesianPlanes::testBatchTranslateInSubclass()
+{
+    ShiftedPlane plane;
+    QVector< qreal > keys;
+    QVector< qreal > values;
+    keys << 1.0 << 10.0 << 100.0;
+    values << 2.0 << 50.0 << 0.5;
+
+    // the batch translation must not bypass the reimplemented translate()
+    const QPolygonF points = plane.translate( keys, values );
+    QCOMPARE( points.count(), keys.count() );
+    for ( int i = 0; i < keys.count(); ++i ) {
+        QCOMPARE( points.at( i ), plane.translate( QPointF( keys.at( i ), values.at( i ) ) ) );
+    }
+}
+
 QTEST_MAIN(TestCartesianPlanes)
 
 #include "main.moc"
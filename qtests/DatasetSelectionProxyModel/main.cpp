@@ -0,0 +1,149 @@
+/**
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QStandardItemModel>
+
+#include <KChartChart>
+#include <KChartDatasetSelectionProxyModel>
+#include <KChartLineDiagram>
+
+using namespace KChart;
+
+class TestDatasetSelectionProxyModel: public QObject {
+    Q_OBJECT
+private:
+    qreal value( int row, int column ) const
+    {
+        return m_selection->data( m_selection->index( row, column ) ).toReal();
+    }
+
+private slots:
+
+    void init()
+    {
+        // the value of a cell is ten times its row plus its column
+        m_source = new QStandardItemModel( 5, 4 );
+        for ( int row = 0; row < 5; ++row ) {
+            for ( int column = 0; column < 4; ++column ) {
+                m_source->setData( m_source->index( row, column ), row * 10 + column );
+            }
+        }
+        m_selection = new DatasetSelectionProxyModel;
+        m_selection->setSourceModel( m_source );
+    }
+
+    void cleanup()
+    {
+        delete m_selection;
+        delete m_source;
+    }
+
+    void testPassThrough()
+    {
+        QCOMPARE( m_selection->rowCount(), 5 );
+        QCOMPARE( m_selection->columnCount(), 4 );
+        QCOMPARE( value( 3, 2 ), 32.0 );
+        QCOMPARE( m_selection->data( 3, 2 ).toReal(), 32.0 );
+
+        QSignalSpy inserted( m_selection, SIGNAL(rowsInserted(QModelIndex,int,int)) );
+        m_source->insertRows( 5, 3 );
+        QCOMPARE( inserted.count(), 1 );
+        QCOMPARE( inserted.at( 0 ).at( 1 ).toInt(), 5 );
+        QCOMPARE( inserted.at( 0 ).at( 2 ).toInt(), 7 );
+        QCOMPARE( m_selection->rowCount(), 8 );
+    }
+
+    void testSelection()
+    {
+        m_selection->setDatasetDescriptionVectors( DatasetDescriptionVector() << 4 << 1,
+                                                   DatasetDescriptionVector() << 3 << -1 << 0 );
+        QCOMPARE( m_selection->rowCount(), 2 );
+        QCOMPARE( m_selection->columnCount(), 3 );
+        QCOMPARE( value( 0, 0 ), 43.0 );
+        QCOMPARE( value( 1, 2 ), 10.0 );
+        QVERIFY( !m_selection->data( 1, 1 ).isValid() );
+        QCOMPARE( m_selection->mapRowFromSource( 4 ), 0 );
+        QCOMPARE( m_selection->mapRowFromSource( 2 ), -1 );
+        QCOMPARE( m_selection->mapColumnToSource( 2 ), 0 );
+        QVERIFY( !m_selection->mapFromSource( m_source->index( 2, 0 ) ).isValid() );
+        QCOMPARE( m_selection->mapFromSource( m_source->index( 1, 3 ) ), m_selection->index( 1, 0 ) );
+
+        // rows inserted in front of the selection move it along, but are not selected
+        QSignalSpy reset( m_selection, SIGNAL(modelReset()) );
+        QSignalSpy inserted( m_selection, SIGNAL(rowsInserted(QModelIndex,int,int)) );
+        m_source->insertRows( 0, 2 );
+        QCOMPARE( inserted.count(), 0 );
+        QCOMPARE( reset.count(), 0 );
+        QCOMPARE( m_selection->rowCount(), 2 );
+        QCOMPARE( value( 0, 0 ), 43.0 );
+        QCOMPARE( m_selection->mapRowToSource( 0 ), 6 );
+
+        // removing a selected row drops it from the selection
+        m_source->removeRows( 3, 1 );
+        QCOMPARE( reset.count(), 1 );
+        QCOMPARE( m_selection->rowCount(), 1 );
+        QCOMPARE( value( 0, 0 ), 43.0 );
+    }
+
+    void testDataChangedRange()
+    {
+        m_selection->setDatasetColumnDescriptionVector( DatasetDescriptionVector() << 3 << 1 << 2 );
+        QSignalSpy changed( m_selection, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)) );
+
+        // one signal covering the selected part of the block
+        emit m_source->dataChanged( m_source->index( 1, 0 ), m_source->index( 3, 1 ) );
+        QCOMPARE( changed.count(), 1 );
+        QCOMPARE( changed.at( 0 ).at( 0 ).value< QModelIndex >(), m_selection->index( 1, 1 ) );
+        QCOMPARE( changed.at( 0 ).at( 1 ).value< QModelIndex >(), m_selection->index( 3, 1 ) );
+
+        // nothing for columns that are not selected
+        m_source->setData( m_source->index( 2, 0 ), 99 );
+        QCOMPARE( changed.count(), 1 );
+
+        m_source->setData( m_source->index( 2, 3 ), 99 );
+        QCOMPARE( changed.count(), 2 );
+        QCOMPARE( value( 2, 0 ), 99.0 );
+    }
+
+    void testDiagram()
+    {
+        m_selection->setDatasetColumnDescriptionVector( DatasetDescriptionVector() << 2 );
+        Chart chart;
+        LineDiagram* diagram = new LineDiagram;
+        diagram->setModel( m_selection );
+        chart.coordinatePlane()->replaceDiagram( diagram );
+        QCOMPARE( diagram->numberOfAbscissaSegments(), 5 );
+        QCOMPARE( diagram->numberOfOrdinateSegments(), 1 );
+        const QPair< QPointF, QPointF > boundaries = diagram->dataBoundaries();
+        QCOMPARE( boundaries.first.y(), 2.0 );
+        QCOMPARE( boundaries.second.y(), 42.0 );
+
+        m_source->setData( m_source->index( 4, 2 ), 100 );
+        QCOMPARE( diagram->dataBoundaries().second.y(), 100.0 );
+    }
+
+private:
+    QStandardItemModel* m_source;
+    DatasetSelectionProxyModel* m_selection;
+};
+
+QTEST_MAIN(TestDatasetSelectionProxyModel)
+
+#include "main.moc"
@@ -132,6 +132,45 @@ private slots:
        QVERIFY( l->legendStyle() == Legend::LinesOnly );
     }
 
+    void testVirtualization()
+    {
+        QStandardItemModel model( 3, 50 );
+        Chart chart;
+        LineDiagram* lines = new LineDiagram();
+        lines->setModel( &model );
+        chart.coordinatePlane()->replaceDiagram( lines );
+        Legend* l = new Legend( lines, &chart );
+        chart.addLegend( l );
+        l->forceRebuild();
+        const int fullHeight = l->sizeHint().height();
+        QCOMPARE( l->maximumVisibleItemCount(), 0 );
+        QCOMPARE( l->pageCount(), 1 );
+
+        l->setMaximumVisibleItemCount( 10 );
+        QCOMPARE( l->pageCount(), 5 );
+        QVERIFY( l->sizeHint().height() < fullHeight );
+        l->setPage( 4 );
+        QCOMPARE( l->firstVisibleItem(), 40 );
+        QCOMPARE( l->page(), 4 );
+        l->setPage( 10 ); // past the end, clamped to the last page
+        QCOMPARE( l->firstVisibleItem(), 40 );
+        QCOMPARE( l->page(), 4 );
+        l->setPage( -1 );
+        QCOMPARE( l->firstVisibleItem(), 0 );
+        l->setPage( 4 );
+
+        // changes to single items, shown or not
+        l->setText( 49, QStringLiteral( "shown" ) );
+        l->setText( 3, QStringLiteral( "not shown" ) );
+        QCOMPARE( l->text( 49 ), QStringLiteral( "shown" ) );
+        QCOMPARE( l->text( 3 ), QStringLiteral( "not shown" ) );
+        l->setBrush( 49, QBrush( Qt::red ) );
+        QCOMPARE( l->brush( 49 ), QBrush( Qt::red ) );
+        l->setOrientation( Qt::Horizontal );
+        l->setBrush( 49, QBrush( Qt::blue ) );
+        l->setText( 49, QStringLiteral( "shown, horizontally" ) );
+        QCOMPARE( l->brush( 49 ), QBrush( Qt::blue ) );
+    }
 
     void cleanupTestCase()
     {
@@ -0,0 +1,156 @@
+/**
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <QStandardItemModel>
+
+#include <KChartLeveyJenningsDiagram>
+
+#include <cmath>
+
+using namespace KChart;
+
+class TestLeveyJennings: public QObject {
+    Q_OBJECT
+private slots:
+
+    void init()
+    {
+        m_model = new QStandardItemModel( 0, 4, this );
+        m_diagram = new LeveyJenningsDiagram;
+        m_diagram->setModel( m_model );
+    }
+
+    void cleanup()
+    {
+        delete m_diagram;
+        delete m_model;
+    }
+
+    void testStatistics_data()
+    {
+        QTest::addColumn<int>( "windowSize" );
+        QTest::newRow( "all rows" ) << 0;
+        QTest::newRow( "rolling window" ) << 5;
+    }
+
+    void testStatistics()
+    {
+        QFETCH( int, windowSize );
+        m_diagram->setStatisticsWindowSize( windowSize );
+
+        // large values compared to their spread, as is usual for QC results
+        for ( int i = 0; i < 12; ++i ) {
+            appendValue( 1000.0 + ( i * 7 ) % 5 );
+            if ( i > 0 ) {
+                compareStatistics();
+            }
+        }
+
+        // a value that is missing does not count
+        m_model->setData( m_model->index( 9, 1 ), QVariant() );
+        compareStatistics();
+        m_model->setData( m_model->index( 9, 1 ), 1003.5 );
+        compareStatistics();
+
+        // edits in and out of the window
+        m_model->setData( m_model->index( 1, 1 ), 990.0 );
+        compareStatistics();
+        m_model->setData( m_model->index( 10, 1 ), 1010.0 );
+        compareStatistics();
+
+        // a rolling set of results
+        m_model->removeRow( 0 );
+        appendValue( 998.25 );
+        compareStatistics();
+
+        // removing and inserting in the middle
+        m_model->removeRows( 4, 3 );
+        compareStatistics();
+        m_model->insertRow( 2 );
+        m_model->setData( m_model->index( 2, 1 ), 1001.0 );
+        compareStatistics();
+        m_model->removeRow( m_model->rowCount() - 1 );
+        compareStatistics();
+
+        // changing the window size
+        m_diagram->setStatisticsWindowSize( 3 );
+        compareStatistics();
+        m_diagram->setStatisticsWindowSize( 0 );
+        compareStatistics();
+        m_diagram->setStatisticsWindowSize( windowSize );
+        compareStatistics();
+        appendValue( 1002.0 );
+        compareStatistics();
+    }
+
+private:
+    void appendValue( qreal value )
+    {
+        const int row = m_model->rowCount();
+        QList< QStandardItem* > items;
+        for ( int column = 0; column < m_model->columnCount(); ++column ) {
+            items.append( new QStandardItem() );
+        }
+        items[ 1 ]->setData( value, Qt::DisplayRole );
+        items[ 2 ]->setData( true, Qt::DisplayRole );
+        items[ 3 ]->setData( QDateTime( QDate( 2020, 1, 1 ).addDays( row ) ), Qt::DisplayRole );
+        m_model->appendRow( items );
+    }
+
+    // the statistics of the diagram need to match those calculated from the model
+    void compareStatistics()
+    {
+        const int windowSize = m_diagram->statisticsWindowSize();
+        const int rowCount = m_model->rowCount();
+        const int firstRow = windowSize == 0 ? 0 : qMax( 0, rowCount - windowSize );
+
+        QVector< qreal > values;
+        qreal sum = 0.0;
+        for ( int row = firstRow; row < rowCount; ++row ) {
+            const QVariant value = m_model->data( m_model->index( row, 1 ) );
+            if ( value.isValid() ) {
+                values.append( value.toReal() );
+                sum += value.toReal();
+            }
+        }
+        QVERIFY( values.count() > 1 );
+        const qreal mean = sum / values.count();
+        qreal squares = 0.0;
+        for ( qreal value : qAsConst( values ) ) {
+            squares += ( value - mean ) * ( value - mean );
+        }
+        const qreal standardDeviation = std::sqrt( squares / ( values.count() - 1 ) );
+
+        // the diagram reports floats
+        QVERIFY2( qAbs( m_diagram->calculatedMeanValue() - mean ) < 1e-3,
+                  qPrintable( QString( "mean %1, expected %2" )
+                              .arg( m_diagram->calculatedMeanValue() ).arg( mean ) ) );
+        QVERIFY2( qAbs( m_diagram->calculatedStandardDeviation() - standardDeviation ) < 1e-4,
+                  qPrintable( QString( "standard deviation %1, expected %2" )
+                              .arg( m_diagram->calculatedStandardDeviation() ).arg( standardDeviation ) ) );
+    }
+
+    QStandardItemModel* m_model;
+    LeveyJenningsDiagram* m_diagram;
+};
+
+QTEST_MAIN(TestLeveyJennings)
+
+#include "main.moc"
@@ -18,6 +18,9 @@
  */
 
 #include <QtTest/QtTest>
+#include <QImage>
+#include <QPainter>
+#include <QStandardItemModel>
 #include <KChartChart>
 #include <KChartGlobal>
 #include <KChartLineDiagram>
@@ -170,6 +173,81 @@ private slots:
         QVERIFY( m_lines->threeDLineAttributes().lineYRotation() == 25 );
     }
 
+    void testPartialUpdateOnDataChange()
+    {
+        QStandardItemModel model( 10, 2 );
+        for ( int row = 0; row < model.rowCount(); ++row ) {
+            for ( int column = 0; column < model.columnCount(); ++column ) {
+                model.setData( model.index( row, column ), row % 5 + column );
+            }
+        }
+        Chart chart;
+        LineDiagram* lines = new LineDiagram();
+        lines->setModel( &model );
+        chart.coordinatePlane()->replaceDiagram( lines );
+        chart.resize( 400, 300 );
+        QImage image( chart.size(), QImage::Format_ARGB32 );
+        QPainter painter( &image );
+        chart.paint( &painter, image.rect() );
+        QCoreApplication::processEvents();
+
+        AbstractCoordinatePlane* plane = chart.coordinatePlane();
+        QSignalSpy partialSpy( plane, SIGNAL(needPartialUpdate(QRect)) );
+        QSignalSpy fullSpy( plane, SIGNAL(needUpdate()) );
+
+        // the data boundaries stay the same, only the area around row 4 needs a repaint
+        model.setData( model.index( 4, 0 ), 2 );
+        QTRY_COMPARE( partialSpy.count(), 1 );
+        QCOMPARE( fullSpy.count(), 0 );
+        const QRect damaged = partialSpy.first().first().toRect();
+        QVERIFY( damaged.isValid() );
+        QVERIFY( damaged.width() < plane->geometry().width() );
+
+        // the new maximum changes the axes, so everything needs a repaint
+        model.setData( model.index( 4, 0 ), 100 );
+        QTRY_VERIFY( fullSpy.count() > 0 );
+        QCOMPARE( partialSpy.count(), 1 );
+    }
+
+    void testPartialPaint()
+    {
+        QStandardItemModel model( 40, 2 );
+        for ( int row = 0; row < model.rowCount(); ++row ) {
+            for ( int column = 0; column < model.columnCount(); ++column ) {
+                model.setData( model.index( row, column ), row % 5 + column );
+            }
+        }
+        Chart chart;
+        LineDiagram* lines = new LineDiagram();
+        lines->setModel( &model );
+        // a wide pen reaches further into the neighbourhood of a changed value
+        lines->setPen( 0, QPen( Qt::darkBlue, 7 ) );
+        chart.coordinatePlane()->replaceDiagram( lines );
+        chart.resize( 400, 300 );
+        QImage partial( chart.size(), QImage::Format_ARGB32 );
+        partial.fill( Qt::white );
+        chart.render( &partial );
+        QCoreApplication::processEvents();
+        const QRect unchangedRect = lines->visualRect( model.index( 30, 0 ) );
+
+        QSignalSpy partialSpy( chart.coordinatePlane(), SIGNAL(needPartialUpdate(QRect)) );
+        model.setData( model.index( 10, 0 ), 1 );
+        QTRY_COMPARE( partialSpy.count(), 1 );
+        const QRect damaged = partialSpy.first().first().toRect();
+        chart.render( &partial, QPoint(), QRegion( damaged ) );
+        const QRect changedRect = lines->visualRect( model.index( 10, 0 ) );
+
+        // repainting the damaged part gives the same as repainting everything...
+        QImage full( chart.size(), QImage::Format_ARGB32 );
+        full.fill( Qt::white );
+        chart.render( &full );
+        QCOMPARE( partial, full );
+        // ...and keeps the reverse mapping of all rows up to date
+        QCOMPARE( lines->visualRect( model.index( 10, 0 ) ), changedRect );
+        QCOMPARE( lines->visualRect( model.index( 30, 0 ) ), unchangedRect );
+        QVERIFY( unchangedRect.isValid() );
+    }
+
     void cleanupTestCase()
     {
     }
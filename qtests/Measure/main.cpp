@@ -23,6 +23,7 @@
 #include <KChartBarDiagram>
 #include <KChartCartesianCoordinatePlane>
 #include <KChartMeasure>
+#include <KChartTextMeasurementCache>
 
 #include <TableModel.h>
 
@@ -139,6 +140,38 @@ private slots:
           qMax( m_chart->size().width(), m_chart->size().height() ) / 10.0 );
   }
 
+  void testTextMeasurementCache()
+  {
+      TextMeasurementCache* cache = TextMeasurementCache::instance();
+      cache->clear();
+      cache->resetStatistics();
+      const QString text = QStringLiteral( "Measure me\ntwice" );
+      const QFont font = m_chart->font();
+
+      const QSizeF size = cache->textSize( text, font );
+      QCOMPARE( cache->missCount(), quint64( 1 ) );
+      QCOMPARE( cache->hitCount(), quint64( 0 ) );
+      QVERIFY( size.height() > QFontMetricsF( font ).height() ); // two lines
+
+      QCOMPARE( cache->textSize( text, font ), size );
+      QCOMPARE( cache->hitCount(), quint64( 1 ) );
+
+      // rotation, layout and font are part of the key
+      const QSizeF rotated = cache->textSize( text, font, TextMeasurementCache::FontMetricsLayout, 90.0 );
+      QVERIFY( qAbs( rotated.width() - size.height() ) < 0.01 );
+      QVERIFY( qAbs( rotated.height() - size.width() ) < 0.01 );
+      cache->textSize( text, font, TextMeasurementCache::RichTextDocumentLayout );
+      QFont bigFont = font;
+      bigFont.setPointSizeF( font.pointSizeF() * 2 );
+      QVERIFY( cache->textSize( text, bigFont ).height() > size.height() );
+      QCOMPARE( cache->missCount(), quint64( 4 ) );
+      QCOMPARE( cache->hitCount(), quint64( 1 ) );
+
+      const int oldCapacity = cache->capacity();
+      cache->setCapacity( 2 );
+      QVERIFY( cache->count() <= 2 );
+      cache->setCapacity( oldCapacity );
+  }
 
   void cleanupTestCase()
   {
@@ -0,0 +1,131 @@
+/**
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QStandardItemModel>
+
+#include <KChartChart>
+#include <KChartGlobal>
+#include <KChartCartesianAxis>
+#include <KChartCartesianCoordinatePlane>
+#include <KChartLegend>
+#include <KChartLineDiagram>
+#include <KChartPerfObserver>
+
+using namespace KChart;
+
+class TestPerfObserver: public QObject {
+    Q_OBJECT
+private:
+    static QSet<QString> eventNames( const QByteArray& json )
+    {
+        QSet<QString> names;
+        const QJsonArray events = QJsonDocument::fromJson( json ).object().value( "traceEvents" ).toArray();
+        for ( const QJsonValue& event : events ) {
+            names.insert( event.toObject().value( "name" ).toString() );
+        }
+        return names;
+    }
+
+private slots:
+
+    void testNoObserverByDefault()
+    {
+        QVERIFY( PerfObserver::observer() == nullptr );
+    }
+
+    void testPaintIsRecorded()
+    {
+        ChromeTraceRecorder recorder;
+        PerfObserver::setObserver( &recorder );
+        QCOMPARE( PerfObserver::observer(), static_cast<PerfObserver*>( &recorder ) );
+
+        QStandardItemModel model( 20, 2 );
+        for ( int row = 0; row < model.rowCount(); ++row ) {
+            for ( int column = 0; column < model.columnCount(); ++column ) {
+                model.setData( model.index( row, column ), row * ( column + 1 ) );
+            }
+        }
+        Chart chart;
+        LineDiagram* diagram = new LineDiagram();
+        diagram->setModel( &model );
+        CartesianAxis* axis = new CartesianAxis( diagram );
+        axis->setPosition( CartesianAxis::Bottom );
+        chart.coordinatePlane()->replaceDiagram( diagram );
+        chart.addLegend( new Legend( diagram, &chart ) );
+
+        QImage image( 400, 300, QImage::Format_ARGB32_Premultiplied );
+        QPainter painter( &image );
+        chart.paint( &painter, image.rect() );
+        painter.end();
+
+        PerfObserver::setObserver( nullptr );
+        QVERIFY( recorder.eventCount() > 0 );
+
+        const QSet<QString> names = eventNames( recorder.toJson() );
+        QVERIFY( names.contains( "Layout" ) );
+        QVERIFY( names.contains( "DataBoundaries" ) );
+        QVERIFY( names.contains( "DiagramPaint" ) );
+        QVERIFY( names.contains( "AxisPaint" ) );
+        QVERIFY( names.contains( "LegendBuild" ) );
+        QVERIFY( names.contains( "DataLookups" ) );
+
+        // counters carry nothing but numbers, their source is the id
+        const QJsonArray events = QJsonDocument::fromJson( recorder.toJson() ).object().value( "traceEvents" ).toArray();
+        for ( const QJsonValue& value : events ) {
+            const QJsonObject event = value.toObject();
+            if ( event.value( "ph" ).toString() != "C" ) {
+                continue;
+            }
+            QVERIFY( event.value( "id" ).toString().startsWith( "KChart::LineDiagram" ) );
+            const QJsonObject args = event.value( "args" ).toObject();
+            for ( const QJsonValue& arg : args ) {
+                QVERIFY( arg.isDouble() );
+            }
+        }
+
+        // nothing is recorded without an observer
+        const int count = recorder.eventCount();
+        QImage image2( 400, 300, QImage::Format_ARGB32_Premultiplied );
+        QPainter painter2( &image2 );
+        chart.paint( &painter2, image2.rect() );
+        QCOMPARE( recorder.eventCount(), count );
+
+        recorder.clear();
+        QCOMPARE( recorder.eventCount(), 0 );
+    }
+
+    void testObserverRemovedOnDestruction()
+    {
+        {
+            ChromeTraceRecorder recorder;
+            PerfObserver::setObserver( &recorder );
+        }
+        QVERIFY( PerfObserver::observer() == nullptr );
+    }
+};
+
+QTEST_MAIN(TestPerfObserver)
+
+#include "main.moc"
@@ -24,11 +24,79 @@
 #include <KChartPieAttributes>
 #include <KChartThreeDPieAttributes>
 #include <KChartPolarCoordinatePlane>
+#include <KChartDataValueAttributes>
+
+#include <QPaintEngine>
+#include <QPainter>
+#include <QStandardItemModel>
 
 #include <TableModel.h>
 
+#include <climits>
+
 using namespace KChart;
 
+// Records the frames of pie labels, which are the only rectangular paths a pie chart paints
+class LabelFrameRecorder : public QPaintEngine {
+public:
+    LabelFrameRecorder() : QPaintEngine( QPaintEngine::AllFeatures ) {}
+
+    bool begin( QPaintDevice* ) override { return true; }
+    bool end() override { return true; }
+    void updateState( const QPaintEngineState& ) override {}
+    void drawPixmap( const QRectF&, const QPixmap&, const QRectF& ) override {}
+    void drawPolygon( const QPointF*, int, PolygonDrawMode ) override {}
+    void drawRects( const QRectF*, int ) override {}
+    void drawTextItem( const QPointF&, const QTextItem& ) override {}
+    void drawPath( const QPainterPath& path ) override
+    {
+        if ( path.elementCount() == 5 ) {
+            frames.append( path.boundingRect() );
+        }
+    }
+    Type type() const override { return QPaintEngine::User; }
+
+    QVector< QRectF > frames;
+};
+
+class LabelFrameDevice : public QPaintDevice {
+public:
+    explicit LabelFrameDevice( const QSize& size ) : m_size( size ) {}
+
+    QPaintEngine* paintEngine() const override { return &m_engine; }
+    QVector< QRectF > frames() const { return m_engine.frames; }
+
+protected:
+    int metric( PaintDeviceMetric metric ) const override
+    {
+        switch ( metric ) {
+        case PdmWidth:
+            return m_size.width();
+        case PdmHeight:
+            return m_size.height();
+        case PdmWidthMM:
+            return qRound( m_size.width() * 25.4 / 96 );
+        case PdmHeightMM:
+            return qRound( m_size.height() * 25.4 / 96 );
+        case PdmNumColors:
+            return INT_MAX;
+        case PdmDepth:
+            return 32;
+        case PdmDpiX:
+        case PdmDpiY:
+        case PdmPhysicalDpiX:
+        case PdmPhysicalDpiY:
+            return 96;
+        default:
+            return QPaintDevice::metric( metric );
+        }
+    }
+
+private:
+    QSize m_size;
+    mutable LabelFrameRecorder m_engine;
+};
+
 class TestPieDiagrams: public QObject {
     Q_OBJECT
 private slots:
@@ -142,6 +210,43 @@ private slots:
         QVERIFY( m_pie->threeDPieAttributes().useShadowColors() == false );
     }
 
+    void testLabelCollisionAvoidanceWithManySlices()
+    {
+        QStandardItemModel model( 1, 200 );
+        for ( int column = 0; column < model.columnCount(); ++column ) {
+            model.setData( model.index( 0, column ), 1.0 + column % 7 );
+        }
+
+        Chart chart;
+        PolarCoordinatePlane* plane = new PolarCoordinatePlane( &chart );
+        chart.replaceCoordinatePlane( plane );
+        PieDiagram* pie = new PieDiagram();
+        pie->setModel( &model );
+        DataValueAttributes dva( pie->dataValueAttributes() );
+        dva.setVisible( true );
+        pie->setDataValueAttributes( dva );
+        pie->setAllowOverlappingDataValueTexts( true );
+        pie->setLabelCollisionAvoidanceEnabled( true );
+        pie->setLabelDecorations( PieDiagram::FrameDecoration );
+        plane->replaceDiagram( pie );
+
+        const QRect area( 0, 0, 800, 600 );
+        LabelFrameDevice device( area.size() );
+        QPainter painter( &device );
+        chart.paint( &painter, area );
+        painter.end();
+
+        const QVector< QRectF > frames = device.frames();
+        QCOMPARE( frames.count(), model.columnCount() );
+        for ( int i = 0; i < frames.count(); ++i ) {
+            for ( int j = i + 1; j < frames.count(); ++j ) {
+                if ( frames[ i ].intersects( frames[ j ] ) ) {
+                    QFAIL( qPrintable( QString( "labels %1 and %2 overlap" ).arg( i ).arg( j ) ) );
+                }
+            }
+        }
+    }
+
     void cleanupTestCase()
     {
     }
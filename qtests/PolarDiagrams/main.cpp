@@ -18,6 +18,7 @@
  */
 
 #include <QtTest/QtTest>
+#include <QPainter>
 #include <KChartChart>
 #include <KChartGlobal>
 #include <KChartPolarDiagram>
@@ -75,12 +76,42 @@ private slots:
         QVERIFY( m_polar->showLabelsAtPosition( Position::South ) == true );
     }
 
+    void testRepaintAfterDataChange()
+    {
+        // the laid out data points are reused between paints, but not after the data changed
+        const QImage before = renderSettled();
+        QCOMPARE( render(), before );
+
+        const QModelIndex index = m_model->index( 0, 0 );
+        const QVariant oldValue = m_model->data( index );
+        QVERIFY( m_model->setData( index, oldValue.toReal() / 2.0 ) );
+        QVERIFY( renderSettled() != before );
+        QVERIFY( m_model->setData( index, oldValue ) );
+    }
 
     void cleanupTestCase()
     {
     }
 
 private:
+    QImage render()
+    {
+        QImage image( 400, 400, QImage::Format_ARGB32 );
+        image.fill( Qt::white );
+        QPainter painter( &image );
+        m_chart->paint( &painter, image.rect() );
+        return image;
+    }
+
+    // the first paint after a change may only adjust the zoom to fit the labels
+    QImage renderSettled()
+    {
+        QCoreApplication::processEvents();
+        render();
+        QCoreApplication::processEvents();
+        return render();
+    }
+
     Chart *m_chart;
     PolarDiagram *m_polar;
     TableModel *m_model;
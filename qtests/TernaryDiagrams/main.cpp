@@ -0,0 +1,176 @@
+/**
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <QImage>
+#include <QPainter>
+#include <QStandardItemModel>
+
+#include <KChartAttributesModel>
+#include <KChartChart>
+#include <KChartDataValueAttributes>
+#include <KChartMarkerAttributes>
+#include <KChartTernaryCoordinatePlane>
+#include <KChartTernaryLineDiagram>
+#include <KChartTernaryPointDiagram>
+
+using namespace KChart;
+
+class TestTernaryDiagrams: public QObject {
+    Q_OBJECT
+private:
+    void setRow( int row, qreal a, qreal b, qreal c )
+    {
+        m_model->setData( m_model->index( row, 0 ), a );
+        m_model->setData( m_model->index( row, 1 ), b );
+        m_model->setData( m_model->index( row, 2 ), c );
+    }
+
+    QImage render()
+    {
+        QImage image( 400, 400, QImage::Format_ARGB32_Premultiplied );
+        image.fill( Qt::white );
+        QPainter painter( &image );
+        m_chart->paint( &painter, image.rect() );
+        return image;
+    }
+
+    void replaceDiagram( AbstractTernaryDiagram* diagram )
+    {
+        diagram->setModel( m_model );
+        m_plane->replaceDiagram( diagram );
+    }
+
+private slots:
+    void init()
+    {
+        m_chart = new Chart( nullptr );
+        m_plane = new TernaryCoordinatePlane;
+        m_chart->replaceCoordinatePlane( m_plane );
+        m_model = new QStandardItemModel( 4, 3, m_chart );
+        setRow( 0, 0.2, 0.3, 0.5 );
+        setRow( 1, 0.6, 0.2, 0.2 );
+        setRow( 2, 0.0, 0.0, 0.0 ); // unusable, not painted
+        setRow( 3, 0.1, 0.8, 0.1 );
+    }
+
+    void cleanup()
+    {
+        delete m_chart;
+    }
+
+    void testMarkersFollowData()
+    {
+        TernaryLineDiagram* diagram = new TernaryLineDiagram;
+        replaceDiagram( diagram );
+
+        render();
+        const QRect before = diagram->visualRect( m_model->index( 1, 0 ) );
+        QVERIFY( before.isValid() );
+        QVERIFY( diagram->visualRect( m_model->index( 2, 0 ) ).isEmpty() );
+
+        // the laid out data points must not survive a change of the data
+        setRow( 1, 0.2, 0.6, 0.2 );
+        render();
+        const QRect after = diagram->visualRect( m_model->index( 1, 0 ) );
+        QVERIFY( after.isValid() );
+        QVERIFY( after != before );
+
+        // nor a change of the geometry
+        QImage small( 200, 200, QImage::Format_ARGB32_Premultiplied );
+        small.fill( Qt::white );
+        {
+            QPainter painter( &small );
+            m_chart->paint( &painter, small.rect() );
+        }
+        QVERIFY( diagram->visualRect( m_model->index( 1, 0 ) ) != after );
+    }
+
+    void testTinyMarkers()
+    {
+        TernaryPointDiagram* diagram = new TernaryPointDiagram;
+        replaceDiagram( diagram );
+        diagram->setAntiAliasing( false );
+        diagram->setBrush( QBrush( Qt::darkBlue ) );
+        DataValueAttributes attributes = diagram->dataValueAttributes();
+        MarkerAttributes markers = attributes.markerAttributes();
+        markers.setMarkerStyle( MarkerAttributes::Marker4Pixels );
+        markers.setVisible( true );
+        attributes.setMarkerAttributes( markers );
+        attributes.setVisible( true );
+        diagram->setDataValueAttributes( attributes );
+
+        const QImage image = render();
+        for ( int row = 0; row < m_model->rowCount(); ++row ) {
+            const QRect rect = diagram->visualRect( m_model->index( row, 0 ) );
+            if ( row == 2 ) {
+                QVERIFY( rect.isEmpty() );
+                continue;
+            }
+            QVERIFY( rect.isValid() );
+            QCOMPARE( image.pixel( rect.center() ), QColor( Qt::darkBlue ).lighter().rgb() );
+        }
+    }
+
+    void testMarkersFollowAttributes()
+    {
+        TernaryPointDiagram* diagram = new TernaryPointDiagram;
+        replaceDiagram( diagram );
+        diagram->setAntiAliasing( false );
+        DataValueAttributes attributes = diagram->dataValueAttributes();
+        MarkerAttributes markers = attributes.markerAttributes();
+        markers.setMarkerStyle( MarkerAttributes::Marker4Pixels );
+        markers.setVisible( true );
+        attributes.setMarkerAttributes( markers );
+        attributes.setVisible( true );
+        diagram->setDataValueAttributes( attributes );
+
+        const QModelIndex index = m_model->index( 0, 0 );
+        QImage image = render();
+        QRect rect = diagram->visualRect( index );
+        QVERIFY( rect.isValid() );
+        const QBrush defaultBrush = diagram->brush( index );
+        QCOMPARE( image.pixel( rect.center() ), defaultBrush.color().lighter().rgb() );
+
+        // the laid out data points must not keep the brushes of another palette
+        diagram->useRainbowColors();
+        const QBrush rainbowBrush = diagram->brush( index );
+        QVERIFY( rainbowBrush != defaultBrush );
+        image = render();
+        rect = diagram->visualRect( index );
+        QCOMPARE( image.pixel( rect.center() ), rainbowBrush.color().lighter().rgb() );
+
+        // nor those set in the attributes model directly
+        diagram->attributesModel()->setHeaderData( 0, Qt::Horizontal, QBrush( Qt::darkGreen ),
+                                                   DatasetBrushRole );
+        QCOMPARE( diagram->brush( index ), QBrush( Qt::darkGreen ) );
+        image = render();
+        rect = diagram->visualRect( index );
+        QCOMPARE( image.pixel( rect.center() ), QColor( Qt::darkGreen ).lighter().rgb() );
+    }
+
+private:
+    Chart* m_chart;
+    TernaryCoordinatePlane* m_plane;
+    QStandardItemModel* m_model;
+};
+
+QTEST_MAIN(TestTernaryDiagrams)
+
+#include "main.moc"
@@ -0,0 +1,140 @@
+/**
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <QStandardItemModel>
+
+#include <KChartTickResamplingModel>
+
+using namespace KChart;
+
+class TestTickResamplingModel: public QObject {
+    Q_OBJECT
+private:
+    void appendTick( qreal time, qreal price, qreal volume = 1.0 )
+    {
+        QList< QStandardItem* > items;
+        const qreal values[] = { time, price, volume };
+        for ( qreal value : values ) {
+            QStandardItem* item = new QStandardItem;
+            item->setData( value, Qt::DisplayRole );
+            items.append( item );
+        }
+        m_ticks->appendRow( items );
+    }
+
+    qreal value( int row, int column ) const
+    {
+        return m_resampler->data( m_resampler->index( row, column ) ).toReal();
+    }
+
+private slots:
+
+    void init()
+    {
+        m_ticks = new QStandardItemModel( 0, 3 );
+        // two ticks per second for ten seconds, the price going up and down
+        for ( int i = 0; i < 20; ++i ) {
+            appendTick( i * 0.5, 100 + ( i % 4 ) );
+        }
+        m_resampler = new TickResamplingModel;
+        m_resampler->setSourceModel( m_ticks );
+    }
+
+    void cleanup()
+    {
+        delete m_resampler;
+        delete m_ticks;
+    }
+
+    void testBuckets()
+    {
+        QCOMPARE( m_resampler->rowCount(), 10 );
+        QCOMPARE( m_resampler->columnCount(), 4 );
+        // the second bucket has the ticks at 1.0 (102) and 1.5 (103)
+        QCOMPARE( value( 1, 0 ), 102.0 );
+        QCOMPARE( value( 1, 1 ), 103.0 );
+        QCOMPARE( value( 1, 2 ), 102.0 );
+        QCOMPARE( value( 1, 3 ), 103.0 );
+        QCOMPARE( m_resampler->bucketStart( 1 ), 1.0 );
+        QCOMPARE( m_resampler->bucketVolume( 1 ), 2.0 );
+        QCOMPARE( m_resampler->bucketTickCount( 1 ), 2 );
+
+        m_resampler->setStockType( StockDiagram::HighLowClose );
+        QCOMPARE( m_resampler->columnCount(), 3 );
+        QCOMPARE( value( 1, 0 ), 103.0 );
+        QCOMPARE( value( 1, 2 ), 103.0 );
+    }
+
+    void testAppendTicks()
+    {
+        QSignalSpy changedSpy( m_resampler, SIGNAL(dataChanged(QModelIndex,QModelIndex)) );
+        QSignalSpy insertedSpy( m_resampler, SIGNAL(rowsInserted(QModelIndex,int,int)) );
+        QSignalSpy resetSpy( m_resampler, SIGNAL(modelReset()) );
+
+        // goes into the last bucket
+        appendTick( 9.7, 90 );
+        QCOMPARE( changedSpy.count(), 1 );
+        QCOMPARE( insertedSpy.count(), 0 );
+        QCOMPARE( value( 9, 2 ), 90.0 );
+        QCOMPARE( value( 9, 3 ), 90.0 );
+
+        // starts a new one
+        appendTick( 12.0, 110 );
+        QCOMPARE( insertedSpy.count(), 1 );
+        QCOMPARE( m_resampler->rowCount(), 11 );
+        QCOMPARE( m_resampler->bucketStart( 10 ), 12.0 );
+        QCOMPARE( resetSpy.count(), 0 );
+
+        // late ticks still end up in the right bucket
+        appendTick( 0.2, 50 );
+        QCOMPARE( resetSpy.count(), 1 );
+        QCOMPARE( value( 0, 2 ), 50.0 );
+        QCOMPARE( m_resampler->rowCount(), 11 );
+    }
+
+    void testMaximumBucketCount()
+    {
+        m_resampler->setMaximumBucketCount( 4 );
+        QCOMPARE( m_resampler->interval(), 4.0 );
+        QCOMPARE( m_resampler->rowCount(), 3 );
+        QCOMPARE( value( 0, 0 ), 100.0 );
+        QCOMPARE( value( 2, 3 ), 103.0 );
+        QCOMPARE( m_resampler->bucketTickCount( 0 ), 8 );
+
+        // the interval keeps growing with the data
+        appendTick( 30.0, 100 );
+        QCOMPARE( m_resampler->rowCount(), 4 );
+        appendTick( 40.0, 100 );
+        QCOMPARE( m_resampler->interval(), 8.0 );
+        QVERIFY( m_resampler->rowCount() <= 4 );
+
+        m_resampler->setMaximumBucketCount( 0 );
+        QCOMPARE( m_resampler->interval(), 1.0 );
+        QCOMPARE( m_resampler->rowCount(), 12 );
+    }
+
+private:
+    QStandardItemModel *m_ticks;
+    TickResamplingModel *m_resampler;
+};
+
+QTEST_MAIN(TestTickResamplingModel)
+
+#include "main.moc"
@@ -0,0 +1,122 @@
+/**
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+
+#include <KChartWidget>
+#include <KChartGlobal>
+#include <KChartAbstractDiagram>
+
+using namespace KChart;
+
+class TestWidgetDatasets: public QObject {
+    Q_OBJECT
+private slots:
+
+    void init()
+    {
+        m_widget = new Widget( nullptr );
+        m_model = m_widget->diagram()->model();
+    }
+
+    void cleanup()
+    {
+        delete m_widget;
+        m_widget = nullptr;
+    }
+
+    void testSetDataset()
+    {
+        QSignalSpy dataSpy( m_model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)) );
+        QVector< qreal > values;
+        for ( int i = 0; i < 1000; ++i ) {
+            values.append( i );
+        }
+        m_widget->setDataset( 1, values, QStringLiteral( "Values" ) );
+        QCOMPARE( m_model->rowCount(), 1000 );
+        QCOMPARE( m_model->columnCount(), 2 );
+        // the whole dataset is announced at once
+        QCOMPARE( dataSpy.count(), 1 );
+        QCOMPARE( m_model->data( m_model->index( 999, 1 ) ).toReal(), 999.0 );
+        QCOMPARE( m_model->headerData( 1, Qt::Horizontal ).toString(), QStringLiteral( "Values" ) );
+        // cells that were never set are empty
+        QVERIFY( !m_model->data( m_model->index( 0, 0 ) ).isValid() );
+
+        // shorter datasets leave the remaining values alone
+        m_widget->setDataset( 1, QVector< qreal >() << -1 << -2 );
+        QCOMPARE( m_model->rowCount(), 1000 );
+        QCOMPARE( m_model->data( m_model->index( 1, 1 ) ).toReal(), -2.0 );
+        QCOMPARE( m_model->data( m_model->index( 2, 1 ) ).toReal(), 2.0 );
+
+        m_widget->setDataset( 0, std::move( values ) );
+        QCOMPARE( m_model->data( m_model->index( 500, 0 ) ).toReal(), 500.0 );
+    }
+
+    void testAppendToDataset()
+    {
+        m_widget->setDataset( 0, QVector< qreal >() << 1 << 2 << 3 );
+        m_widget->setDataset( 1, QVector< qreal >() << 4 );
+
+        QSignalSpy dataSpy( m_model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)) );
+        QSignalSpy rowsSpy( m_model, SIGNAL(rowsInserted(QModelIndex,int,int)) );
+        m_widget->appendToDataset( 0, QVector< qreal >() << 5 << 6 );
+        QCOMPARE( m_model->rowCount(), 5 );
+        QCOMPARE( rowsSpy.count(), 1 );
+        QCOMPARE( dataSpy.count(), 1 );
+        QCOMPARE( m_model->data( m_model->index( 3, 0 ) ).toReal(), 5.0 );
+        QCOMPARE( m_model->data( m_model->index( 4, 0 ) ).toReal(), 6.0 );
+
+        // appending to the shorter dataset fills its gap first
+        m_widget->appendToDataset( 1, QVector< qreal >() << 7 );
+        QCOMPARE( m_model->rowCount(), 5 );
+        QCOMPARE( m_model->data( m_model->index( 1, 1 ) ).toReal(), 7.0 );
+    }
+
+    void testPairDatasets()
+    {
+        m_widget->setType( Widget::Plot );
+        m_model = m_widget->diagram()->model();
+        QVector< QPair< qreal, qreal > > pairs;
+        pairs << qMakePair( 1.0, 10.0 ) << qMakePair( 2.0, 20.0 );
+        m_widget->setDataset( 0, pairs );
+        m_widget->appendToDataset( 0, QVector< QPair< qreal, qreal > >() << qMakePair( 3.0, 30.0 ) );
+        QCOMPARE( m_model->rowCount(), 3 );
+        QCOMPARE( m_model->columnCount(), 2 );
+        QCOMPARE( m_model->data( m_model->index( 2, 0 ) ).toReal(), 3.0 );
+        QCOMPARE( m_model->data( m_model->index( 2, 1 ) ).toReal(), 30.0 );
+    }
+
+    void testResetData()
+    {
+        m_widget->setDataset( 0, QVector< qreal >() << 1 << 2 );
+        m_widget->resetData();
+        QCOMPARE( m_model->rowCount(), 0 );
+        QCOMPARE( m_model->columnCount(), 0 );
+        m_widget->appendToDataset( 0, QVector< qreal >() << 3 );
+        QCOMPARE( m_model->data( m_model->index( 0, 0 ) ).toReal(), 3.0 );
+    }
+
+private:
+    Widget *m_widget;
+    QAbstractItemModel *m_model;
+};
+
+QTEST_MAIN(TestWidgetDatasets)
+
+#include "main.moc"
@@ -123,6 +123,54 @@ namespace KChart {
             return transform.map( data );
         }
 
+        // convert count data space points to screen points, the same as calling translate()
+        // for each of them
+        void translate( const qreal* keys, const qreal* values, int count, QPointF* screenPoints ) const
+        {
+            if ( transform.type() > QTransform::TxScale ) {
+                for ( int i = 0; i < count; ++i ) {
+                    screenPoints[ i ] = translate( QPointF( keys[ i ], values[ i ] ) );
+                }
+                return;
+            }
+
+            // Only scaled and translated: x only depends on the key and y only on the
+            // value. The axis modes are checked once, outside of the loops, so that the
+            // linear loop is free of calls and branches and compilers can vectorize it.
+            const qreal m11 = transform.m11();
+            const qreal m22 = transform.m22();
+            const qreal dx = transform.dx();
+            const qreal dy = transform.dy();
+            const bool logX = axesCalcModeX == CartesianCoordinatePlane::Logarithmic;
+            const bool logY = axesCalcModeY == CartesianCoordinatePlane::Logarithmic;
+            if ( !logX && !logY ) {
+                for ( int i = 0; i < count; ++i ) {
+                    screenPoints[ i ] = QPointF( m11 * keys[ i ] + dx, m22 * values[ i ] + dy );
+                }
+                return;
+            }
+
+            // a logarithmic axis never crosses zero, so the sign is the same for all points
+            const qreal signX = isPositiveX ? 1.0 : -1.0;
+            const qreal signY = isPositiveY ? 1.0 : -1.0;
+            if ( logX && logY ) {
+                for ( int i = 0; i < count; ++i ) {
+                    screenPoints[ i ] = QPointF( m11 * signX * log10( signX * keys[ i ] ) + dx,
+                                                 m22 * signY * log10( signY * values[ i ] ) + dy );
+                }
+            } else if ( logX ) {
+                for ( int i = 0; i < count; ++i ) {
+                    screenPoints[ i ] = QPointF( m11 * signX * log10( signX * keys[ i ] ) + dx,
+                                                 m22 * values[ i ] + dy );
+                }
+            } else {
+                for ( int i = 0; i < count; ++i ) {
+                    screenPoints[ i ] = QPointF( m11 * keys[ i ] + dx,
+                                                 m22 * signY * log10( signY * values[ i ] ) + dy );
+                }
+            }
+        }
+
         // convert screen point to data space point
         inline const QPointF translateBack( const QPointF& screenPoint ) const
         {
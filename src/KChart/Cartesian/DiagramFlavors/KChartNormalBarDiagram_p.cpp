@@ -25,6 +25,7 @@
 #include "KChartTextAttributes.h"
 #include "KChartAttributesModel.h"
 #include "KChartAbstractCartesianDiagram.h"
+#include "KChartCartesianCoordinatePlane.h"
 
 using namespace KChart;
 using namespace std;
@@ -42,39 +43,19 @@ BarDiagram::BarType NormalBarDiagram::type() const
 const QPair<QPointF, QPointF> NormalBarDiagram::calculateDataBoundaries() const
 {
     const int rowCount = compressor().modelDataRows();
-    const int colCount = compressor().modelDataColumns();
 
     const qreal xMin = 0.0;
     const qreal xMax = rowCount;
+    // missing values are shown as 0
+    const CartesianDiagramDataCompressor::Extents extents = compressor().extents();
     qreal yMin = 0.0;
     qreal yMax = 0.0;
-
-    qreal usedDepth = 0;
-
-    bool isFirst = true;
-    for ( int column = 0; column < colCount; ++column ) {
-        for ( int row = 0; row < rowCount; ++row ) {
-            const CartesianDiagramDataCompressor::CachePosition position( row, column );
-            const CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
-            const qreal value = ISNAN( point.value ) ? 0.0 : point.value;
-
-            QModelIndex sourceIndex = attributesModel()->mapToSource( point.index );
-            ThreeDBarAttributes threeDAttrs = diagram()->threeDBarAttributes( sourceIndex );
-
-            if ( threeDAttrs.isEnabled() )
-                usedDepth = qMax( usedDepth, threeDAttrs.depth() );
-
-            // this is always true yMin can be 0 in case all values
-            // are the same
-            // same for yMax it can be zero if all values are negative
-            if ( isFirst ) {
-                yMin = value;
-                yMax = value;
-                isFirst = false;
-            } else {
-                yMin = qMin( yMin, value );
-                yMax = qMax( yMax, value );
-            }
+    if ( !ISNAN( extents.valueMin ) ) {
+        yMin = extents.valueMin;
+        yMax = extents.valueMax;
+        if ( extents.hasMissingValues ) {
+            yMin = qMin( yMin, 0.0 );
+            yMax = qMax( yMax, 0.0 );
         }
     }
 
@@ -94,7 +75,9 @@ const QPair<QPointF, QPointF> NormalBarDiagram::calculateDataBoundaries() const
 
 void NormalBarDiagram::paint( PaintContext* ctx )
 {
-    reverseMapper().clear();
+    int firstRow = 0;
+    int lastRow = 0;
+    m_private->exposedRows( ctx, &firstRow, &lastRow );
 
     const QPair<QPointF,QPointF> boundaries = diagram()->dataBoundaries(); // cached
 
@@ -151,9 +134,34 @@ void NormalBarDiagram::paint( PaintContext* ctx )
     calculateValueAndGapWidths( rowCount, colCount, groupWidth,
                                 barWidth, spaceBetweenBars, spaceBetweenGroups );
 
+    // the tops and the bottoms of all bars are translated at once
+    Q_ASSERT( dynamic_cast< CartesianCoordinatePlane* >( ctx->coordinatePlane() ) );
+    const CartesianCoordinatePlane* const plane = static_cast< CartesianCoordinatePlane* >( ctx->coordinatePlane() );
+    // the rows painted, all of them unless only a part of the diagram is exposed
+    lastRow = qMin( lastRow, rowCount - 1 );
+    const int pointCount = qMax( 0, lastRow - firstRow + 1 ) * colCount;
+    QVector< qreal > topKeys( pointCount );
+    QVector< qreal > bottomKeys( pointCount );
+    QVector< qreal > values( pointCount );
+    const QVector< qreal > zeroValues( pointCount, 0.0 );
+    for ( int row = firstRow; row <= lastRow; ++row ) {
+        for ( int column = 0; column < colCount; ++column ) {
+            const CartesianDiagramDataCompressor::DataPoint point
+                = compressor().data( CartesianDiagramDataCompressor::CachePosition( row, column ) );
+            const int i = ( row - firstRow ) * colCount + column;
+            topKeys[ i ] = point.key + 0.5;
+            bottomKeys[ i ] = point.key;
+            values[ i ] = point.value;
+        }
+    }
+    QPolygonF topPoints( pointCount );
+    QPolygonF bottomPoints( pointCount );
+    plane->translate( topKeys.constData(), values.constData(), pointCount, topPoints.data() );
+    plane->translate( bottomKeys.constData(), zeroValues.constData(), pointCount, bottomPoints.data() );
+
     LabelPaintCache lpc;
 
-    for ( int row = 0; row < rowCount; ++row ) {
+    for ( int row = firstRow; row <= lastRow; ++row ) {
         qreal offset = -groupWidth / 2 + spaceBetweenGroups / 2;
 
         if ( ba.useFixedDataValueGap() ) {
@@ -175,8 +183,8 @@ void NormalBarDiagram::paint( PaintContext* ctx )
             const QModelIndex sourceIndex = attributesModel()->mapToSource( point.index );
             const qreal value = point.value;//attributesModel()->data( sourceIndex ).toReal();
             if ( ! point.hidden && !ISNAN( value ) ) {
-                QPointF topPoint = ctx->coordinatePlane()->translate( QPointF( point.key + 0.5, value ) );
-                QPointF bottomPoint =  ctx->coordinatePlane()->translate( QPointF( point.key, 0 ) );
+                QPointF topPoint = topPoints.at( ( row - firstRow ) * colCount + column );
+                const QPointF bottomPoint = bottomPoints.at( ( row - firstRow ) * colCount + column );
 
                 if ( threeDAttrs.isEnabled() ) {
                     const qreal usedDepth = threeDAttrs.depth() / 4;
@@ -49,18 +49,33 @@ const QPair< QPointF, QPointF > NormalLineDiagram::calculateDataBoundaries() con
 
 void NormalLineDiagram::paint( PaintContext* ctx )
 {
-    reverseMapper().clear();
+    int firstRow = 0;
+    int lastRow = 0;
+    m_private->exposedRows( ctx, &firstRow, &lastRow );
     Q_ASSERT( dynamic_cast<CartesianCoordinatePlane*>( ctx->coordinatePlane() ) );
     CartesianCoordinatePlane* plane = static_cast<CartesianCoordinatePlane*>( ctx->coordinatePlane() );
     const int columnCount = compressor().modelDataColumns();
-    const int rowCount = compressor().modelDataRows();
-    if ( columnCount == 0 || rowCount == 0 ) return; // maybe blank out the area?
+    // the rows painted, all of them unless only a part of the diagram is exposed
+    const int pointCount = lastRow - firstRow + 1;
+    if ( columnCount == 0 || pointCount <= 0 ) return; // maybe blank out the area?
 
     // Reverse order of data sets?
     bool rev = diagram()->reverseDatasetOrder();
     LabelPaintCache lpc;
     LineAttributesInfoList lineList;
 
+    // Get min. y value, used as lower or upper bounding for area highlighting
+    const qreal minYValue = qMin(plane->visibleDataRange().bottom(), plane->visibleDataRange().top());
+    const qreal offset = diagram()->centerDataPoints() ? 0.5 : 0;
+
+    // the line ends and the lower area corners of a dataset are translated all at once
+    CartesianDiagramDataCompressor::DataPointVector points( pointCount );
+    QVector< qreal > keys( pointCount );
+    QVector< qreal > values( pointCount );
+    const QVector< qreal > minYValues( pointCount, minYValue );
+    QPolygonF lineEnds( pointCount );
+    QPolygonF areaCorners( pointCount );
+
     const int step = rev ? -1 : 1;
     const int end = rev ? -1 : columnCount;
     for ( int column = rev ? columnCount - 1 : 0; column != end; column += step ) {
@@ -68,17 +83,26 @@ void NormalLineDiagram::paint( PaintContext* ctx )
         CartesianDiagramDataCompressor::DataPoint lastPoint;
         qreal lastAreaBoundingValue = 0;
 
-        // Get min. y value, used as lower or upper bounding for area highlighting
-        const qreal minYValue = qMin(plane->visibleDataRange().bottom(), plane->visibleDataRange().top());
+        for ( int i = 0; i < pointCount; ++i ) {
+            points[ i ] = compressor().data( CartesianDiagramDataCompressor::CachePosition( firstRow + i, column ) );
+            keys[ i ] = points[ i ].key + offset;
+            values[ i ] = points[ i ].value;
+        }
+        plane->translate( keys.constData(), values.constData(), pointCount, lineEnds.data() );
+        plane->translate( keys.constData(), minYValues.constData(), pointCount, areaCorners.data() );
+        QPointF lastLineEnd = plane->translate( QPointF( lastPoint.key + offset, lastPoint.value ) );
+        QPointF lastAreaCorner = plane->translate( QPointF( lastPoint.key + offset, lastAreaBoundingValue ) );
 
         CartesianDiagramDataCompressor::CachePosition previousCellPosition;
-        for ( int row = 0; row < rowCount; ++row ) {
+        for ( int row = firstRow; row <= lastRow; ++row ) {
             const CartesianDiagramDataCompressor::CachePosition position( row, column );
             // get where to draw the line from:
-            CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
+            CartesianDiagramDataCompressor::DataPoint point = points.at( row - firstRow );
             if ( point.hidden ) {
                 continue;
             }
+            QPointF lineEnd = lineEnds.at( row - firstRow );
+            QPointF areaCorner = areaCorners.at( row - firstRow );
 
             const QModelIndex sourceIndex = attributesModel()->mapToSource( point.index );
 
@@ -90,6 +114,7 @@ void NormalLineDiagram::paint( PaintContext* ctx )
             if ( laCell.areaBoundingDataset() != -1 ) {
                 const CartesianDiagramDataCompressor::CachePosition areaBoundingCachePosition( row, laCell.areaBoundingDataset() );
                 areaBoundingValue = compressor().data( areaBoundingCachePosition ).value;
+                areaCorner = plane->translate( QPointF( point.key + offset, areaBoundingValue ) );
             } else {
                 // Use min. y value (i.e. zero line in most cases) if no bounding dataset is set
                 areaBoundingValue = minYValue;
@@ -105,6 +130,7 @@ void NormalLineDiagram::paint( PaintContext* ctx )
                 case LineAttributes::MissingValuesShownAsZero:
                     // set it to zero
                     point.value = 0.0;
+                    lineEnd = plane->translate( QPointF( point.key + offset, point.value ) );
                     break;
                 case LineAttributes::MissingValuesHideSegments:
                     // they're just hidden
@@ -117,11 +143,10 @@ void NormalLineDiagram::paint( PaintContext* ctx )
 
             if ( !ISNAN( point.value ) ) {
                 // area corners, a + b are the line ends:
-                const qreal offset = diagram()->centerDataPoints() ? 0.5 : 0;
-                const QPointF a( plane->translate( QPointF( lastPoint.key + offset, lastPoint.value ) ) );
-                const QPointF b( plane->translate( QPointF( point.key + offset, point.value ) ) );
-                const QPointF c( plane->translate( QPointF( lastPoint.key + offset, lastAreaBoundingValue ) ) );
-                const QPointF d( plane->translate( QPointF( point.key + offset, areaBoundingValue ) ) );
+                const QPointF a( lastLineEnd );
+                const QPointF b( lineEnd );
+                const QPointF c( lastAreaCorner );
+                const QPointF d( areaCorner );
                 const PositionPoints pts = PositionPoints( b, a, d, c );
 
                 // add label
@@ -145,6 +170,8 @@ void NormalLineDiagram::paint( PaintContext* ctx )
             laPreviousCell = laCell;
             lastAreaBoundingValue = areaBoundingValue;
             lastPoint = point;
+            lastLineEnd = lineEnd;
+            lastAreaCorner = areaCorner;
         }
     }
 
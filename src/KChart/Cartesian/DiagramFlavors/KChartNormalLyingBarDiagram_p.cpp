@@ -43,30 +43,19 @@ BarDiagram::BarType NormalLyingBarDiagram::type() const
 const QPair<QPointF, QPointF> NormalLyingBarDiagram::calculateDataBoundaries() const
 {
     const int rowCount = compressor().modelDataRows();
-    const int colCount = compressor().modelDataColumns();
 
     const qreal xMin = 0.0;
     const qreal xMax = rowCount;
+    // missing values are shown as 0
+    const CartesianDiagramDataCompressor::Extents extents = compressor().extents();
     qreal yMin = 0.0;
     qreal yMax = 0.0;
-
-    bool isFirst = true;
-    for ( int column = 0; column < colCount; ++column ) {
-        for ( int row = 0; row < rowCount; ++row ) {
-            const CartesianDiagramDataCompressor::CachePosition position( row, column );
-            const CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
-            const qreal value = ISNAN( point.value ) ? 0.0 : point.value;
-            // this is always true yMin can be 0 in case all values
-            // are the same
-            // same for yMax it can be zero if all values are negative
-            if ( isFirst ) {
-                yMin = value;
-                yMax = value;
-                isFirst = false;
-            } else {
-                yMin = qMin( yMin, value );
-                yMax = qMax( yMax, value );
-            }
+    if ( !ISNAN( extents.valueMin ) ) {
+        yMin = extents.valueMin;
+        yMax = extents.valueMax;
+        if ( extents.hasMissingValues ) {
+            yMin = qMin( yMin, 0.0 );
+            yMax = qMax( yMax, 0.0 );
         }
     }
 
@@ -61,6 +61,11 @@ void NormalPlotter::paint( PaintContext* ctx )
         {
             LineAttributesInfoList lineList;
             PlotterDiagramCompressor::DataPoint lastPoint;
+            // the translated lastPoint and its projection onto the null line
+            const QPointF noPoint( plane->translate( QPointF( lastPoint.key, lastPoint.value ) ) );
+            const QPointF noNullLinePoint( plane->translate( QPointF( lastPoint.key, 0.0 ) ) );
+            QPointF lastLineEnd = noPoint;
+            QPointF lastNullLinePoint = noNullLinePoint;
             for ( PlotterDiagramCompressor::Iterator it = plotterCompressor().begin( dataset ); it != plotterCompressor().end( dataset ); ++ it )
             {
                 const PlotterDiagramCompressor::DataPoint point = *it;
@@ -79,17 +84,19 @@ void NormalPlotter::paint( PaintContext* ctx )
                     case LineAttributes::MissingValuesHideSegments: // fall-through since they're just hidden
                     default:
                         lastPoint = PlotterDiagramCompressor::DataPoint();
+                        lastLineEnd = noPoint;
+                        lastNullLinePoint = noNullLinePoint;
                         continue;
                     }
                 }
 
                 // data area painting: a and b are prev / current data points, c and d are on the null line
                 const QPointF b( plane->translate( QPointF( point.key, point.value ) ) );
+                const QPointF d( plane->translate( QPointF( point.key, 0.0 ) ) );
 
                 if ( !point.hidden && PaintingHelpers::isFinite( b )  ) {
-                    const QPointF a( plane->translate( QPointF( lastPoint.key, lastPoint.value ) ) );
-                    const QPointF c( plane->translate( QPointF( lastPoint.key, 0.0 ) ) );
-                    const QPointF d( plane->translate( QPointF( point.key, 0.0 ) ) );
+                    const QPointF a( lastLineEnd );
+                    const QPointF c( lastNullLinePoint );
 
                     // data point label
                     const PositionPoints pts = PositionPoints( b, a, d, c );
@@ -115,6 +122,8 @@ void NormalPlotter::paint( PaintContext* ctx )
                 }
 
                 lastPoint = point;
+                lastLineEnd = b;
+                lastNullLinePoint = d;
             }
             PaintingHelpers::paintElements( m_private, ctx, lpc, lineList );
         }
@@ -123,15 +132,37 @@ void NormalPlotter::paint( PaintContext* ctx )
     {
         if ( colCount == 0 || rowCount == 0 )
             return;
+
+        // the data points of a dataset and their projections onto the null line are
+        // translated all at once
+        CartesianDiagramDataCompressor::DataPointVector points( rowCount );
+        QVector< qreal > keys( rowCount );
+        QVector< qreal > values( rowCount );
+        const QVector< qreal > nullValues( rowCount, 0.0 );
+        QPolygonF lineEnds( rowCount );
+        QPolygonF nullLinePoints( rowCount );
+
         for ( int column = 0; column < colCount; ++column )
         {
             LineAttributesInfoList lineList;
             CartesianDiagramDataCompressor::DataPoint lastPoint;
 
+            for ( int row = 0; row < rowCount; ++row ) {
+                points[ row ] = compressor().data( CartesianDiagramDataCompressor::CachePosition( row, column ) );
+                keys[ row ] = points[ row ].key;
+                values[ row ] = points[ row ].value;
+            }
+            plane->translate( keys.constData(), values.constData(), rowCount, lineEnds.data() );
+            plane->translate( keys.constData(), nullValues.constData(), rowCount, nullLinePoints.data() );
+            // the translated lastPoint and its projection onto the null line
+            const QPointF noPoint( plane->translate( QPointF( lastPoint.key, lastPoint.value ) ) );
+            const QPointF noNullLinePoint( plane->translate( QPointF( lastPoint.key, 0.0 ) ) );
+            QPointF lastLineEnd = noPoint;
+            QPointF lastNullLinePoint = noNullLinePoint;
+
             for ( int row = 0; row < rowCount; ++row )
             {
-                const CartesianDiagramDataCompressor::CachePosition position( row, column );
-                const CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
+                const CartesianDiagramDataCompressor::DataPoint& point = points.at( row );
 
                 const QModelIndex sourceIndex = attributesModel()->mapToSource( point.index );
                 LineAttributes laCell = diagram()->lineAttributes( sourceIndex );
@@ -147,17 +178,19 @@ void NormalPlotter::paint( PaintContext* ctx )
                     case LineAttributes::MissingValuesHideSegments: // fall-through since they're just hidden
                     default:
                         lastPoint = CartesianDiagramDataCompressor::DataPoint();
+                        lastLineEnd = noPoint;
+                        lastNullLinePoint = noNullLinePoint;
                         continue;
                     }
                 }
 
                 // data area painting: a and b are prev / current data points, c and d are on the null line
-                const QPointF b( plane->translate( QPointF( point.key, point.value ) ) );
+                const QPointF b( lineEnds.at( row ) );
+                const QPointF d( nullLinePoints.at( row ) );
 
                 if ( !point.hidden && PaintingHelpers::isFinite( b )  ) {
-                    const QPointF a( plane->translate( QPointF( lastPoint.key, lastPoint.value ) ) );
-                    const QPointF c( plane->translate( QPointF( lastPoint.key, 0.0 ) ) );
-                    const QPointF d( plane->translate( QPointF( point.key, 0.0 ) ) );
+                    const QPointF a( lastLineEnd );
+                    const QPointF c( lastNullLinePoint );
 
                     // data point label
                     const PositionPoints pts = PositionPoints( b, a, d, c );
@@ -183,6 +216,8 @@ void NormalPlotter::paint( PaintContext* ctx )
                 }
 
                 lastPoint = point;
+                lastLineEnd = b;
+                lastNullLinePoint = d;
             }
             PaintingHelpers::paintElements( m_private, ctx, lpc, lineList );
         }
@@ -120,25 +120,6 @@ void PercentBarDiagram::paint( PaintContext* ctx )
 
     LabelPaintCache lpc;
     const qreal maxValue = 100; // always 100 %
-    qreal sumValues = 0;
-    QVector <qreal > sumValuesVector;
-
-    //calculate sum of values for each column and store
-    for ( int row = 0; row < rowCount; ++row )
-    {
-        for ( int col = 0; col < colCount; ++col )
-        {
-            const CartesianDiagramDataCompressor::CachePosition position( row, col );
-            const CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
-            //if ( point.value > 0 )
-            sumValues += qMax( point.value, -point.value );
-            if ( col == colCount - 1 ) {
-                sumValuesVector <<  sumValues ;
-                sumValues = 0;
-            }
-        }
-    }
-
     // calculate stacked percent value
     for ( int col = 0; col < colCount; ++col )
     {
@@ -173,25 +154,18 @@ void PercentBarDiagram::paint( PaintContext* ctx )
             }
 
             const qreal value = qMax( p.value, -p.value );
-            qreal stackedValues = 0.0;
-            qreal key = 0.0;
-            
             // calculate stacked percent value
-            // we only take in account positives values for now.
-            for ( int k = col; k >= 0 ; --k )
-            {
-                const CartesianDiagramDataCompressor::CachePosition position( row, k );
-                const CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
-                stackedValues += qMax( point.value, -point.value );
-                key = point.key;
-            }
+            // we only take in account the absolute values for now.
+            const qreal stackedValues = compressor().stackedSums( position ).absolute();
+            const qreal rowSum = compressor().rowSums( row ).absolute();
+            const qreal key = compressor().data( CartesianDiagramDataCompressor::CachePosition( row, 0 ) ).key;
 
             QPointF point, previousPoint;
-            if ( sumValuesVector.at( row ) != 0 && value > 0 ) {
-                point = ctx->coordinatePlane()->translate( QPointF( key,  stackedValues / sumValuesVector.at( row ) * maxValue ) );
+            if ( rowSum != 0 && value > 0 ) {
+                point = ctx->coordinatePlane()->translate( QPointF( key,  stackedValues / rowSum * maxValue ) );
                 point.rx() += offset / 2;
 
-                previousPoint = ctx->coordinatePlane()->translate( QPointF( key, ( stackedValues - value)/sumValuesVector.at(row)* maxValue ) );
+                previousPoint = ctx->coordinatePlane()->translate( QPointF( key, ( stackedValues - value)/rowSum* maxValue ) );
             }
             const qreal barHeight = previousPoint.y() - point.y();
 
@@ -87,6 +87,10 @@ void PercentLineDiagram::paint( PaintContext* ctx )
     //calculate sum of values for each column and store
     for ( int row = 0; row < rowCount; ++row )
     {
+        if ( !compressor().rowHasMissingValues( row ) ) {
+            percentSumValues << compressor().rowSums( row ).positive;
+            continue;
+        }
         for ( int col = 0; col < columnCount; ++col )
         {
             const CartesianDiagramDataCompressor::CachePosition position( row, col );
@@ -126,23 +130,21 @@ void PercentLineDiagram::paint( PaintContext* ctx )
             const bool bDisplayCellArea = laCell.displayArea();
 
             qreal stackedValues = 0, nextValues = 0, nextKey = 0;
-            for ( int column2 = column;
-                  column2 >= 0;//datasetDimension() - 1;
-                  column2 -= 1 )//datasetDimension() )
-            {
-                const CartesianDiagramDataCompressor::CachePosition position( row, column2 );
-                CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
-
-                const LineAttributes::MissingValuesPolicy policy = laCell.missingValuesPolicy();
-                if ( ISNAN( point.value ) && policy == LineAttributes::MissingValuesAreBridged )
-                    point.value = interpolateMissingValue( position );
-
-                const qreal val = point.value;
-                if ( val > 0 )
-                    stackedValues += val;
-                //qDebug() << valueForCell( iRow, iColumn2 );
+            if ( laCell.missingValuesPolicy() != LineAttributes::MissingValuesAreBridged ||
+                 ( !compressor().rowHasMissingValues( row ) &&
+                   ( row + 1 >= rowCount || !compressor().rowHasMissingValues( row + 1 ) ) ) ) {
+                stackedValues = compressor().stackedSums( position ).positive;
                 if ( row + 1 < rowCount ) {
-                    const CartesianDiagramDataCompressor::CachePosition position( row + 1, column2 );
+                    const CartesianDiagramDataCompressor::CachePosition nextPosition( row + 1, column );
+                    nextValues = compressor().stackedSums( nextPosition ).positive;
+                    nextKey = compressor().data( CartesianDiagramDataCompressor::CachePosition( row + 1, 0 ) ).key;
+                }
+            } else {
+                for ( int column2 = column;
+                      column2 >= 0;//datasetDimension() - 1;
+                      column2 -= 1 )//datasetDimension() )
+                {
+                    const CartesianDiagramDataCompressor::CachePosition position( row, column2 );
                     CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
 
                     const LineAttributes::MissingValuesPolicy policy = laCell.missingValuesPolicy();
@@ -151,8 +153,21 @@ void PercentLineDiagram::paint( PaintContext* ctx )
 
                     const qreal val = point.value;
                     if ( val > 0 )
-                        nextValues += val;
-                    nextKey = point.key;
+                        stackedValues += val;
+                    //qDebug() << valueForCell( iRow, iColumn2 );
+                    if ( row + 1 < rowCount ) {
+                        const CartesianDiagramDataCompressor::CachePosition position( row + 1, column2 );
+                        CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
+
+                        const LineAttributes::MissingValuesPolicy policy = laCell.missingValuesPolicy();
+                        if ( ISNAN( point.value ) && policy == LineAttributes::MissingValuesAreBridged )
+                            point.value = interpolateMissingValue( position );
+
+                        const qreal val = point.value;
+                        if ( val > 0 )
+                            nextValues += val;
+                        nextKey = point.key;
+                    }
                 }
             }
             if ( percentSumValues.at( row ) != 0 )
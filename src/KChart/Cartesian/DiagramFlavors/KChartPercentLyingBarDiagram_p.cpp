@@ -126,25 +126,6 @@ void PercentLyingBarDiagram::paint( PaintContext* ctx )
     
     LabelPaintCache lpc;
     const qreal maxValue = 100.0; // always 100 %
-    qreal sumValues = 0;
-    QVector <qreal > sumValuesVector;
-
-    //calculate sum of values for each column and store
-    for ( int row = 0; row < rowCount; ++row )
-    {
-        for ( int col = 0; col < colCount; ++col )
-        {
-            const CartesianDiagramDataCompressor::CachePosition position( row, col );
-            const CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
-            //if ( point.value > 0 )
-            sumValues += qMax( point.value, -point.value );
-            if ( col == colCount - 1 ) {
-                sumValuesVector <<  sumValues ;
-                sumValues = 0;
-            }
-        }
-    }
-
     // calculate stacked percent value
     for ( int curRow = rowCount - 1; curRow >= 0; --curRow )
     {
@@ -182,26 +163,19 @@ void PercentLyingBarDiagram::paint( PaintContext* ctx )
             }
 
             const qreal value = qMax( p.value, -p.value );
-            qreal stackedValues = 0.0;
-            qreal key = 0.0;
-            
             // calculate stacked percent value
-            // we only take in account positives values for now.
-            for ( int k = col; k >= 0 ; --k )
-            {
-                const CartesianDiagramDataCompressor::CachePosition position( curRow, k );
-                const CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
-                stackedValues += qMax( point.value, -point.value );
-                key = point.key;
-            }
+            // we only take in account the absolute values for now.
+            const qreal stackedValues = compressor().stackedSums( position ).absolute();
+            const qreal rowSum = compressor().rowSums( curRow ).absolute();
+            const qreal key = compressor().data( CartesianDiagramDataCompressor::CachePosition( curRow, 0 ) ).key;
 
             QPointF point, previousPoint;
-            if ( sumValuesVector.at( curRow ) != 0 && value > 0 ) {
-                QPointF dataPoint( ( stackedValues / sumValuesVector.at( curRow ) * maxValue ), key + 1 );
+            if ( rowSum != 0 && value > 0 ) {
+                QPointF dataPoint( ( stackedValues / rowSum * maxValue ), key + 1 );
                 point = ctx->coordinatePlane()->translate( dataPoint );
                 point.ry() += offset / 2 + threeDOffset;
 
-                previousPoint = ctx->coordinatePlane()->translate( QPointF( ( ( stackedValues - value) / sumValuesVector.at( curRow ) * maxValue ), key + 1 ) );
+                previousPoint = ctx->coordinatePlane()->translate( QPointF( ( ( stackedValues - value) / rowSum * maxValue ), key + 1 ) );
             }
             
             const qreal barHeight = point.x() - previousPoint.x();
@@ -166,8 +166,10 @@ void StackedBarDiagram::paint( PaintContext* ctx )
             const QModelIndex index = attributesModel()->mapToSource( p.index );
             ThreeDBarAttributes threeDAttrs = diagram()->threeDBarAttributes( index );
             const qreal value = p.value;
-            qreal stackedValues = 0.0;
-            qreal key = 0.0;
+            // the datasets up to this one, stacked separately for positive and negative values
+            const CartesianDiagramDataCompressor::StackedSums& sums = compressor().stackedSums( position );
+            const qreal stackedValues = value >= 0.0 ? sums.positive : sums.negative;
+            const qreal key = compressor().data( CartesianDiagramDataCompressor::CachePosition( row, 0 ) ).key;
 
             if ( threeDAttrs.isEnabled() ) {
                 if ( barWidth > 0 )
@@ -180,15 +182,6 @@ void StackedBarDiagram::paint( PaintContext* ctx )
                 barWidth =  (width - (offset*rowCount))/ rowCount ;
             }
 
-            for ( int k = col; k >= 0; --k )
-            {
-                const CartesianDiagramDataCompressor::CachePosition position( row, k );
-                const CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
-                if ( !ISNAN( point.value ) && (( p.value >= 0.0 && point.value >= 0.0 ) || ( p.value < 0.0 && point.value < 0.0 )) )
-                    stackedValues += point.value;
-                key = point.key;
-            }
-
             if (!ISNAN( value ))
             {
                 const qreal usedDepth = threeDAttrs.depth();
@@ -138,36 +138,48 @@ void StackedLineDiagram::paint( PaintContext* ctx )
                 point.value = 0.0;
 
             qreal stackedValues = 0, nextValues = 0, nextKey = 0;
-            for ( int column2 = column; column2 >= 0; --column2 )
-            {
-                const CartesianDiagramDataCompressor::CachePosition position( row, column2 );
-                const CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
-                if ( !ISNAN( point.value ) )
-                {
-                    stackedValues += point.value;
+            if ( policy != LineAttributes::MissingValuesAreBridged ||
+                 ( !compressor().rowHasMissingValues( row ) &&
+                   ( row + 1 >= rowCount || !compressor().rowHasMissingValues( row + 1 ) ) ) ) {
+                // nothing to interpolate, missing values count as 0 like in the precalculated sums
+                stackedValues = compressor().stackedSums( position ).total();
+                if ( row + 1 < rowCount ) {
+                    const CartesianDiagramDataCompressor::CachePosition nextPosition( row + 1, column );
+                    nextValues = compressor().stackedSums( nextPosition ).total();
+                    nextKey = compressor().data( CartesianDiagramDataCompressor::CachePosition( row + 1, 0 ) ).key;
                 }
-                else if ( policy == LineAttributes::MissingValuesAreBridged )
+            } else {
+                for ( int column2 = column; column2 >= 0; --column2 )
                 {
-                    const qreal interpolation = interpolateMissingValue( position );
-                    if ( !ISNAN( interpolation ) )
-                        stackedValues += interpolation;
-                }
-
-                //qDebug() << valueForCell( iRow, iColumn2 );
-                if ( row + 1 < rowCount ) {
-                    const CartesianDiagramDataCompressor::CachePosition position( row + 1, column2 );
+                    const CartesianDiagramDataCompressor::CachePosition position( row, column2 );
                     const CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
                     if ( !ISNAN( point.value ) )
                     {
-                        nextValues += point.value;
+                        stackedValues += point.value;
                     }
                     else if ( policy == LineAttributes::MissingValuesAreBridged )
                     {
                         const qreal interpolation = interpolateMissingValue( position );
                         if ( !ISNAN( interpolation ) )
-                            nextValues += interpolation;
+                            stackedValues += interpolation;
+                    }
+
+                    //qDebug() << valueForCell( iRow, iColumn2 );
+                    if ( row + 1 < rowCount ) {
+                        const CartesianDiagramDataCompressor::CachePosition position( row + 1, column2 );
+                        const CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
+                        if ( !ISNAN( point.value ) )
+                        {
+                            nextValues += point.value;
+                        }
+                        else if ( policy == LineAttributes::MissingValuesAreBridged )
+                        {
+                            const qreal interpolation = interpolateMissingValue( position );
+                            if ( !ISNAN( interpolation ) )
+                                nextValues += interpolation;
+                        }
+                        nextKey = point.key;
                     }
-                    nextKey = point.key;
                 }
             }
             //qDebug() << stackedValues << endl;
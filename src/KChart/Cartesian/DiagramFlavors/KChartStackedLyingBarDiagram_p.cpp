@@ -165,8 +165,10 @@ void StackedLyingBarDiagram::paint( PaintContext* ctx )
             const QModelIndex index = attributesModel()->mapToSource( p.index );
             ThreeDBarAttributes threeDAttrs = diagram()->threeDBarAttributes( index );
             const qreal value = p.value;
-            qreal stackedValues = 0.0;
-            qreal key = 0.0;
+            // the datasets up to this one, stacked separately for positive and negative values
+            const CartesianDiagramDataCompressor::StackedSums& sums = compressor().stackedSums( position );
+            const qreal stackedValues = ISNAN( value ) ? 0.0 : value >= 0.0 ? sums.positive : sums.negative;
+            const qreal key = compressor().data( CartesianDiagramDataCompressor::CachePosition( row, 0 ) ).key;
 
             if ( threeDAttrs.isEnabled() ) {
                 if ( barWidth > 0 ) {
@@ -181,14 +183,6 @@ void StackedLyingBarDiagram::paint( PaintContext* ctx )
                 barWidth = (width - (offset*rowCount))/ rowCount;
             }
 
-            for ( int k = col; k >= 0; --k )
-            {
-                const CartesianDiagramDataCompressor::CachePosition position( row, k );
-                const CartesianDiagramDataCompressor::DataPoint point = compressor().data( position );
-                if ( ( p.value >= 0.0 && point.value >= 0.0 ) || ( p.value < 0.0 && point.value < 0.0 ) )
-                    stackedValues += point.value;
-                key = point.key;
-            }
             QPointF point = ctx->coordinatePlane()->translate( QPointF( stackedValues, key + 1 ) );
             point.ry() += offset / 2 + threeDOffset;
             const QPointF previousPoint = ctx->coordinatePlane()->translate( QPointF( stackedValues - value, key + 1 ) );
@@ -21,6 +21,14 @@
 #include "KChartAbstractCartesianDiagram_p.h"
 
 #include "KChartMath_p.h"
+#include "KChartBarDiagram.h"
+#include "KChartCartesianCoordinatePlane.h"
+#include "KChartLineDiagram.h"
+#include "KChartMarkerAttributes.h"
+#include "KChartPaintContext.h"
+#include "KChartThreeDBarAttributes.h"
+#include "KChartThreeDLineAttributes.h"
+#include "KChartValueTrackerAttributes.h"
 
 
 using namespace KChart;
@@ -34,6 +42,124 @@ AbstractCartesianDiagram::Private::~Private()
 {
 }
 
+// how far a line painted with \a pen reaches beyond the points it connects
+static qreal penReach( const QPen& pen )
+{
+    if ( pen.style() == Qt::NoPen ) {
+        return 0.0;
+    }
+    // cosmetic pens are one pixel wide, miter joins can reach further than half the width
+    const qreal width = pen.isCosmetic() ? qMax< qreal >( pen.widthF(), 1.0 ) : pen.widthF();
+    const qreal joinFactor = pen.joinStyle() == Qt::MiterJoin ? qMax< qreal >( pen.miterLimit(), 1.0 ) : 1.0;
+    return width * joinFactor / 2.0;
+}
+
+QRect AbstractCartesianDiagram::Private::damagedRect( int firstRow, int lastRow ) const
+{
+    // Line and bar diagrams show the values of a row at x == row, so a change can only affect
+    // the area up to the neighbouring rows - unless something is drawn further away.
+    // Subclasses like LeveyJenningsDiagram paint differently, so they are not handled.
+    const QMetaObject* metaObject = diagram->metaObject();
+    const LineDiagram* lineDiagram = metaObject == &LineDiagram::staticMetaObject
+                                     ? static_cast< const LineDiagram* >( diagram ) : nullptr;
+    const BarDiagram* barDiagram = metaObject == &BarDiagram::staticMetaObject
+                                   ? static_cast< const BarDiagram* >( diagram ) : nullptr;
+    const CartesianCoordinatePlane* plane = qobject_cast< const CartesianCoordinatePlane* >( diagram->coordinatePlane() );
+    const QAbstractItemModel* model = diagram->model();
+    if ( ( !lineDiagram && !barDiagram ) || !plane || !model || referenceDiagram ||
+         datasetDimension != 1 || isTransposed() ) {
+        return QRect();
+    }
+    const int rowCount = model->rowCount( diagram->rootIndex() );
+    const int columnCount = model->columnCount( diagram->rootIndex() );
+    // for larger changes repainting everything is cheaper than looking at the attributes
+    if ( firstRow < 0 || lastRow >= rowCount || lastRow - firstRow > qMax( 16, rowCount / 8 ) ) {
+        return QRect();
+    }
+
+    // how far the lines and markers of the changed values reach beyond their points, plus
+    // a pixel for antialiasing
+    qreal margin = 1.0;
+    for ( int row = firstRow; row <= lastRow; ++row ) {
+        for ( int column = 0; column < columnCount; ++column ) {
+            const QModelIndex index = model->index( row, column, diagram->rootIndex() );
+            margin = qMax( margin, penReach( diagram->pen( index ) ) + 1.0 );
+            const DataValueAttributes dva = diagram->dataValueAttributes( index );
+            // data value texts can be placed anywhere around the value and hide each other
+            if ( dva.isVisible() ) {
+                return QRect();
+            }
+            const MarkerAttributes ma = dva.markerAttributes();
+            if ( ma.isVisible() ) {
+                if ( ma.markerSizeMode() != MarkerAttributes::AbsoluteSize ) {
+                    return QRect();
+                }
+                margin = qMax( margin, qMax( ma.markerSize().width(), ma.markerSize().height() ) / 2.0
+                                       + penReach( ma.pen() ) + 1.0 );
+            }
+            if ( lineDiagram && ( lineDiagram->valueTrackerAttributes( index ).isEnabled() ||
+                                  lineDiagram->threeDLineAttributes( index ).isEnabled() ) ) {
+                return QRect();
+            }
+            if ( barDiagram && barDiagram->threeDBarAttributes( index ).isEnabled() ) {
+                return QRect();
+            }
+        }
+    }
+
+    // with compression, the neighbouring data points can be several rows away
+    const int compressedRows = compressor.modelDataRows();
+    const int rowsPerPoint = compressedRows > 0 ? qMax( 1, ( rowCount + compressedRows - 1 ) / compressedRows ) : 1;
+    const qreal left = plane->translate( QPointF( firstRow - rowsPerPoint, 0.0 ) ).x();
+    const qreal right = plane->translate( QPointF( lastRow + 1 + rowsPerPoint, 0.0 ) ).x();
+    const QRect planeArea = plane->geometry();
+    const QRectF damaged( QPointF( qMin( left, right ) - margin, planeArea.top() ),
+                          QPointF( qMax( left, right ) + margin, planeArea.bottom() + 1 ) );
+    return damaged.toAlignedRect() & planeArea;
+}
+
+void AbstractCartesianDiagram::Private::exposedRows( const PaintContext* ctx, int* firstRow, int* lastRow )
+{
+    const int rowCount = compressor.modelDataRows();
+    *firstRow = 0;
+    *lastRow = rowCount - 1;
+    const QRectF exposed = ctx->exposedRect();
+    const CartesianCoordinatePlane* plane = qobject_cast< const CartesianCoordinatePlane* >( ctx->coordinatePlane() );
+    bool partial = exposed.isValid() && plane && rowCount > 0 && datasetDimension == 1 && !isTransposed();
+    // data value texts can reach far from their value, into the exposed rectangle
+    if ( partial ) {
+        partial = !diagram->dataValueAttributes().isVisible();
+        const int columnCount = compressor.modelDataColumns();
+        for ( int column = 0; partial && column < columnCount; ++column ) {
+            partial = !diagram->dataValueAttributes( column ).isVisible();
+        }
+    }
+    if ( !partial ) {
+        reverseMapper.clear();
+        return;
+    }
+
+    qreal left = plane->translateBack( exposed.topLeft() ).x();
+    qreal right = plane->translateBack( exposed.topRight() ).x();
+    if ( left > right ) {
+        qSwap( left, right );
+    }
+    // the rows in the exposed rectangle, with a row to spare for centered data points
+    const int first = qBound( 0, compressor.mapToCache( qMax( 0, int( floor( left ) ) - 1 ), 0 ).row, rowCount - 1 );
+    const int last = qBound( first, compressor.mapToCache( qMax( 0, int( ceil( right ) ) + 1 ), 0 ).row, rowCount - 1 );
+    const QModelIndexList firstIndexes = compressor.mapToModel( CartesianDiagramDataCompressor::CachePosition( first, 0 ) );
+    const QModelIndexList lastIndexes = compressor.mapToModel( CartesianDiagramDataCompressor::CachePosition( last, 0 ) );
+    if ( firstIndexes.isEmpty() || lastIndexes.isEmpty() ) {
+        reverseMapper.clear();
+        return;
+    }
+    // everything of these rows is painted again...
+    reverseMapper.clearRows( firstIndexes.first().row(), lastIndexes.last().row() );
+    // ...and their neighbours, for the lines and areas reaching from them into the rectangle
+    *firstRow = qMax( 0, first - 1 );
+    *lastRow = qMin( rowCount - 1, last + 1 );
+}
+
 bool AbstractCartesianDiagram::compare( const AbstractCartesianDiagram* other ) const
 {
     if ( other == this ) return true;
@@ -75,6 +75,17 @@ public:
         return allAttrs;
     }
 
+    /** \reimpl */
+    QRect damagedRect( int firstRow, int lastRow ) const override;
+
+    /**
+     * Sets \a firstRow and \a lastRow to the rows of the compressor that need painting for the
+     * exposed rectangle of \a ctx, or to all rows if everything needs painting. Clears the
+     * reverse mapper for the rows painted, so call this instead of reverseMapper.clear().
+     * Only for diagrams that show the values of a row at x == row, like line and bar diagrams.
+     */
+    void exposedRows( const PaintContext* ctx, int* firstRow, int* lastRow );
+
    CartesianAxisList axesList;
 
    AbstractCartesianDiagram* referenceDiagram;
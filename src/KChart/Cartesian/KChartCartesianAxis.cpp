@@ -34,6 +34,7 @@
 #include "KChartAbstractDiagram_p.h"
 #include "KChartAbstractGrid.h"
 #include "KChartPainterSaver_p.h"
+#include "KChartPerfObserver_p.h"
 #include "KChartLayoutItems.h"
 #include "KChartBarDiagram.h"
 #include "KChartStockDiagram.h"
@@ -84,6 +85,7 @@ TickIterator::TickIterator( CartesianAxis* a, CartesianCoordinatePlane* plane, u
    : m_axis( a ),
      m_majorThinningFactor( majorThinningFactor ),
      m_majorLabelCount( 0 ),
+     m_majorLabelIndex( -1 ),
      m_type( NoTick )
 {
     // deal with the things that are specific to axes (like annotations), before the generic init().
@@ -170,6 +172,7 @@ TickIterator::TickIterator( bool isY, const DataDimension& dimension, bool useAn
      m_majorLabelCount( 0 ),
      m_customTickIndex( -1 ),
      m_manualLabelIndex( -1 ),
+     m_majorLabelIndex( -1 ),
      m_type( NoTick ),
      m_customTick( std::numeric_limits< qreal >::infinity() )
 {
@@ -273,7 +276,10 @@ void TickIterator::computeMajorTickLabel( int decimalPlaces )
         m_type = m_majorThinningFactor > 1 ? MajorTickManualShort : MajorTickManualLong;
     } else {
         // if m_axis is null, we are dealing with grid lines. grid lines never need labels.
-        if ( m_axis && ( m_majorLabelCount++ % m_majorThinningFactor ) == 0 ) {
+        if ( m_axis ) {
+            m_majorLabelIndex = m_majorLabelCount++;
+        }
+        if ( m_axis && ( uint( m_majorLabelIndex ) % m_majorThinningFactor ) == 0 ) {
             QMap< qreal, QString >::ConstIterator it =
                 constify(m_dataHeaderLabels).lowerBound( slightlyLessThan( m_position ) );
 
@@ -301,6 +307,7 @@ void TickIterator::operator++()
         return;
     }
     const qreal inf = std::numeric_limits< qreal >::infinity();
+    m_majorLabelIndex = -1;
 
     // make sure to find the next tick at a value strictly greater than m_position
 
@@ -424,14 +431,17 @@ bool CartesianAxis::compare( const CartesianAxis* other ) const
 
 void CartesianAxis::coordinateSystemChanged()
 {
-    layoutPlanes();
+    // data header labels come from the model, so the measured ticks may be stale
+    if ( d->tickLayout ) {
+        d->tickLayout->clear();
+    }
+    d->updateLayouts();
 }
 
 void CartesianAxis::setTitleText( const QString& text )
 {
     d->titleText = text;
-    setCachedSizeDirty();
-    layoutPlanes();
+    d->updateLayouts();
 }
 
 QString CartesianAxis::titleText() const
@@ -443,8 +453,7 @@ void CartesianAxis::setTitleTextAttributes( const TextAttributes &a )
 {
     d->titleTextAttributes = a;
     d->useDefaultTextAttributes = false;
-    setCachedSizeDirty();
-    layoutPlanes();
+    d->updateLayouts();
 }
 
 TextAttributes CartesianAxis::titleTextAttributes() const
@@ -462,8 +471,7 @@ TextAttributes CartesianAxis::titleTextAttributes() const
 void CartesianAxis::resetTitleTextAttributes()
 {
     d->useDefaultTextAttributes = true;
-    setCachedSizeDirty();
-    layoutPlanes();
+    d->updateLayouts();
 }
 
 bool CartesianAxis::hasDefaultTitleTextAttributes() const
@@ -503,6 +511,32 @@ void CartesianAxis::layoutPlanes()
     }
 }
 
+void CartesianAxis::Private::updateLayouts()
+{
+    CartesianAxis* const q = axis();
+    AbstractCoordinatePlane* plane = diagram() ? diagram()->coordinatePlane() : nullptr;
+    if ( !plane ) {
+        cachedMaximumSize = QSize();
+        return;
+    }
+    // an axis that is not part of the planes' layouts yet needs the layouts rebuilt
+    if ( !q->parentLayout() ) {
+        cachedMaximumSize = QSize();
+        q->layoutPlanes();
+        return;
+    }
+    const QSize oldSize = cachedMaximumSize;
+    cachedMaximumSize = QSize();
+    if ( q->maximumSize() == oldSize ) {
+        // the space of planes and axes stays as it is
+        plane->layoutDiagrams();
+        q->update();
+        return;
+    }
+    q->parentLayout()->invalidate();
+    plane->relayout();
+}
+
 static bool referenceDiagramIsBarDiagram( const AbstractDiagram * diagram )
 {
     const AbstractCartesianDiagram * dia =
@@ -655,6 +689,342 @@ bool CartesianAxis::Private::isVertical() const
     return axis()->isAbscissa() == AbstractDiagram::Private::get( diagram() )->isTransposed();
 }
 
+void TickLayoutCache::clear()
+{
+    for ( const Label& label : qAsConst( labels ) ) {
+        delete label.item;
+        delete label.rotatedItem;
+    }
+    labels.clear();
+    ticks.clear();
+    isMeasured = false;
+    isLaidOut = false;
+}
+
+// the label to show at @p tick when every @p thinningFactor'th label is shown, or -1
+static int thinnedLabel( const TickLayoutCache::Tick& tick, int thinningFactor )
+{
+    if ( tick.majorLabelIndex >= 0 && tick.majorLabelIndex % thinningFactor != 0 ) {
+        return -1;
+    }
+    if ( thinningFactor > 1 && tick.shortLabel >= 0 ) {
+        return tick.shortLabel;
+    }
+    return tick.label;
+}
+
+static TickIterator::TickType thinnedLabelType( const TickLayoutCache::Label& label, int thinningFactor )
+{
+    // like TickIterator, treat manual labels as short ones as soon as there is any thinning
+    if ( thinningFactor > 1 && label.type == TickIterator::MajorTickManualLong ) {
+        return TickIterator::MajorTickManualShort;
+    }
+    return label.type;
+}
+
+static QString tickLabelText( const CartesianAxis::Private* axisPriv, const QString& rawText,
+                              TickIterator::TickType type, qreal position, bool isVertical )
+{
+    if ( type == TickIterator::MajorTick ) {
+        // add unit prefixes and suffixes, then customize
+        return axisPriv->customizedLabelText( rawText, isVertical ? Qt::Vertical : Qt::Horizontal, position );
+    } else if ( type == TickIterator::MajorTickHeaderDataLabel ) {
+        // unit prefixes and suffixes have already been added in this case - only customize
+        return axisPriv->axis()->customizedLabel( rawText );
+    }
+    return rawText;
+}
+
+static QPointF tickLabelPosition( const TickLayoutCache* tl, const TickLayoutCache::Label& label, bool rotated )
+{
+    const TextLayoutItem* item = rotated ? label.rotatedItem : label.item;
+    const QSizeF size = rotated ? label.rotatedSize : label.size;
+    const QPolygon labelPoly = item->boundingPolygon();
+    Q_ASSERT( labelPoly.count() == 4 );
+
+    // for alignment, find the label polygon edge "most parallel" and closest to the axis
+
+    int axisAngle = 0;
+    switch ( tl->position ) {
+    case CartesianAxis::Bottom:
+        axisAngle = 0; break;
+    case CartesianAxis::Top:
+        axisAngle = 180; break;
+    case CartesianAxis::Right:
+        axisAngle = 270; break;
+    case CartesianAxis::Left:
+        axisAngle = 90; break;
+    default:
+        Q_ASSERT( false );
+    }
+    // the left axis is not actually pointing down and the top axis not actually pointing
+    // left, but their corresponding closest edges of a rectangular unrotated label polygon are.
+
+    int relAngle = axisAngle - item->textAttributes().rotation() + 45;
+    if ( relAngle < 0 ) {
+        relAngle += 360;
+    }
+    int polyCorner1 = relAngle / 90;
+    QPoint p1 = labelPoly.at( polyCorner1 );
+    QPoint p2 = labelPoly.at( polyCorner1 == 3 ? 0 : ( polyCorner1 + 1 ) );
+
+    QPointF labelPos = tl->ticks.at( label.tick ).tickEnd;
+
+    qreal labelMargin = tl->rulerAttributes.labelMargin();
+    if ( labelMargin < 0 ) {
+        labelMargin = tl->labelFontHeight * 0.5;
+    }
+    labelMargin -= label.margin; // make up for the margin that's already there
+
+    switch ( tl->position ) {
+    case CartesianAxis::Left:
+        labelPos += QPointF( -size.width() - labelMargin,
+                             -0.45 * size.height() - 0.5 * ( p1.y() + p2.y() ) );
+        break;
+    case CartesianAxis::Right:
+        labelPos += QPointF( labelMargin,
+                             -0.45 * size.height() - 0.5 * ( p1.y() + p2.y() ) );
+        break;
+    case CartesianAxis::Top:
+        labelPos += QPointF( -0.45 * size.width() - 0.5 * ( p1.x() + p2.x() ),
+                             -size.height() - labelMargin );
+        break;
+    case CartesianAxis::Bottom:
+        labelPos += QPointF( -0.45 * size.width() - 0.5 * ( p1.x() + p2.x() ),
+                             labelMargin );
+        break;
+    }
+    return labelPos;
+}
+
+TickLayoutCache* CartesianAxis::Private::measuredTicks( CartesianCoordinatePlane* plane ) const
+{
+    if ( !tickLayout ) {
+        tickLayout = new TickLayoutCache;
+    }
+    TickLayoutCache* const tl = tickLayout;
+
+    const bool vertical = isVertical();
+    XySwitch geoXy( vertical );
+    const bool centerTicks = referenceDiagramNeedsCenteredAbscissaTicks( diagram() ) && axis()->isAbscissa();
+    const DataDimensionsList dimensions = plane->gridDimensionsList();
+    const DataDimension dimension = geoXy( dimensions.first(), dimensions.last() );
+    const GridAttributes gridAttributes = plane->gridAttributes( geoXy( Qt::Horizontal, Qt::Vertical ) );
+    const bool fixedRange = geoXy( plane->autoAdjustHorizontalRangeToData(),
+                                   plane->autoAdjustVerticalRangeToData() ) >= 100;
+    const TextAttributes labelTA = mAxis->textAttributes();
+    const qreal fontSize = labelTA.calculatedFontSize( plane->parent(), KChartEnums::MeasureOrientationMinimum );
+    const bool showFirstTick = mAxis->rulerAttributes().showFirstTick();
+
+    bool isValid = tl->isMeasured && tl->dimension == dimension && tl->gridAttributes == gridAttributes &&
+                   tl->fixedRange == fixedRange && tl->textAttributes == labelTA && tl->fontSize == fontSize &&
+                   tl->manualLabels == hardLabels && tl->manualShortLabels == hardShortLabels &&
+                   tl->annotations == annotations && tl->customTicks == customTicksPositions &&
+                   tl->isVertical == vertical && tl->centerTicks == centerTicks &&
+                   tl->showFirstTick == showFirstTick;
+    if ( isValid ) {
+        // the customized texts can depend on diagram state that is not announced, e.g. unit prefixes
+        for ( const TickLayoutCache::Label& label : qAsConst( tl->labels ) ) {
+            const qreal position = tl->ticks.at( label.tick ).position;
+            if ( tickLabelText( this, label.rawText, label.type, position, vertical ) != label.text ) {
+                isValid = false;
+                break;
+            }
+        }
+    }
+    if ( isValid ) {
+        return tl;
+    }
+
+    tl->clear();
+    tl->dimension = dimension;
+    tl->gridAttributes = gridAttributes;
+    tl->fixedRange = fixedRange;
+    tl->textAttributes = labelTA;
+    tl->fontSize = fontSize;
+    tl->manualLabels = hardLabels;
+    tl->manualShortLabels = hardShortLabels;
+    tl->annotations = annotations;
+    tl->customTicks = customTicksPositions;
+    tl->isVertical = vertical;
+    tl->centerTicks = centerTicks;
+    tl->showFirstTick = showFirstTick;
+    tl->hasShorterLabels = !hardLabels.isEmpty() && hardShortLabels.count() == hardLabels.count();
+    tl->isMeasured = true;
+
+    QObject* const refArea = plane->parent();
+    const auto addLabel = [&]( int tick, TickIterator::TickType type, const QString& rawText ) -> int {
+        TickLayoutCache::Label label;
+        label.tick = tick;
+        label.type = type;
+        label.rawText = rawText;
+        label.text = tickLabelText( this, rawText, type, tl->ticks.at( tick ).position, vertical );
+        label.item = new TextLayoutItem( label.text, labelTA, refArea,
+                                         KChartEnums::MeasureOrientationMinimum, Qt::AlignLeft );
+        label.rotatedItem = nullptr;
+        label.size = label.item->sizeHint();
+        label.margin = label.item->marginWidth();
+        if ( tl->labels.isEmpty() ) {
+            tl->labelFontHeight = QFontMetricsF( label.item->realFont() ).height();
+        }
+        tl->labels.append( label );
+        return tl->labels.count() - 1;
+    };
+
+    // one walk without label thinning; the labels remaining after thinning are a subset of these.
+    bool skipFirstTick = !showFirstTick;
+    for ( TickIterator it( axis(), plane, 1, centerTicks ); !it.isAtEnd(); ++it ) {
+        if ( skipFirstTick ) {
+            skipFirstTick = false;
+            continue;
+        }
+        TickLayoutCache::Tick tick;
+        tick.position = it.position();
+        tick.type = it.type();
+        tick.majorLabelIndex = it.majorLabelIndex();
+        tick.label = -1;
+        tick.shortLabel = -1;
+        tl->ticks.append( tick );
+        if ( labelTA.isVisible() && !it.text().isEmpty() ) {
+            tl->ticks.last().label = addLabel( tl->ticks.count() - 1, it.type(), it.text() );
+        }
+    }
+
+    // manual labels are not decimated but replaced with their short variant when thinning, which
+    // depends only on the running index of the manual label. one more walk picks those up.
+    if ( tl->hasShorterLabels && labelTA.isVisible() ) {
+        int tickIndex = 0;
+        skipFirstTick = !showFirstTick;
+        for ( TickIterator it( axis(), plane, 2, centerTicks );
+              !it.isAtEnd() && tickIndex < tl->ticks.count(); ++it ) {
+            if ( skipFirstTick ) {
+                skipFirstTick = false;
+                continue;
+            }
+            if ( it.type() == TickIterator::MajorTickManualShort && !it.text().isEmpty() ) {
+                tl->ticks[ tickIndex ].shortLabel = addLabel( tickIndex, it.type(), it.text() );
+            }
+            tickIndex++;
+        }
+    }
+    return tl;
+}
+
+TickLayoutCache* CartesianAxis::Private::laidOutTicks( CartesianCoordinatePlane* plane, qreal transversePosition,
+                                                       qreal transverseScreenSpaceShift, const QPointF& axisStart,
+                                                       const QPointF& axisEnd ) const
+{
+    TickLayoutCache* const tl = measuredTicks( plane );
+    const RulerAttributes rulerAttr = mAxis->rulerAttributes();
+    if ( tl->isLaidOut && tl->axisStart == axisStart && tl->axisEnd == axisEnd && tl->position == position &&
+         tl->rulerAttributes == rulerAttr && tl->customTickLength == customTickLength ) {
+        return tl;
+    }
+    tl->axisStart = axisStart;
+    tl->axisEnd = axisEnd;
+    tl->position = position;
+    tl->rulerAttributes = rulerAttr;
+    tl->customTickLength = customTickLength;
+    tl->isLaidOut = true;
+
+    XySwitch geoXy( tl->isVertical );
+    const bool isOutwardsPositive = position == Bottom || position == Right;
+
+    for ( TickLayoutCache::Tick& tick : tl->ticks ) {
+        const qreal drawPos = tick.position + ( tl->centerTicks ? 0.5 : 0. );
+        QPointF onAxis = plane->translate( geoXy( QPointF( drawPos, transversePosition ) ,
+                                                  QPointF( transversePosition, drawPos ) ) );
+        geoXy.lvalue( onAxis.ry(), onAxis.rx() ) += transverseScreenSpaceShift;
+
+        QPointF tickEnd = onAxis;
+        qreal tickLen = tick.type == TickIterator::CustomTick ?
+                        customTickLength : axis()->tickLength( tick.type == TickIterator::MinorTick );
+        geoXy.lvalue( tickEnd.ry(), tickEnd.rx() ) += isOutwardsPositive ? tickLen : -tickLen;
+
+        // those adjustments are required to paint the ticks exactly on the axis and of the right length
+        if ( position == Top ) {
+            onAxis.ry() += 1;
+            tickEnd.ry() += 1;
+        } else if ( position == Left ) {
+            tickEnd.rx() += 1;
+        }
+        tick.onAxis = onAxis;
+        tick.tickEnd = tickEnd;
+    }
+
+    for ( TickLayoutCache::Label& label : tl->labels ) {
+        label.pos = tickLabelPosition( tl, label, false );
+        if ( label.rotatedItem ) {
+            label.rotatedPos = tickLabelPosition( tl, label, true );
+        }
+    }
+
+    // Choose the label thinning factor and rotation by checking the cached label geometry for
+    // collisions between neighboring labels. This reproduces what a full layout pass with each
+    // candidate thinning factor would do, but without walking the ticks or measuring text again.
+
+    // like in the old code, we don't shorten or decimate labels if they are already the
+    // manual short type, or if they are the manual long type and on the vertical axis
+    // ### they can still collide though, especially when they're rotated!
+    const TextAttributes& labelTA = tl->textAttributes;
+    const int spaceSavingRotation = geoXy( 270, 0 );
+    const bool mayRotate = labelTA.autoRotate() && labelTA.rotation() != spaceSavingRotation;
+    tl->labelThinningFactor = 1;
+    tl->labelsRotated = false;
+    while ( tl->labelThinningFactor <= tl->ticks.count() ) {
+        const bool canRotate = mayRotate && !tl->labelsRotated;
+        bool collides = false;
+        bool canShortenLabels = false;
+        int prevLabel = -1;
+        for ( const TickLayoutCache::Tick& tick : qAsConst( tl->ticks ) ) {
+            const int labelIndex = thinnedLabel( tick, tl->labelThinningFactor );
+            if ( labelIndex < 0 ) {
+                continue;
+            }
+            const TickLayoutCache::Label& label = tl->labels.at( labelIndex );
+            const TickIterator::TickType type = thinnedLabelType( label, tl->labelThinningFactor );
+            canShortenLabels = !geoXy.isY && type == TickIterator::MajorTickManualLong &&
+                               tl->hasShorterLabels;
+            if ( type != TickIterator::MajorTick && type != TickIterator::MajorTickHeaderDataLabel &&
+                 !canShortenLabels && !canRotate ) {
+                continue;
+            }
+            if ( prevLabel >= 0 ) {
+                const TickLayoutCache::Label& prev = tl->labels.at( prevLabel );
+                if ( tl->labelsRotated ) {
+                    collides = label.rotatedItem->intersects( *prev.rotatedItem, label.rotatedPos, prev.rotatedPos );
+                } else {
+                    collides = label.item->intersects( *prev.item, label.pos, prev.pos );
+                }
+                if ( collides ) {
+                    break;
+                }
+            }
+            prevLabel = labelIndex;
+        }
+        if ( !collides ) {
+            break;
+        }
+        // to make room, we try in order: shorten, rotate, decimate
+        if ( canRotate && !canShortenLabels ) {
+            TextAttributes rotatedTA = labelTA;
+            rotatedTA.setRotation( spaceSavingRotation );
+            for ( TickLayoutCache::Label& label : tl->labels ) {
+                if ( !label.rotatedItem ) {
+                    label.rotatedItem = new TextLayoutItem( label.text, rotatedTA, plane->parent(),
+                                                            KChartEnums::MeasureOrientationMinimum, Qt::AlignLeft );
+                    label.rotatedSize = label.rotatedItem->sizeHint();
+                }
+                label.rotatedPos = tickLabelPosition( tl, label, true );
+            }
+            tl->labelsRotated = true;
+        } else {
+            tl->labelThinningFactor++;
+        }
+    }
+    return tl;
+}
+
 void CartesianAxis::paintCtx( PaintContext* context )
 {
     Q_ASSERT_X ( d->diagram(), "CartesianAxis::paint",
@@ -670,8 +1040,7 @@ void CartesianAxis::paintCtx( PaintContext* context )
         return;
     }
 
-    const bool centerTicks = referenceDiagramNeedsCenteredAbscissaTicks( d->diagram() ) && isAbscissa();
-
+    const PerfPhaseTimer perfTimer( PerfObserver::AxisPaintPhase, this );
     XySwitch geoXy( d->isVertical() );
 
     QPainter* const painter = context->painter();
@@ -682,6 +1051,8 @@ void CartesianAxis::paintCtx( PaintContext* context )
     // the next one describes an additional shift in screen space; it is unfortunately required to
     // make axis sharing work, which uses the areaGeometry() to override the position of the axis.
     qreal transverseScreenSpaceShift = signalingNaN;
+    QPointF axisStart;
+    QPointF axisEnd;
     {
         // determine the unadulterated position in screen space
 
@@ -732,6 +1103,8 @@ void CartesianAxis::paintCtx( PaintContext* context )
 
         geoXy.lvalue( transStart.ry(), transStart.rx() ) += transverseScreenSpaceShift;
         geoXy.lvalue( transEnd.ry(), transEnd.rx() ) += transverseScreenSpaceShift;
+        axisStart = transStart;
+        axisEnd = transEnd;
 
         if ( rulerAttributes().showRulerLine() ) {
             painter->save();
@@ -744,183 +1117,32 @@ void CartesianAxis::paintCtx( PaintContext* context )
 
     // paint ticks and labels
 
-    TextAttributes labelTA = textAttributes();
-    RulerAttributes rulerAttr = rulerAttributes();
-
-    int labelThinningFactor = 1;
-    // TODO: label thinning also when grid line distance < 4 pixels, not only when labels collide
-    TextLayoutItem *tickLabel = new TextLayoutItem( QString(), labelTA, plane->parent(),
-                                                    KChartEnums::MeasureOrientationMinimum, Qt::AlignLeft );
-    TextLayoutItem *prevTickLabel = new TextLayoutItem( QString(), labelTA, plane->parent(),
-                                                        KChartEnums::MeasureOrientationMinimum, Qt::AlignLeft );
-    QPointF prevTickLabelPos;
-    enum {
-        Layout = 0,
-        Painting,
-        Done
-    };
-    for ( int step = labelTA.isVisible() ? Layout : Painting; step < Done; step++ ) {
-        bool skipFirstTick = !rulerAttr.showFirstTick();
-        bool isFirstLabel = true;
-        for ( TickIterator it( this, plane, labelThinningFactor, centerTicks ); !it.isAtEnd(); ++it ) {
-            if ( skipFirstTick ) {
-                skipFirstTick = false;
-                continue;
-            }
-
-            const qreal drawPos = it.position() + ( centerTicks ? 0.5 : 0. );
-            QPointF onAxis = plane->translate( geoXy( QPointF( drawPos, transversePosition ) ,
-                                                      QPointF( transversePosition, drawPos ) ) );
-            geoXy.lvalue( onAxis.ry(), onAxis.rx() ) += transverseScreenSpaceShift;
-            const bool isOutwardsPositive = position() == Bottom || position() == Right;
-
-            // paint the tick mark
-
-            QPointF tickEnd = onAxis;
-            qreal tickLen = it.type() == TickIterator::CustomTick ?
-                            d->customTickLength : tickLength( it.type() == TickIterator::MinorTick );
-            geoXy.lvalue( tickEnd.ry(), tickEnd.rx() ) += isOutwardsPositive ? tickLen : -tickLen;
-
-            // those adjustments are required to paint the ticks exactly on the axis and of the right length
-            if ( position() == Top ) {
-                onAxis.ry() += 1;
-                tickEnd.ry() += 1;
-            } else if ( position() == Left ) {
-                tickEnd.rx() += 1;
-            }
-
-            if ( step == Painting ) {
-                painter->save();
-                if ( rulerAttr.hasTickMarkPenAt( it.position() ) ) {
-                    painter->setPen( rulerAttr.tickMarkPen( it.position() ) );
-                } else {
-                    painter->setPen( it.type() == TickIterator::MinorTick ? rulerAttr.minorTickMarkPen()
-                                                                          : rulerAttr.majorTickMarkPen() );
-                }
-                painter->drawLine( onAxis, tickEnd );
-                painter->restore();
-            }
-
-            if ( it.text().isEmpty() || !labelTA.isVisible() ) {
-                // the following code in the loop is only label painting, so skip it
-                continue;
-            }
-
-            // paint the label
-
-            QString text = it.text();
-            if ( it.type() == TickIterator::MajorTick ) {
-                // add unit prefixes and suffixes, then customize
-                text = d->customizedLabelText( text, geoXy( Qt::Horizontal, Qt::Vertical ), it.position() );
-            } else if ( it.type() == TickIterator::MajorTickHeaderDataLabel ) {
-                // unit prefixes and suffixes have already been added in this case - only customize
-                text = customizedLabel( text );
-            }
-
-            tickLabel->setText( text );
-            QSizeF size = QSizeF( tickLabel->sizeHint() );
-            QPolygon labelPoly = tickLabel->boundingPolygon();
-            Q_ASSERT( labelPoly.count() == 4 );
-
-            // for alignment, find the label polygon edge "most parallel" and closest to the axis
-
-            int axisAngle = 0;
-            switch ( position() ) {
-            case Bottom:
-                axisAngle = 0; break;
-            case Top:
-                axisAngle = 180; break;
-            case Right:
-                axisAngle = 270; break;
-            case Left:
-                axisAngle = 90; break;
-            default:
-                Q_ASSERT( false );
-            }
-            // the left axis is not actually pointing down and the top axis not actually pointing
-            // left, but their corresponding closest edges of a rectangular unrotated label polygon are.
-
-            int relAngle = axisAngle - labelTA.rotation() + 45;
-            if ( relAngle < 0 ) {
-                relAngle += 360;
-            }
-            int polyCorner1 = relAngle / 90;
-            QPoint p1 = labelPoly.at( polyCorner1 );
-            QPoint p2 = labelPoly.at( polyCorner1 == 3 ? 0 : ( polyCorner1 + 1 ) );
-
-            QPointF labelPos = tickEnd;
-
-            qreal labelMargin = rulerAttr.labelMargin();
-            if ( labelMargin < 0 ) {
-                labelMargin = QFontMetricsF( tickLabel->realFont() ).height() * 0.5;
-            }
-            labelMargin -= tickLabel->marginWidth(); // make up for the margin that's already there
-
-            switch ( position() ) {
-            case Left:
-                labelPos += QPointF( -size.width() - labelMargin,
-                                     -0.45 * size.height() - 0.5 * ( p1.y() + p2.y() ) );
-                break;
-            case Right:
-                labelPos += QPointF( labelMargin,
-                                     -0.45 * size.height() - 0.5 * ( p1.y() + p2.y() ) );
-                break;
-            case Top:
-                labelPos += QPointF( -0.45 * size.width() - 0.5 * ( p1.x() + p2.x() ),
-                                     -size.height() - labelMargin );
-                break;
-            case Bottom:
-                labelPos += QPointF( -0.45 * size.width() - 0.5 * ( p1.x() + p2.x() ),
-                                     labelMargin );
-                break;
-            }
-
-            tickLabel->setGeometry( QRect( labelPos.toPoint(), size.toSize() ) );
+    const TickLayoutCache* tl = d->laidOutTicks( plane, transversePosition, transverseScreenSpaceShift,
+                                                 axisStart, axisEnd );
+    const RulerAttributes rulerAttr = rulerAttributes();
 
-            if ( step == Painting ) {
-                tickLabel->paint( painter );
-            }
+    for ( const TickLayoutCache::Tick& tick : tl->ticks ) {
+        painter->save();
+        if ( rulerAttr.hasTickMarkPenAt( tick.position ) ) {
+            painter->setPen( rulerAttr.tickMarkPen( tick.position ) );
+        } else {
+            painter->setPen( tick.type == TickIterator::MinorTick ? rulerAttr.minorTickMarkPen()
+                                                                  : rulerAttr.majorTickMarkPen() );
+        }
+        painter->drawLine( tick.onAxis, tick.tickEnd );
+        painter->restore();
 
-            // collision check the current label against the previous one
-
-            // like in the old code, we don't shorten or decimate labels if they are already the
-            // manual short type, or if they are the manual long type and on the vertical axis
-            // ### they can still collide though, especially when they're rotated!
-            if ( step == Layout ) {
-                int spaceSavingRotation = geoXy( 270, 0 );
-                bool canRotate = labelTA.autoRotate() && labelTA.rotation() != spaceSavingRotation;
-                const bool canShortenLabels = !geoXy.isY && it.type() == TickIterator::MajorTickManualLong &&
-                                              it.hasShorterLabels();
-                bool collides = false;
-                if ( it.type() == TickIterator::MajorTick || it.type() == TickIterator::MajorTickHeaderDataLabel
-                     || canShortenLabels || canRotate ) {
-                    if ( isFirstLabel ) {
-                        isFirstLabel = false;
-                    } else {
-                        collides = tickLabel->intersects( *prevTickLabel, labelPos, prevTickLabelPos );
-                        qSwap( prevTickLabel, tickLabel );
-                    }
-                    prevTickLabelPos = labelPos;
-                }
-                if ( collides ) {
-                    // to make room, we try in order: shorten, rotate, decimate
-                    if ( canRotate && !canShortenLabels ) {
-                        labelTA.setRotation( spaceSavingRotation );
-                        // tickLabel will be reused in the next round
-                        tickLabel->setTextAttributes( labelTA );
-                    } else {
-                        labelThinningFactor++;
-                    }
-                    step--; // relayout
-                    break;
-                }
-            }
+        const int labelIndex = thinnedLabel( tick, tl->labelThinningFactor );
+        if ( labelIndex < 0 ) {
+            continue;
         }
+        const TickLayoutCache::Label& label = tl->labels.at( labelIndex );
+        TextLayoutItem* const tickLabel = tl->labelsRotated ? label.rotatedItem : label.item;
+        const QPointF labelPos = tl->labelsRotated ? label.rotatedPos : label.pos;
+        const QSize size = tl->labelsRotated ? label.rotatedSize : label.size;
+        tickLabel->setGeometry( QRect( labelPos.toPoint(), size ) );
+        tickLabel->paint( painter );
     }
-    delete tickLabel;
-    tickLabel = nullptr;
-    delete prevTickLabel;
-    prevTickLabel = nullptr;
 
     if ( ! titleText().isEmpty() ) {
         d->drawTitleText( painter, plane, geometry() );
@@ -999,36 +1221,21 @@ QSize CartesianAxis::Private::calculateMaximumSize() const
         qreal lowestLabelLongitudinalSize = signalingNaN;
         qreal highestLabelLongitudinalSize = signalingNaN;
 
-        TextLayoutItem tickLabel( QString(), mAxis->textAttributes(), refArea,
-                                  KChartEnums::MeasureOrientationMinimum, Qt::AlignLeft );
+        const TickLayoutCache* tl = measuredTicks( plane );
         const RulerAttributes rulerAttr = mAxis->rulerAttributes();
 
-        bool showFirstTick = rulerAttr.showFirstTick();
-        for ( TickIterator it( axis(), plane, 1, centerTicks ); !it.isAtEnd(); ++it ) {
-            const qreal drawPos = it.position() + ( centerTicks ? 0.5 : 0. );
-            if ( !showFirstTick ) {
-                showFirstTick = true;
-                continue;
-            }
+        for ( const TickLayoutCache::Tick& tick : tl->ticks ) {
+            const qreal drawPos = tick.position + ( centerTicks ? 0.5 : 0. );
 
             qreal labelSizeTransverse = 0.0;
             qreal labelMargin = 0.0;
-            QString text = it.text();
-            if ( !text.isEmpty() ) {
+            if ( tick.label >= 0 ) {
+                const TickLayoutCache::Label& label = tl->labels.at( tick.label );
                 QPointF labelPosition = plane->translate( QPointF( geoXy( drawPos, qreal(1.0) ),
                                                                    geoXy( qreal(1.0), drawPos ) ) );
                 highestLabelPosition = geoXy( labelPosition.x(), labelPosition.y() );
 
-                if ( it.type() == TickIterator::MajorTick ) {
-                    // add unit prefixes and suffixes, then customize
-                    text = customizedLabelText( text, geoXy( Qt::Horizontal, Qt::Vertical ), it.position() );
-                } else if ( it.type() == TickIterator::MajorTickHeaderDataLabel ) {
-                    // unit prefixes and suffixes have already been added in this case - only customize
-                    text = axis()->customizedLabel( text );
-                }
-                tickLabel.setText( text );
-
-                QSize sz = tickLabel.sizeHint();
+                const QSize sz = label.size;
                 highestLabelLongitudinalSize = geoXy( sz.width(), sz.height() );
                 if ( ISNAN( lowestLabelLongitudinalSize ) ) {
                     lowestLabelLongitudinalSize = highestLabelLongitudinalSize;
@@ -1038,12 +1245,12 @@ QSize CartesianAxis::Private::calculateMaximumSize() const
                 labelSizeTransverse = geoXy( sz.height(), sz.width() );
                 labelMargin = rulerAttr.labelMargin();
                 if ( labelMargin < 0 ) {
-                    labelMargin = QFontMetricsF( tickLabel.realFont() ).height() * 0.5;
+                    labelMargin = tl->labelFontHeight * 0.5;
                 }
-                labelMargin -= tickLabel.marginWidth(); // make up for the margin that's already there
+                labelMargin -= label.margin; // make up for the margin that's already there
             }
-            qreal tickLength = it.type() == TickIterator::CustomTick ?
-                               customTickLength : axis()->tickLength( it.type() == TickIterator::MinorTick );
+            qreal tickLength = tick.type == TickIterator::CustomTick ?
+                               customTickLength : axis()->tickLength( tick.type == TickIterator::MinorTick );
             size = qMax( size, tickLength + labelMargin + labelSizeTransverse );
         }
 
@@ -1114,8 +1321,7 @@ void CartesianAxis::setCustomTickLength( int value )
         return;
     }
     d->customTickLength = value;
-    setCachedSizeDirty();
-    layoutPlanes();
+    d->updateLayouts();
 }
 
 int CartesianAxis::customTickLength() const
@@ -1140,8 +1346,7 @@ void CartesianAxis::setAnnotations( const QMap< qreal, QString >& annotations )
         return;
 
     d->annotations = annotations;
-    setCachedSizeDirty();
-    layoutPlanes();
+    d->updateLayouts();
 }
 
 QList< qreal > CartesianAxis::customTicks() const
@@ -1155,8 +1360,7 @@ void CartesianAxis::setCustomTicks( const QList< qreal >& customTicksPositions )
         return;
 
     d->customTicksPositions = customTicksPositions;
-    setCachedSizeDirty();
-    layoutPlanes();
+    d->updateLayouts();
 }
 
 #if !defined(QT_NO_DEBUG_STREAM)
@@ -34,11 +34,17 @@
 #include "KChartCartesianAxis.h"
 #include "KChartAbstractCartesianDiagram.h"
 #include "KChartAbstractAxis_p.h"
+#include "KChartGridAttributes.h"
+#include "KChartLayoutItems.h"
 #include "KChartMath_p.h"
 
+#include <QVector>
+
 
 namespace KChart {
 
+class TickLayoutCache;
+
 /**
   * \internal
   */
@@ -54,8 +60,9 @@ public:
         , cachedLabelHeight( 0.0 )
         , cachedFontHeight( 0 )
         , axisTitleSpace( 1.0 )
+        , tickLayout( nullptr )
     {}
-    ~Private() {}
+    ~Private();
 
     static const Private *get( const CartesianAxis *axis ) { return axis->d_func(); };
 
@@ -65,6 +72,17 @@ public:
     QSize calculateMaximumSize() const;
     QString customizedLabelText( const QString& text, Qt::Orientation orientation, qreal value ) const;
     bool isVertical() const;
+    TickLayoutCache* measuredTicks( CartesianCoordinatePlane* plane ) const;
+    TickLayoutCache* laidOutTicks( CartesianCoordinatePlane* plane, qreal transversePosition,
+                                   qreal transverseScreenSpaceShift, const QPointF& axisStart,
+                                   const QPointF& axisEnd ) const;
+    /**
+     * Re-lays out the chart after a change that may change the size of the axis, but not its
+     * place among the planes. If the size turns out unchanged, only the diagrams are laid out
+     * again; otherwise the layouts above the axis are invalidated and run again, without
+     * rebuilding them as layoutPlanes() does.
+     */
+    void updateLayouts() override;
 
     QMap< qreal, QString > annotations;
 
@@ -84,6 +102,7 @@ private:
     mutable int cachedFontWidth;
     mutable QSize cachedMaximumSize;
     qreal axisTitleSpace;
+    mutable TickLayoutCache* tickLayout;
 };
 
 inline CartesianAxis::CartesianAxis( Private * p, AbstractDiagram* diagram )
@@ -136,6 +155,8 @@ public:
     qreal position() const { return m_position; }
     QString text() const { return m_text; }
     TickType type() const { return m_type; }
+    // the index of the current label among those subject to label thinning, or -1
+    int majorLabelIndex() const { return m_majorLabelIndex; }
     bool hasShorterLabels() const { return m_axis && !m_axis->labels().isEmpty() &&
                                     m_axis->shortLabels().count() == m_axis->labels().count(); }
     bool isAtEnd() const { return m_position == std::numeric_limits< qreal >::infinity(); }
@@ -165,6 +186,7 @@ private:
     // these generally change in operator++(), i.e. from one label to the next
     int m_customTickIndex;
     int m_manualLabelIndex;
+    int m_majorLabelIndex;
     TickType m_type;
     qreal m_position;
     qreal m_customTick;
@@ -173,6 +195,98 @@ private:
     QString m_text;
 };
 
+/**
+  * \internal
+  *
+  * The result of walking the ticks of a CartesianAxis and measuring their labels, plus the
+  * screen space layout and label thinning derived from that. CartesianAxis keeps one of these
+  * between paints and layouts, re-measuring only when the inputs of the walk change and
+  * re-laying out only when the axis moves on screen.
+  */
+class TickLayoutCache
+{
+    Q_DISABLE_COPY( TickLayoutCache )
+public:
+    struct Tick {
+        qreal position; // in data space
+        TickIterator::TickType type;
+        int majorLabelIndex; // see TickIterator::majorLabelIndex()
+        int label; // index into labels, -1 if none
+        int shortLabel; // index into labels of the short variant used when thinning, -1 if none
+        QPointF onAxis;
+        QPointF tickEnd;
+    };
+
+    struct Label {
+        int tick; // index into ticks
+        TickIterator::TickType type;
+        QString rawText; // as returned by TickIterator, before customization
+        QString text;
+        TextLayoutItem* item;
+        TextLayoutItem* rotatedItem; // created on demand when auto-rotating
+        QSize size;
+        QSize rotatedSize;
+        int margin;
+        QPointF pos;
+        QPointF rotatedPos;
+    };
+
+    TickLayoutCache()
+        : isMeasured( false )
+        , fontSize( 0.0 )
+        , fixedRange( false )
+        , isVertical( false )
+        , centerTicks( false )
+        , showFirstTick( true )
+        , isLaidOut( false )
+        , position( CartesianAxis::Bottom )
+        , customTickLength( 0 )
+        , hasShorterLabels( false )
+        , labelFontHeight( 0.0 )
+        , labelThinningFactor( 1 )
+        , labelsRotated( false )
+    {}
+    ~TickLayoutCache() { clear(); }
+
+    void clear();
+
+    // inputs of the tick walk and label measurement
+    bool isMeasured;
+    DataDimension dimension;
+    GridAttributes gridAttributes;
+    TextAttributes textAttributes;
+    qreal fontSize;
+    QStringList manualLabels;
+    QStringList manualShortLabels;
+    QMap< qreal, QString > annotations;
+    QList< qreal > customTicks;
+    bool fixedRange;
+    bool isVertical;
+    bool centerTicks;
+    bool showFirstTick;
+
+    // inputs of the screen space layout
+    bool isLaidOut;
+    QPointF axisStart;
+    QPointF axisEnd;
+    CartesianAxis::Position position;
+    RulerAttributes rulerAttributes;
+    int customTickLength;
+
+    // results
+    QVector< Tick > ticks;
+    QVector< Label > labels;
+    bool hasShorterLabels;
+    qreal labelFontHeight;
+    int labelThinningFactor;
+    bool labelsRotated;
+};
+
+inline CartesianAxis::Private::~Private()
+{
+    delete tickLayout;
+}
+
 }
 
 #endif
@@ -23,10 +23,12 @@
 #include "KChartAbstractDiagram.h"
 #include "KChartAbstractDiagram_p.h"
 #include "KChartAbstractCartesianDiagram.h"
+#include "KChartAbstractCartesianDiagram_p.h"
 #include "CartesianCoordinateTransformation.h"
 #include "KChartGridAttributes.h"
 #include "KChartPaintContext.h"
 #include "KChartPainterSaver_p.h"
+#include "KChartPerfObserver_p.h"
 #include "KChartBarDiagram.h"
 #include "KChartStockDiagram.h"
 
@@ -38,7 +40,6 @@
 #include <QTime>
 #include <QElapsedTimer>
 
-
 using namespace KChart;
 
 #define d d_func()
@@ -60,6 +61,7 @@ CartesianCoordinatePlane::Private::Private()
     , xAxisStartAtZero( true )
     , reverseVerticalPlane( false )
     , reverseHorizontalPlane( false )
+    , hasCustomTranslate( false )
 {
 }
 
@@ -93,6 +95,31 @@ void CartesianCoordinatePlane::addDiagram( AbstractDiagram* diagram )
 }
 
 
+void CartesianCoordinatePlane::Private::paintDiagram( AbstractDiagram* diagram, PaintContext* ctx )
+{
+    // count the data lookups of the compressor during painting
+    const CartesianDiagramDataCompressor* compressor = nullptr;
+    if ( PerfObserver::observer() ) {
+        if ( AbstractCartesianDiagram* cartesianDiagram = qobject_cast< AbstractCartesianDiagram* >( diagram ) ) {
+            compressor = &static_cast< AbstractCartesianDiagram::Private* >(
+                AbstractDiagram::Private::get( cartesianDiagram ) )->compressor;
+            compressor->resetCacheStatistics();
+        }
+    }
+
+    {
+        const PerfPhaseTimer perfTimer( PerfObserver::DiagramPaintPhase, diagram );
+        diagram->paint( ctx );
+    }
+
+    if ( compressor ) {
+        perfReportCounter( PerfObserver::DataLookupsCounter, diagram,
+                           compressor->cacheHits() + compressor->cacheMisses() );
+        perfReportCounter( PerfObserver::CacheHitsCounter, diagram, compressor->cacheHits() );
+        perfReportCounter( PerfObserver::CacheMissesCounter, diagram, compressor->cacheMisses() );
+    }
+}
+
 void CartesianCoordinatePlane::paint( QPainter* painter )
 {
     // prevent recursive call:
@@ -109,6 +136,7 @@ void CartesianCoordinatePlane::paint( QPainter* painter )
         ctx.setCoordinatePlane ( this );
         const QRectF drawArea( drawingArea() );
         ctx.setRectangle ( drawArea );
+        ctx.setExposedRect( d->exposedRect );
 
         // enabling clipping so that we're not drawing outside
         PainterSaver painterSaver( painter );
@@ -125,14 +153,22 @@ void CartesianCoordinatePlane::paint( QPainter* painter )
             if ( diags[i]->isHidden() ) {
                 continue;
             }
+            // painted ahead of time by DiagramLayers, if parallel painting is enabled
+            const DiagramLayer layer = d->diagramLayers.take( diags[i] );
+            if ( !layer.image.isNull() && layer.transform == painter->transform() ) {
+                painter->drawImage( layer.rect.topLeft(), layer.image );
+                continue;
+            }
             bool doDumpPaintTime = AbstractDiagram::Private::get( diags[ i ] )->doDumpPaintTime;
             QElapsedTimer stopWatch;
             if ( doDumpPaintTime ) {
                 stopWatch.start();
             }
 
-            PainterSaver diagramPainterSaver( painter );
-            diags[i]->paint( &ctx );
+            {
+                PainterSaver diagramPainterSaver( painter );
+                Private::paintDiagram( diags[i], &ctx );
+            }
 
             if ( doDumpPaintTime ) {
                 qDebug() << "Painting diagram" << i << "took" << stopWatch.elapsed() << "milliseconds";
@@ -140,6 +176,7 @@ void CartesianCoordinatePlane::paint( QPainter* painter )
         }
 
     }
+    d->diagramLayers.clear();
     d->bPaintIsRunning = false;
 }
 
@@ -458,6 +495,31 @@ const QPointF CartesianCoordinatePlane::translate( const QPointF& diagramPoint )
     return d->coordinateTransformation.translate( diagramPoint );
 }
 
+void CartesianCoordinatePlane::setHasCustomTranslate( bool custom )
+{
+    d->hasCustomTranslate = custom;
+}
+
+void CartesianCoordinatePlane::translate( const qreal* keys, const qreal* values, int count,
+                                          QPointF* points ) const
+{
+    if ( !d->hasCustomTranslate ) {
+        d->coordinateTransformation.translate( keys, values, count, points );
+        return;
+    }
+    for ( int i = 0; i < count; ++i ) {
+        points[ i ] = translate( QPointF( keys[ i ], values[ i ] ) );
+    }
+}
+
+QPolygonF CartesianCoordinatePlane::translate( const QVector< qreal >& keys, const QVector< qreal >& values ) const
+{
+    Q_ASSERT( keys.count() == values.count() );
+    QPolygonF points( qMin( keys.count(), values.count() ) );
+    translate( keys.constData(), values.constData(), points.count(), points.data() );
+    return points;
+}
+
 const QPointF CartesianCoordinatePlane::translateBack( const QPointF& screenPoint ) const
 {
     return d->coordinateTransformation.translateBack( screenPoint );
@@ -22,6 +22,9 @@
 
 #include "KChartAbstractCoordinatePlane.h"
 
+#include <QPolygonF>
+#include <QVector>
+
 namespace KChart {
 
     class Chart;
@@ -60,6 +63,22 @@ namespace KChart {
 
         const QPointF translate ( const QPointF& diagramPoint ) const override;
 
+        /**
+         * Translates \a count diagram points, given as their \a keys (x) and \a values (y),
+         * and stores the results in \a points. The result is the same as that of calling
+         * translate() for each point, but much faster for large numbers of points.
+         *
+         * \note Subclasses that reimplement translate( const QPointF& ) have to call
+         * setHasCustomTranslate(), then this calls their reimplementation for each point.
+         */
+        void translate( const qreal* keys, const qreal* values, int count, QPointF* points ) const;
+
+        /**
+         * \overload
+         * \return The translated points, \a keys and \a values need to have the same size.
+         */
+        QPolygonF translate( const QVector< qreal >& keys, const QVector< qreal >& values ) const;
+
         /**
          * \sa setZoomFactorX, setZoomCenter
          */
@@ -484,6 +503,13 @@ namespace KChart {
 
         void handleFixedDataCoordinateSpaceRelation( const QRectF& geometry );
 
+        /**
+         * Subclasses that reimplement translate( const QPointF& ) need to call this with
+         * \a custom set to true, typically in their constructor. Otherwise the batch
+         * translate() maps all the points at once, without calling the reimplementation.
+         */
+        void setHasCustomTranslate( bool custom );
+
         // reimplemented from QLayoutItem, via AbstractLayoutItem, AbstractArea, AbstractCoordinatePlane
         bool hasHeightForWidth() const override;
         int heightForWidth( int w ) const override;
@@ -31,10 +31,13 @@
 // We mean it.
 //
 
+#include <QHash>
+
 #include "KChartAbstractCoordinatePlane_p.h"
 #include "CartesianCoordinateTransformation.h"
 #include "KChartCartesianGrid.h"
 #include "KChartZoomParameters.h"
+#include "KChartDiagramLayers_p.h"
 
 #include "KChartMath_p.h"
 
@@ -64,6 +67,22 @@ public:
         return static_cast< Private * >( plane->d_func() );
     }
 
+    // the rectangle the diagrams are painted in, for painting them outside of paint()
+    static QRectF diagramDrawingArea( const CartesianCoordinatePlane* plane )
+    {
+        return plane->drawingArea();
+    }
+
+    // the rectangle the diagrams are clipped to when painting
+    static QRect diagramClipRect( const QRectF& drawingArea )
+    {
+        return drawingArea.toRect().adjusted( -1, -1, 1, 1 );
+    }
+
+    // paints one diagram, reporting the time it took and its lookups in the data
+    // compressor to the PerfObserver; for paint() and DiagramLayers
+    static void paintDiagram( AbstractDiagram* diagram, PaintContext* ctx );
+
     bool isVisiblePoint( const AbstractCoordinatePlane * plane, const QPointF& point ) const override
     {
         QPointF p = point;
@@ -86,6 +105,10 @@ public:
     CoordinateTransformation coordinateTransformation;
 
     bool bPaintIsRunning;
+    // diagrams painted ahead by DiagramLayers, to be composited by the next paint()
+    QHash< const AbstractDiagram*, DiagramLayer > diagramLayers;
+    // the part of the chart being repainted, set by Chart while it paints; invalid for all
+    QRect exposedRect;
 
     // true after setGridAttributes( Qt::Orientation ) was used,
     // false if resetGridAttributes( Qt::Orientation ) was called
@@ -131,6 +154,9 @@ public:
 
     bool reverseVerticalPlane;
     bool reverseHorizontalPlane;
+
+    // whether a subclass reimplements translate( const QPointF& ), see setHasCustomTranslate()
+    bool hasCustomTranslate;
 };
 
 
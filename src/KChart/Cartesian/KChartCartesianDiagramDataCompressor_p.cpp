@@ -23,7 +23,10 @@
 #include <QAbstractItemModel>
 
 #include "KChartAbstractCartesianDiagram.h"
+#include "KChartAttributesModel.h"
 #include "KChartMath_p.h"
+#include "KChartPerfObserver_p.h"
+#include "KChartSharedModelDataCache_p.h"
 
 
 using namespace KChart;
@@ -36,6 +39,10 @@ CartesianDiagramDataCompressor::CartesianDiagramDataCompressor( QObject* parent
     , m_yResolution( 0 )
     , m_sampleStep( 0 )
     , m_datasetDimension( 1 )
+    , m_cacheHits( 0 )
+    , m_cacheMisses( 0 )
+    , m_extentsCapacity( 0 )
+    , m_extentsDirty( true )
 {
     calculateSampleStepWidth();
     m_data.resize( 0 );
@@ -120,11 +127,17 @@ void CartesianDiagramDataCompressor::slotRowsAboutToBeInserted( const QModelInde
     if ( !prepareDataChange( parent, true, &start, &end ) ) {
         return;
     }
+    // appended rows fill unused leaves of the extents trees, other rows shift them
+    const int oldRowCount = m_data.isEmpty() ? 0 : m_data.first().size();
+    if ( start != oldRowCount || oldRowCount + end - start + 1 > m_extentsCapacity ) {
+        m_extentsDirty = true;
+    }
     for ( int i = 0; i < m_data.size(); ++i )
     {
         Q_ASSERT( start >= 0 && start <= m_data[ i ].size() );
         m_data[ i ].insert( start, end - start + 1, DataPoint() );
     }
+    invalidateStackedSums( start );
 }
 
 void CartesianDiagramDataCompressor::slotRowsInserted( const QModelIndex& parent, int start, int end )
@@ -148,6 +161,8 @@ void CartesianDiagramDataCompressor::slotColumnsAboutToBeInserted( const QModelI
     const int rowCount = qMin( m_model ? m_model->rowCount( m_rootIndex ) : 0, m_xResolution );
     Q_ASSERT( start >= 0 && start <= m_data.size() );
     m_data.insert( start, end - start + 1, QVector< DataPoint >( rowCount ) );
+    m_extentsDirty = true;
+    invalidateStackedSums( 0 );
 }
 
 void CartesianDiagramDataCompressor::slotColumnsInserted( const QModelIndex& parent, int start, int end )
@@ -171,6 +186,8 @@ void CartesianDiagramDataCompressor::slotRowsAboutToBeRemoved( const QModelIndex
     for ( int i = 0; i < m_data.size(); ++i ) {
         m_data[ i ].remove( start, end - start + 1 );
     }
+    m_extentsDirty = true;
+    invalidateStackedSums( start );
 }
 
 void CartesianDiagramDataCompressor::slotRowsRemoved( const QModelIndex& parent, int start, int end )
@@ -201,6 +218,8 @@ void CartesianDiagramDataCompressor::slotColumnsAboutToBeRemoved( const QModelIn
         return;
     }
     m_data.remove( start, end - start + 1 );
+    m_extentsDirty = true;
+    invalidateStackedSums( 0 );
 }
 
 void CartesianDiagramDataCompressor::slotColumnsRemoved( const QModelIndex& parent, int start, int end )
@@ -325,11 +344,13 @@ void CartesianDiagramDataCompressor::setModel( QAbstractItemModel* model )
                  this, SLOT(slotColumnsAboutToBeRemoved(QModelIndex,int,int)) );
         disconnect( m_model, SIGNAL(modelReset()),
                     this, SLOT(rebuildCache()) );
+        if ( qobject_cast< AttributesModel* >( m_model ) ) {
+            disconnect( m_model, SIGNAL(sourceModelChanged()),
+                        this, SLOT(slotSourceModelChanged()) );
+        }
         m_model = nullptr;
     }
 
-    m_modelCache.setModel( model );
-
     if ( model != nullptr ) {
         m_model = model;
         connect( m_model, SIGNAL(headerDataChanged(Qt::Orientation,int,int)),
@@ -355,17 +376,53 @@ void CartesianDiagramDataCompressor::setModel( QAbstractItemModel* model )
         connect( m_model, SIGNAL(columnsAboutToBeRemoved(QModelIndex,int,int)),
                  SLOT(slotColumnsAboutToBeRemoved(QModelIndex,int,int)) );
         connect( m_model, SIGNAL(modelReset()), SLOT(rebuildCache()) );
+        if ( qobject_cast< AttributesModel* >( m_model ) ) {
+            connect( m_model, SIGNAL(sourceModelChanged()), SLOT(slotSourceModelChanged()) );
+        }
     }
+    attachSharedCache();
     rebuildCache();
     calculateSampleStepWidth();
 }
 
+void CartesianDiagramDataCompressor::attachSharedCache()
+{
+    m_sharedCache.clear();
+    m_sourceRootIndex = QModelIndex();
+    // an AttributesModel passes the values of its source through unchanged, so they are the
+    // same for all diagrams showing the source. Subclasses may change them, though.
+    const AttributesModel* attributesModel = qobject_cast< const AttributesModel* >( m_model.data() );
+    if ( attributesModel && attributesModel->sourceModel()
+         && ( attributesModel->metaObject() == &AttributesModel::staticMetaObject
+              || attributesModel->metaObject() == &PrivateAttributesModel::staticMetaObject ) ) {
+        m_sharedCache = SharedModelDataCache::find( attributesModel->sourceModel() );
+        m_sourceRootIndex = attributesModel->mapToSource( m_rootIndex );
+        if ( m_sharedCache ) {
+            // here, not in modelValue(), which may run in another thread
+            m_sharedCache->addTable( m_sourceRootIndex );
+        }
+    }
+    // the private cache would only keep a second copy of the values
+    m_modelCache.setModel( m_sharedCache ? nullptr : m_model.data() );
+}
+
+void CartesianDiagramDataCompressor::slotSourceModelChanged()
+{
+    attachSharedCache();
+    rebuildCache();
+}
+
 void CartesianDiagramDataCompressor::setRootIndex( const QModelIndex& root )
 {
     if ( m_rootIndex != root ) {
         Q_ASSERT( root.model() == m_model || !root.isValid() );
         m_rootIndex = root;
-        m_modelCache.setRootIndex( root );
+        if ( m_sharedCache ) {
+            m_sourceRootIndex = static_cast< AttributesModel* >( m_model.data() )->mapToSource( root );
+            m_sharedCache->addTable( m_sourceRootIndex );
+        } else {
+            m_modelCache.setRootIndex( root );
+        }
         rebuildCache();
         calculateSampleStepWidth();
     }
@@ -404,11 +461,14 @@ void CartesianDiagramDataCompressor::clearCache()
 {
     for ( int column = 0; column < m_data.size(); ++column )
         m_data[column].fill( DataPoint() );
+    m_stackedRowStates.clear();
+    m_extentsDirty = true;
 }
 
 void CartesianDiagramDataCompressor::rebuildCache()
 {
     Q_ASSERT( m_datasetDimension != 0 );
+    const PerfPhaseTimer perfTimer( PerfObserver::CompressionPhase, this );
 
     m_data.clear();
     setResolutionInternal( m_xResolution, m_yResolution );
@@ -421,6 +481,8 @@ void CartesianDiagramDataCompressor::rebuildCache()
     }
     // also empty the attrs cache
     m_dataValueAttributesCache.clear();
+    m_stackedRowStates.clear();
+    m_extentsDirty = true;
 }
 
 const CartesianDiagramDataCompressor::DataPoint& CartesianDiagramDataCompressor::data( const CachePosition& position ) const
@@ -430,50 +492,198 @@ const CartesianDiagramDataCompressor::DataPoint& CartesianDiagramDataCompressor:
         return nullDataPoint;
     }
     if ( ! isCached( position ) ) {
+        ++m_cacheMisses;
         retrieveModelData( position );
+    } else {
+        ++m_cacheHits;
     }
     return m_data.at( position.column ).at( position.row );
 }
 
+qint64 CartesianDiagramDataCompressor::cacheHits() const
+{
+    return m_cacheHits;
+}
+
+qint64 CartesianDiagramDataCompressor::cacheMisses() const
+{
+    return m_cacheMisses;
+}
+
+void CartesianDiagramDataCompressor::resetCacheStatistics() const
+{
+    m_cacheHits = 0;
+    m_cacheMisses = 0;
+}
+
+void CartesianDiagramDataCompressor::updateStackedSums( int row ) const
+{
+    const int columnCount = m_data.size();
+    const int rowCount = modelDataRows();
+    if ( m_stackedRowStates.size() != rowCount || m_stackedSums.size() != rowCount * columnCount ) {
+        // the geometry of the cache has changed
+        m_stackedRowStates.fill( StackedRowDirty, rowCount );
+        m_stackedSums.resize( rowCount * columnCount );
+    }
+    if ( m_stackedRowStates.at( row ) != StackedRowDirty ) {
+        return;
+    }
+
+    StackedSums sums;
+    bool hasMissingValues = false;
+    StackedSums* rowSums = m_stackedSums.data() + row * columnCount;
+    for ( int column = 0; column < columnCount; ++column ) {
+        const qreal value = data( CachePosition( row, column ) ).value;
+        if ( ISNAN( value ) ) {
+            hasMissingValues = true;
+        } else if ( value >= 0.0 ) {
+            sums.positive += value;
+        } else {
+            sums.negative += value;
+        }
+        rowSums[ column ] = sums;
+    }
+    m_stackedRowStates[ row ] = hasMissingValues ? StackedRowWithMissingValues : StackedRowComplete;
+}
+
+void CartesianDiagramDataCompressor::invalidateStackedSums( int firstRow )
+{
+    // the sums of a row only depend on that row, so the rows before firstRow keep theirs,
+    // while the rows from firstRow on may now be other rows of the model
+    const int columnCount = m_data.size();
+    const int rowCount = m_data.isEmpty() ? 0 : m_data.first().size();
+    const int validRows = qBound( 0, firstRow, qMin( rowCount, m_stackedRowStates.size() ) );
+    m_stackedRowStates.resize( validRows );
+    m_stackedRowStates.insert( validRows, rowCount - validRows, StackedRowDirty );
+    m_stackedSums.resize( rowCount * columnCount );
+}
+
+const CartesianDiagramDataCompressor::StackedSums& CartesianDiagramDataCompressor::stackedSums(
+        const CachePosition& position ) const
+{
+    Q_ASSERT( mapsToModelIndex( position ) );
+    updateStackedSums( position.row );
+    return m_stackedSums.at( position.row * m_data.size() + position.column );
+}
+
+const CartesianDiagramDataCompressor::StackedSums& CartesianDiagramDataCompressor::rowSums( int row ) const
+{
+    return stackedSums( CachePosition( row, m_data.size() - 1 ) );
+}
+
+bool CartesianDiagramDataCompressor::rowHasMissingValues( int row ) const
+{
+    updateStackedSums( row );
+    return m_stackedRowStates.at( row ) == StackedRowWithMissingValues;
+}
+
 QPair< QPointF, QPointF > CartesianDiagramDataCompressor::dataBoundaries() const
 {
-    const int colCount = modelDataColumns();
-    qreal xMin = std::numeric_limits< qreal >::quiet_NaN();
-    qreal xMax = std::numeric_limits< qreal >::quiet_NaN();
-    qreal yMin = std::numeric_limits< qreal >::quiet_NaN();
-    qreal yMax = std::numeric_limits< qreal >::quiet_NaN();
+    const Extents all = extents();
+    const QPointF bottomLeft( all.keyMin, all.valueMin );
+    const QPointF topRight( all.keyMax, all.valueMax );
+    return qMakePair( bottomLeft, topRight );
+}
 
-    for ( int column = 0; column < colCount; ++column )
-    {
-        const DataPointVector& data = m_data.at( column );
-        int row = 0;
-        for ( DataPointVector::const_iterator it = data.begin(); it != data.end(); ++it, ++row )
-        {
-            const DataPoint& p = *it;
-            if ( !p.index.isValid() )
-                retrieveModelData( CachePosition( row, column ) );
-
-            if ( ISNAN( p.key ) || ISNAN( p.value ) ) {
-                continue;
+CartesianDiagramDataCompressor::Extents::Extents( const DataPoint& point )
+    : keyMin( point.key ),
+      keyMax( point.key ),
+      valueMin( point.value ),
+      valueMax( point.value ),
+      hasMissingValues( ISNAN( point.value ) )
+{
+    if ( ISNAN( point.key ) || ISNAN( point.value ) ) {
+        keyMin = keyMax = valueMin = valueMax = std::numeric_limits< qreal >::quiet_NaN();
+    }
+}
+
+void CartesianDiagramDataCompressor::Extents::unite( const Extents& other )
+{
+    hasMissingValues = hasMissingValues || other.hasMissingValues;
+    if ( ISNAN( other.keyMin ) ) {
+        return;
+    }
+    if ( ISNAN( keyMin ) ) {
+        keyMin = other.keyMin;
+        keyMax = other.keyMax;
+        valueMin = other.valueMin;
+        valueMax = other.valueMax;
+    } else {
+        keyMin = qMin( keyMin, other.keyMin );
+        keyMax = qMax( keyMax, other.keyMax );
+        valueMin = qMin( valueMin, other.valueMin );
+        valueMax = qMax( valueMax, other.valueMax );
+    }
+}
+
+CartesianDiagramDataCompressor::Extents CartesianDiagramDataCompressor::extents() const
+{
+    const PerfPhaseTimer perfTimer( PerfObserver::CompressionPhase, this );
+    if ( m_extentsDirty || m_extentsTrees.size() != m_data.size() ) {
+        // this is where the whole model gets read and compressed
+        rebuildExtents();
+    } else {
+        for ( const CachePosition& position : qAsConst( m_staleExtents ) ) {
+            // data() may have read the point again in the meantime
+            if ( mapsToModelIndex( position ) && !isCached( position ) ) {
+                retrieveModelData( position );
             }
+        }
+        m_staleExtents.clear();
+    }
 
-            if ( ISNAN( xMin ) ) {
-                xMin = p.key;
-                xMax = p.key;
-                yMin = p.value;
-                yMax = p.value;
-            } else {
-                xMin = qMin( xMin, p.key );
-                xMax = qMax( xMax, p.key );
-                yMin = qMin( yMin, p.value );
-                yMax = qMax( yMax, p.value );
+    Extents all;
+    for ( const QVector< Extents >& tree : qAsConst( m_extentsTrees ) ) {
+        all.unite( tree.at( 1 ) );
+    }
+    return all;
+}
+
+void CartesianDiagramDataCompressor::rebuildExtents() const
+{
+    const int columnCount = m_data.size();
+    const int rowCount = columnCount ? m_data.first().size() : 0;
+    // leave room for appending rows without rebuilding
+    m_extentsCapacity = 1;
+    while ( m_extentsCapacity < rowCount ) {
+        m_extentsCapacity *= 2;
+    }
+    m_extentsTrees.resize( columnCount );
+    for ( int column = 0; column < columnCount; ++column ) {
+        QVector< Extents >& tree = m_extentsTrees[ column ];
+        tree.fill( Extents(), 2 * m_extentsCapacity );
+        for ( int row = 0; row < rowCount; ++row ) {
+            const CachePosition position( row, column );
+            if ( !isCached( position ) ) {
+                retrieveModelData( position );
             }
+            tree[ m_extentsCapacity + row ] = Extents( m_data.at( column ).at( row ) );
+        }
+        for ( int node = m_extentsCapacity - 1; node > 0; --node ) {
+            tree[ node ] = tree.at( 2 * node );
+            tree[ node ].unite( tree.at( 2 * node + 1 ) );
         }
     }
+    m_staleExtents.clear();
+    m_extentsDirty = false;
+}
 
-    const QPointF bottomLeft( xMin, yMin );
-    const QPointF topRight( xMax, yMax );
-    return qMakePair( bottomLeft, topRight );
+void CartesianDiagramDataCompressor::updateExtents( const CachePosition& position ) const
+{
+    if ( m_extentsDirty ) {
+        return;
+    }
+    if ( position.column >= m_extentsTrees.size() || position.row >= m_extentsCapacity ) {
+        m_extentsDirty = true;
+        return;
+    }
+    QVector< Extents >& tree = m_extentsTrees[ position.column ];
+    int node = m_extentsCapacity + position.row;
+    tree[ node ] = Extents( m_data.at( position.column ).at( position.row ) );
+    for ( node /= 2; node > 0; node /= 2 ) {
+        tree[ node ] = tree.at( 2 * node );
+        tree[ node ].unite( tree.at( 2 * node + 1 ) );
+    }
 }
 
 void CartesianDiagramDataCompressor::retrieveModelData( const CachePosition& position ) const
@@ -491,8 +701,8 @@ void CartesianDiagramDataCompressor::retrieveModelData( const CachePosition& pos
             Q_ASSERT( indexes.count() == 2 );
             const QModelIndex& xIndex = indexes.at( 0 );
             result.index = xIndex;
-            result.key = m_modelCache.data( xIndex );
-            result.value = m_modelCache.data( indexes.at( 1 ) );
+            result.key = modelValue( xIndex );
+            result.value = modelValue( indexes.at( 1 ) );
         } else {
             if ( indexes.isEmpty() ) {
                 break;
@@ -500,7 +710,7 @@ void CartesianDiagramDataCompressor::retrieveModelData( const CachePosition& pos
             result.value = std::numeric_limits< qreal >::quiet_NaN();
             result.key = 0.0;
             for ( const QModelIndex& index : indexes ) {
-                const qreal value = m_modelCache.data( index );
+                const qreal value = modelValue( index );
                 if ( !ISNAN( value ) ) {
                     result.value = ISNAN( result.value ) ? value : result.value + value;
                 }
@@ -525,6 +735,16 @@ void CartesianDiagramDataCompressor::retrieveModelData( const CachePosition& pos
 
     m_data[ position.column ][ position.row ] = result;
     Q_ASSERT( isCached( position ) );
+    updateExtents( position );
+}
+
+qreal CartesianDiagramDataCompressor::modelValue( const QModelIndex& index ) const
+{
+    if ( m_sharedCache ) {
+        // the indexes of an AttributesModel have the rows and columns of its source
+        return m_sharedCache->value( m_sourceRootIndex, index.row(), index.column() );
+    }
+    return m_modelCache.data( index );
 }
 
 CartesianDiagramDataCompressor::CachePosition CartesianDiagramDataCompressor::mapToCache(
@@ -602,6 +822,18 @@ void CartesianDiagramDataCompressor::invalidate( const CachePosition& position )
 {
     if ( mapsToModelIndex( position ) ) {
         m_data[ position.column ][ position.row ] = DataPoint();
+        if ( !m_extentsDirty ) {
+            if ( m_staleExtents.size() < m_data.at( 0 ).size() ) {
+                m_staleExtents.append( position );
+            } else {
+                // cheaper to read everything again than to update the trees point by point
+                m_extentsDirty = true;
+                m_staleExtents.clear();
+            }
+        }
+        if ( position.row < m_stackedRowStates.size() ) {
+            m_stackedRowStates[ position.row ] = StackedRowDirty;
+        }
         // Also invalidate the data value attributes at "position".
         // Otherwise the user overwrites the attributes without us noticing
         // it because we keep reading what's in the cache.
@@ -38,6 +38,8 @@
 #include <QObject>
 #include <QPointer>
 #include <QModelIndex>
+#include <QPersistentModelIndex>
+#include <QSharedPointer>
 
 #include "KChartDataValueAttributes.h"
 #include "KChartModelDataCache_p.h"
@@ -52,6 +54,7 @@ QT_END_NAMESPACE
 namespace KChart {
 
     class AbstractDiagram;
+    class SharedModelDataCache;
 
     // - transparently compress table model data if the diagram widget
     // size does not allow to display all data points in an acceptable way
@@ -114,6 +117,39 @@ namespace KChart {
             }
         };
 
+        // running sums over the datasets of one row, for the stacked and percent diagram types
+        class StackedSums {
+        public:
+            StackedSums()
+                : positive( 0.0 ),
+                  negative( 0.0 )
+                  {}
+            qreal total() const { return positive + negative; }
+            qreal absolute() const { return positive - negative; }
+            qreal positive; // sum of the values >= 0
+            qreal negative; // sum of the values < 0
+        };
+
+        // the ranges of the keys and values of a number of data points. Only points with a
+        // valid key and value are taken into account for the ranges.
+        class Extents {
+        public:
+            Extents()
+                : keyMin( std::numeric_limits< qreal >::quiet_NaN() ),
+                  keyMax( std::numeric_limits< qreal >::quiet_NaN() ),
+                  valueMin( std::numeric_limits< qreal >::quiet_NaN() ),
+                  valueMax( std::numeric_limits< qreal >::quiet_NaN() ),
+                  hasMissingValues( false )
+                  {}
+            explicit Extents( const DataPoint& point );
+            void unite( const Extents& other );
+            qreal keyMin;
+            qreal keyMax;
+            qreal valueMin;
+            qreal valueMax;
+            bool hasMissingValues; // whether the value of any of the points is NaN
+        };
+
         typedef QMap< QModelIndex, DataValueAttributes > AggregatedDataValueAttributes;
         typedef QMap< CartesianDiagramDataCompressor::CachePosition, AggregatedDataValueAttributes > DataValueAttributesCache;
 
@@ -142,6 +178,25 @@ namespace KChart {
         const DataPoint& data( const CachePosition& ) const;
 
         QPair< QPointF, QPointF > dataBoundaries() const;
+        // the extents of all data points. They are kept up to date incrementally, so only
+        // the data points that changed since the last call need to be looked at.
+        Extents extents() const;
+
+        // the sums of the values of the datasets 0 to position.column in position.row, with
+        // missing values counted as 0. They are calculated once per row and kept until data
+        // in the row changes.
+        const StackedSums& stackedSums( const CachePosition& ) const;
+        // the sums over all datasets in the row
+        const StackedSums& rowSums( int row ) const;
+        // whether the values of any dataset in the row are missing (NaN); the sums of such
+        // rows are only useful if missing values are not to be interpolated
+        bool rowHasMissingValues( int row ) const;
+
+        // how many calls of data() were answered from the cache and how many had to read the
+        // model since the last resetCacheStatistics(), for PerfObserver
+        qint64 cacheHits() const;
+        qint64 cacheMisses() const;
+        void resetCacheStatistics() const;
 
         AggregatedDataValueAttributes aggregatedAttrs(
                 const AbstractDiagram* diagram,
@@ -165,6 +220,8 @@ namespace KChart {
         // FIXME resolution changes and root index changes should all
         // be catchable with this method:
         void slotDiagramLayoutChanged( AbstractDiagram* );
+        // the source of the AttributesModel has changed
+        void slotSourceModelChanged();
 
         // geometry has changed
         void rebuildCache();
@@ -190,12 +247,24 @@ namespace KChart {
                                 bool isRows, /* columns otherwise */
                                 int* start, int* end);
 
+        // use the values of the SharedModelDataCache of the model's source, if it has one
+        void attachSharedCache();
+        // the value of a cell of the model, from one of the value caches
+        qreal modelValue( const QModelIndex& index ) const;
         // retrieve data from the model, put it into the cache
         void retrieveModelData( const CachePosition& ) const;
         // check if a data point is in the cache:
         bool isCached( const CachePosition& ) const;
         // set sample step width according to settings:
         void calculateSampleStepWidth();
+        // make sure the stacked sums of the row are up to date
+        void updateStackedSums( int row ) const;
+        // mark the stacked sums of the rows from firstRow on dirty, after rows or datasets moved
+        void invalidateStackedSums( int firstRow );
+        // update the extents trees after the data point at the position was retrieved
+        void updateExtents( const CachePosition& ) const;
+        // build the extents trees from scratch, reading all data points
+        void rebuildExtents() const;
 
 
         QPointer<QAbstractItemModel> m_model;
@@ -207,9 +276,34 @@ namespace KChart {
         unsigned int m_sampleStep;
 
         mutable QVector<DataPointVector> m_data; // one per dataset
+        // the values of the model, either shared with the other diagrams showing the source
+        // model of the AttributesModel (at the root index of the source), or private
+        QSharedPointer< SharedModelDataCache > m_sharedCache;
+        QPersistentModelIndex m_sourceRootIndex;
         ModelDataCache< qreal, Qt::DisplayRole > m_modelCache;
         mutable DataValueAttributesCache m_dataValueAttributesCache;
         int m_datasetDimension;
+        mutable qint64 m_cacheHits;
+        mutable qint64 m_cacheMisses;
+
+        enum StackedRowState {
+            StackedRowDirty = 0,
+            StackedRowComplete,
+            StackedRowWithMissingValues
+        };
+        // row after row, one entry per dataset
+        mutable QVector< StackedSums > m_stackedSums;
+        mutable QVector< char > m_stackedRowStates;
+
+        // one segment tree per dataset with the extents of its data points, the extents of
+        // the data point in a row are at [ m_extentsCapacity + row ], those of the whole
+        // dataset at [ 1 ]
+        mutable QVector< QVector< Extents > > m_extentsTrees;
+        mutable int m_extentsCapacity;
+        // the trees need to be rebuilt, e.g. because rows were inserted in the middle
+        mutable bool m_extentsDirty;
+        // data points invalidated since the trees were last brought up to date
+        mutable QVector< CachePosition > m_staleExtents;
     };
 }
 
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "KChartDiagramLayers_p.h"
+
+#include <QBrush>
+#include <QFont>
+#include <QFontDatabase>
+#include <QPaintDevice>
+#include <QPaintEngine>
+#include <QPainter>
+#include <QPen>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QVector>
+
+#include "KChartAbstractDiagram.h"
+#include "KChartAbstractDiagram_p.h"
+#include "KChartCartesianCoordinatePlane.h"
+#include "KChartCartesianCoordinatePlane_p.h"
+#include "KChartPaintContext.h"
+
+using namespace KChart;
+
+namespace {
+
+struct LayerJob
+{
+    AbstractDiagram* diagram;
+    CartesianCoordinatePlane* plane;
+    QRectF drawingArea;
+    QRect exposedRect;
+    DiagramLayer layer;
+};
+
+// the state of the chart's painter the diagrams would have started with, copied so that
+// the painter is not touched by other threads
+struct PainterState
+{
+    QPainter::RenderHints renderHints;
+    QFont font;
+    QPen pen;
+    QBrush brush;
+};
+
+void paintLayer( LayerJob* job, const PainterState& state )
+{
+    QPainter painter( &job->layer.image );
+    painter.setRenderHints( state.renderHints );
+    painter.setFont( state.font );
+    painter.setPen( state.pen );
+    painter.setBrush( state.brush );
+    painter.translate( -job->layer.rect.topLeft() );
+    painter.setClipRect( job->layer.rect );
+
+    PaintContext ctx;
+    ctx.setPainter( &painter );
+    ctx.setCoordinatePlane( job->plane );
+    ctx.setRectangle( job->drawingArea );
+    ctx.setExposedRect( job->exposedRect );
+
+    CartesianCoordinatePlane::Private::paintDiagram( job->diagram, &ctx );
+}
+
+class LayerRunnable : public QRunnable
+{
+public:
+    LayerRunnable( LayerJob* job, const PainterState& state, QSemaphore* finished )
+        : m_job( job ),
+          m_state( state ),
+          m_finished( finished )
+    {
+    }
+
+    void run() override
+    {
+        paintLayer( m_job, m_state );
+        m_finished->release();
+    }
+
+private:
+    LayerJob* const m_job;
+    const PainterState m_state;
+    QSemaphore* const m_finished;
+};
+
+}
+
+bool DiagramLayers::isSupported( const QPainter* painter )
+{
+    const QPaintEngine* engine = painter->paintEngine();
+    if ( !engine || engine->type() != QPaintEngine::Raster ) {
+        return false;
+    }
+    // the layers must line up with the pixels of the device
+    const QTransform& transform = painter->transform();
+    const qreal devicePixelRatio = painter->device()->devicePixelRatioF();
+    const qreal dx = transform.dx() * devicePixelRatio;
+    const qreal dy = transform.dy() * devicePixelRatio;
+    return transform.type() <= QTransform::TxTranslate
+           && dx == qRound( dx ) && dy == qRound( dy )
+           && QFontDatabase::supportsThreadedFontRendering();
+}
+
+void DiagramLayers::paint( const QList< AbstractCoordinatePlane* >& planes, QPainter* painter )
+{
+    discard( planes );
+
+    QVector< LayerJob > jobs;
+    Q_FOREACH( AbstractCoordinatePlane* abstractPlane, planes ) {
+        CartesianCoordinatePlane* plane = qobject_cast< CartesianCoordinatePlane* >( abstractPlane );
+        if ( !plane ) {
+            continue;
+        }
+        const QRectF drawingArea = CartesianCoordinatePlane::Private::diagramDrawingArea( plane );
+        const QRect clipRect = CartesianCoordinatePlane::Private::diagramClipRect( drawingArea );
+        const QRect exposedRect = CartesianCoordinatePlane::Private::get( plane )->exposedRect;
+        if ( clipRect.isEmpty() || ( exposedRect.isValid() && !exposedRect.intersects( clipRect ) ) ) {
+            continue;
+        }
+        Q_FOREACH( AbstractDiagram* diagram, plane->diagrams() ) {
+            if ( diagram->isHidden() ) {
+                continue;
+            }
+            LayerJob job;
+            job.diagram = diagram;
+            job.plane = plane;
+            job.drawingArea = drawingArea;
+            job.exposedRect = exposedRect;
+            job.layer.rect = clipRect;
+            job.layer.transform = painter->transform();
+            jobs.append( job );
+        }
+    }
+    // one diagram is painted just as fast without a layer
+    if ( jobs.count() < 2 ) {
+        return;
+    }
+
+    const QPaintDevice* device = painter->device();
+    const qreal devicePixelRatio = device->devicePixelRatioF();
+    for ( LayerJob& job : jobs ) {
+        // the data boundaries are calculated on demand, possibly while another diagram
+        // asks for them; make sure they are up to date before painting starts
+        job.diagram->dataBoundaries();
+        AbstractDiagram::Private::get( job.diagram )->reverseMapper.startRecording();
+
+        QImage& image = job.layer.image;
+        image = QImage( job.layer.rect.size() * devicePixelRatio, QImage::Format_ARGB32_Premultiplied );
+        image.setDevicePixelRatio( devicePixelRatio );
+        // texts are measured for the resolution of the device they are painted on
+        image.setDotsPerMeterX( qRound( device->logicalDpiX() / 0.0254 ) );
+        image.setDotsPerMeterY( qRound( device->logicalDpiY() / 0.0254 ) );
+        image.fill( Qt::transparent );
+    }
+
+    PainterState state;
+    state.renderHints = painter->renderHints();
+    state.font = painter->font();
+    state.pen = painter->pen();
+    state.brush = painter->brush();
+
+    // the calling thread paints the first layer instead of just waiting
+    QSemaphore finished;
+    for ( int i = 1; i < jobs.count(); ++i ) {
+        QThreadPool::globalInstance()->start( new LayerRunnable( &jobs[ i ], state, &finished ) );
+    }
+    paintLayer( &jobs[ 0 ], state );
+    finished.acquire( jobs.count() - 1 );
+
+    for ( const LayerJob& job : qAsConst( jobs ) ) {
+        AbstractDiagram::Private::get( job.diagram )->reverseMapper.replayRecording();
+        CartesianCoordinatePlane::Private::get( job.plane )->diagramLayers.insert( job.diagram, job.layer );
+    }
+}
+
+void DiagramLayers::discard( const QList< AbstractCoordinatePlane* >& planes )
+{
+    Q_FOREACH( AbstractCoordinatePlane* abstractPlane, planes ) {
+        if ( CartesianCoordinatePlane* plane = qobject_cast< CartesianCoordinatePlane* >( abstractPlane ) ) {
+            CartesianCoordinatePlane::Private::get( plane )->diagramLayers.clear();
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef KCHARTDIAGRAMLAYERS_P_H
+#define KCHARTDIAGRAMLAYERS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QImage>
+#include <QList>
+#include <QRect>
+#include <QTransform>
+
+#include "KChartGlobal.h"
+
+QT_BEGIN_NAMESPACE
+class QPainter;
+QT_END_NAMESPACE
+
+
+namespace KChart {
+
+    class AbstractCoordinatePlane;
+
+/**
+   \internal
+
+   @short A diagram painted into an image of its own, waiting to be composited
+
+   The image covers \a rect, the clip rectangle of the coordinate plane, in the coordinates
+   of a painter with the world transformation \a transform.
+*/
+struct DiagramLayer
+{
+    QImage image;
+    QRect rect;
+    QTransform transform;
+};
+
+/**
+   \internal
+
+   @short Paints the diagrams of cartesian coordinate planes in parallel
+
+   paint() paints every visible diagram of the given planes that is exposed into a DiagramLayer, using
+   the global QThreadPool, and hands the layers to the planes. CartesianCoordinatePlane::paint()
+   then composites them in the order of its diagrams instead of painting the diagrams.
+
+   The caches the diagrams fill while painting are their own, so each diagram is painted in
+   one thread only. What the diagrams share, their models and attributes models, is only
+   read. Everything a painting diagram would change outside of its own data, like its
+   ReverseMapper, is prepared before and finished after the parallel part, in the calling
+   thread.
+*/
+class DiagramLayers
+{
+public:
+    /**
+       \return Whether layers can replace painting with \a painter directly, without any
+       visible difference. This is the case for raster painting without rotation or scaling,
+       like painting a widget on screen or into a QImage.
+    */
+    static bool isSupported( const QPainter* painter );
+
+    static void paint( const QList< AbstractCoordinatePlane* >& planes, QPainter* painter );
+
+    /**
+       Drops the layers of \a planes that were not composited, so that they do not show up
+       in a later paint().
+    */
+    static void discard( const QList< AbstractCoordinatePlane* >& planes );
+};
+
+}
+
+#endif /* KCHARTDIAGRAMLAYERS_P_H */
@@ -35,6 +35,7 @@ using namespace KChart;
 using namespace std;
 
 LeveyJenningsDiagram::Private::Private()
+    : statisticsWindowSize( 0 )
 {
 }
 
@@ -245,11 +246,11 @@ void LeveyJenningsDiagram::setModel( QAbstractItemModel* model )
     if ( this->model() != nullptr )
     {
         disconnect( this->model(), SIGNAL(dataChanged(QModelIndex,QModelIndex)),
-                                   this, SLOT(calculateMeanAndStandardDeviation()) );
+                                   this, SLOT(qcValuesChanged(QModelIndex,QModelIndex)) );
         disconnect( this->model(), SIGNAL(rowsInserted(QModelIndex,int,int)),
-                                   this, SLOT(calculateMeanAndStandardDeviation()) );
+                                   this, SLOT(qcValuesInserted(QModelIndex,int,int)) );
         disconnect( this->model(), SIGNAL(rowsRemoved(QModelIndex,int,int)),
-                                   this, SLOT(calculateMeanAndStandardDeviation()) );
+                                   this, SLOT(qcValuesRemoved(QModelIndex,int,int)) );
         disconnect( this->model(), SIGNAL(columnsInserted(QModelIndex,int,int)),
                                    this, SLOT(calculateMeanAndStandardDeviation()) );
         disconnect( this->model(), SIGNAL(columnsRemoved(QModelIndex,int,int)),
@@ -263,11 +264,11 @@ void LeveyJenningsDiagram::setModel( QAbstractItemModel* model )
     if ( this->model() != nullptr )
     {
         connect( this->model(), SIGNAL(dataChanged(QModelIndex,QModelIndex)),
-                                this, SLOT(calculateMeanAndStandardDeviation()) );
+                                this, SLOT(qcValuesChanged(QModelIndex,QModelIndex)) );
         connect( this->model(), SIGNAL(rowsInserted(QModelIndex,int,int)),
-                                this, SLOT(calculateMeanAndStandardDeviation()) );
+                                this, SLOT(qcValuesInserted(QModelIndex,int,int)) );
         connect( this->model(), SIGNAL(rowsRemoved(QModelIndex,int,int)),
-                                this, SLOT(calculateMeanAndStandardDeviation()) );
+                                this, SLOT(qcValuesRemoved(QModelIndex,int,int)) );
         connect( this->model(), SIGNAL(columnsInserted(QModelIndex,int,int)),
                                 this, SLOT(calculateMeanAndStandardDeviation()) );
         connect( this->model(), SIGNAL(columnsRemoved(QModelIndex,int,int)),
@@ -281,38 +282,119 @@ void LeveyJenningsDiagram::setModel( QAbstractItemModel* model )
     }
 }
 
-// TODO: This is the 'easy' solution
-// evaluate whether this is enough or we need some better one or even boost here
-void LeveyJenningsDiagram::calculateMeanAndStandardDeviation() const
+void LeveyJenningsDiagram::setStatisticsWindowSize( int rows )
 {
-    QVector< qreal > values;
-    // first fetch all values
-    const QAbstractItemModel& m = *model();
-    const int rowCount = m.rowCount( rootIndex() );
+    rows = qMax( rows, 0 );
+    if ( d->statisticsWindowSize == rows )
+        return;
 
+    d->statisticsWindowSize = rows;
+    if ( model() != nullptr )
+        d->recalculateWindowStatistics();
+    update();
+}
+
+int LeveyJenningsDiagram::statisticsWindowSize() const
+{
+    return d->statisticsWindowSize;
+}
+
+void LeveyJenningsDiagram::calculateMeanAndStandardDeviation() const
+{
+    const int rowCount = model()->rowCount( rootIndex() );
+    d->qcValues.resize( rowCount );
     for ( int row = 0; row < rowCount; ++row )
-    {
-        const QVariant var = m.data( m.index( row, 1, rootIndex() ) );
-        if ( !var.isValid() )
-            continue;
-        const qreal value = var.toReal();
-        if ( ISNAN( value ) )
-            continue;
-        values << value;
+        d->qcValues[ row ] = d->qcValue( row );
+
+    d->recalculateWindowStatistics();
+}
+
+// The following slots keep the statistics up to date in constant time per changed value in the
+// common cases. Anything the cached values cannot follow falls back to a full recalculation.
+
+void LeveyJenningsDiagram::qcValuesInserted( const QModelIndex& parent, int first, int last )
+{
+    if ( parent != rootIndex() )
+        return;
+    const int insertedCount = last - first + 1;
+    if ( d->qcValues.count() + insertedCount != model()->rowCount( rootIndex() ) ) {
+        calculateMeanAndStandardDeviation();
+        return;
     }
 
-    qreal sum = 0.0;
-    qreal sumSquares = 0.0;
-    for ( qreal value : qAsConst(values) )
-    {
-        sum += value;
-        sumSquares += value * value;
+    if ( first != d->qcValues.count() ) {
+        // inserted in the middle, no need to ask the model for any of the other values though
+        d->qcValues.insert( first, insertedCount, 0.0 );
+        for ( int row = first; row <= last; ++row )
+            d->qcValues[ row ] = d->qcValue( row );
+        d->recalculateWindowStatistics();
+        return;
+    }
+
+    // appended, which is what happens all the time with QC results coming in
+    const int oldWindowStart = d->statisticsWindowStart();
+    for ( int row = first; row <= last; ++row ) {
+        const qreal value = d->qcValue( row );
+        d->qcValues.append( value );
+        if ( !ISNAN( value ) )
+            d->statistics.add( value );
+    }
+    // drop the values that have moved out of the window
+    const int newWindowStart = d->statisticsWindowStart();
+    for ( int row = oldWindowStart; row < newWindowStart; ++row ) {
+        if ( !ISNAN( d->qcValues[ row ] ) )
+            d->statistics.remove( d->qcValues[ row ] );
     }
+    d->publishStatistics();
+}
 
-    const int N = values.count();
+void LeveyJenningsDiagram::qcValuesRemoved( const QModelIndex& parent, int first, int last )
+{
+    if ( parent != rootIndex() )
+        return;
+    const int removedCount = last - first + 1;
+    if ( d->qcValues.count() - removedCount != model()->rowCount( rootIndex() ) ) {
+        calculateMeanAndStandardDeviation();
+        return;
+    }
 
-    d->calculatedMeanValue = sum / N;
-    d->calculatedStandardDeviation = sqrt( ( static_cast< qreal >( N ) * sumSquares - sum * sum ) / ( N * ( N - 1 ) ) );
+    if ( d->statisticsWindowSize != 0 ) {
+        // the window moves, which is cheap to redo from the cached values
+        d->qcValues.remove( first, removedCount );
+        d->recalculateWindowStatistics();
+        return;
+    }
+
+    for ( int row = first; row <= last; ++row ) {
+        if ( !ISNAN( d->qcValues[ row ] ) )
+            d->statistics.remove( d->qcValues[ row ] );
+    }
+    d->qcValues.remove( first, removedCount );
+    d->publishStatistics();
+}
+
+void LeveyJenningsDiagram::qcValuesChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight )
+{
+    if ( topLeft.parent() != rootIndex() || topLeft.column() > 1 || bottomRight.column() < 1 )
+        return;
+    if ( d->qcValues.count() != model()->rowCount( rootIndex() ) ) {
+        calculateMeanAndStandardDeviation();
+        return;
+    }
+
+    const int windowStart = d->statisticsWindowStart();
+    for ( int row = topLeft.row(); row <= bottomRight.row(); ++row ) {
+        const qreal oldValue = d->qcValues[ row ];
+        const qreal newValue = d->qcValue( row );
+        d->qcValues[ row ] = newValue;
+        if ( row < windowStart )
+            continue;
+        if ( !ISNAN( oldValue ) )
+            d->statistics.remove( oldValue );
+        if ( !ISNAN( newValue ) )
+            d->statistics.add( newValue );
+    }
+    d->publishStatistics();
 }
 
 // calculates the largest QDate not greater than \a dt.
@@ -141,6 +141,18 @@ public:
      */
     float calculatedStandardDeviation() const;
 
+    /**
+     * Restricts calculatedMeanValue() and calculatedStandardDeviation() to the QC values of
+     * the last \a rows rows of the model, for rolling control limits.
+     * The default of 0 uses all QC values.
+     */
+    void setStatisticsWindowSize( int rows );
+
+    /**
+     * Returns the number of rows the statistics are calculated over, 0 for all rows.
+     */
+    int statisticsWindowSize() const;
+
 
     /**
      * Sets the date/time of all fluidics pack changes to \a changes.
@@ -263,6 +275,11 @@ protected:
 
 protected Q_SLOTS:
     void calculateMeanAndStandardDeviation() const;
+
+private Q_SLOTS:
+    void qcValuesInserted( const QModelIndex& parent, int first, int last );
+    void qcValuesRemoved( const QModelIndex& parent, int first, int last );
+    void qcValuesChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight );
 }; // End of class KChartLineDiagram
 
 }
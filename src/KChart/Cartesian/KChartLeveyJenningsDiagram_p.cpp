@@ -34,7 +34,8 @@ LeveyJenningsDiagram::Private::Private( const Private& rhs )
       scanLinePen( rhs.scanLinePen ),
       icons( rhs.icons ),
       expectedMeanValue( rhs.expectedMeanValue ),
-      expectedStandardDeviation( rhs.expectedStandardDeviation )
+      expectedStandardDeviation( rhs.expectedStandardDeviation ),
+      statisticsWindowSize( rhs.statisticsWindowSize )
 {
 }
 
@@ -47,3 +48,36 @@ void LeveyJenningsDiagram::Private::setYAxisRange() const
     plane->setVerticalRange( QPair< qreal, qreal >( expectedMeanValue - 4 * expectedStandardDeviation, 
                                                     expectedMeanValue + 4 * expectedStandardDeviation ) );
 }
+
+qreal LeveyJenningsDiagram::Private::qcValue( int row ) const
+{
+    const QAbstractItemModel* const m = diagram->model();
+    const QVariant var = m->data( m->index( row, 1, diagram->rootIndex() ) );
+    if ( !var.isValid() )
+        return std::numeric_limits< qreal >::quiet_NaN();
+    return var.toReal();
+}
+
+int LeveyJenningsDiagram::Private::statisticsWindowStart() const
+{
+    if ( statisticsWindowSize == 0 )
+        return 0;
+    return qMax( 0, qcValues.count() - statisticsWindowSize );
+}
+
+void LeveyJenningsDiagram::Private::recalculateWindowStatistics() const
+{
+    statistics.clear();
+    for ( int row = statisticsWindowStart(); row < qcValues.count(); ++row )
+    {
+        if ( !ISNAN( qcValues[ row ] ) )
+            statistics.add( qcValues[ row ] );
+    }
+    publishStatistics();
+}
+
+void LeveyJenningsDiagram::Private::publishStatistics() const
+{
+    calculatedMeanValue = statistics.mean();
+    calculatedStandardDeviation = statistics.standardDeviation();
+}
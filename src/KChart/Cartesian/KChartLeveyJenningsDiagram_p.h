@@ -46,6 +46,64 @@ namespace KChart {
 
     class PaintContext;
 
+/**
+ * \internal
+ *
+ * The mean and sample standard deviation of a set of values that changes one value at a
+ * time, using Welford's algorithm. Unlike summing up values and their squares, this does
+ * not lose all precision when the values are large compared to their spread.
+ */
+    class RunningStatistics
+    {
+    public:
+        RunningStatistics()
+            : m_count( 0 ),
+              m_mean( 0.0 ),
+              m_m2( 0.0 )
+        {}
+
+        void clear()
+        {
+            m_count = 0;
+            m_mean = 0.0;
+            m_m2 = 0.0;
+        }
+
+        void add( qreal value )
+        {
+            ++m_count;
+            const qreal delta = value - m_mean;
+            m_mean += delta / m_count;
+            m_m2 += delta * ( value - m_mean );
+        }
+
+        // \a value must have been add()ed before
+        void remove( qreal value )
+        {
+            if ( m_count <= 1 ) {
+                clear();
+                return;
+            }
+            const qreal delta = value - m_mean;
+            m_mean -= delta / ( m_count - 1 );
+            m_m2 = qMax( qreal( 0.0 ), m_m2 - delta * ( value - m_mean ) );
+            --m_count;
+        }
+
+        int count() const { return m_count; }
+        qreal mean() const { return m_count ? m_mean : std::numeric_limits< qreal >::quiet_NaN(); }
+        qreal standardDeviation() const
+        {
+            return m_count > 1 ? sqrt( m_m2 / ( m_count - 1 ) )
+                               : std::numeric_limits< qreal >::quiet_NaN();
+        }
+
+    private:
+        int m_count;
+        qreal m_mean;
+        qreal m_m2; // sum of squared differences from the mean
+    };
+
 /**
  * \internal
  */
@@ -59,6 +117,11 @@ namespace KChart {
 
         void setYAxisRange() const;
 
+        qreal qcValue( int row ) const;
+        int statisticsWindowStart() const;
+        void recalculateWindowStatistics() const;
+        void publishStatistics() const;
+
         Qt::Alignment lotChangedPosition;
         Qt::Alignment fluidicsPackChangedPosition;
         Qt::Alignment sensorChangedPosition;
@@ -78,6 +141,12 @@ namespace KChart {
 
         mutable float calculatedMeanValue;
         mutable float calculatedStandardDeviation;
+
+        int statisticsWindowSize; // in rows, 0 for all rows
+        // the QC value (column 1) of each row as last seen, NaN if invalid
+        mutable QVector< qreal > qcValues;
+        // over the QC values of the rows from statisticsWindowStart() on
+        mutable RunningStatistics statistics;
     };
 
     KCHART_IMPL_DERIVED_DIAGRAM( LeveyJenningsDiagram, LineDiagram, LeveyJenningsCoordinatePlane )
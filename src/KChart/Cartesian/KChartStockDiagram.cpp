@@ -22,6 +22,7 @@
 
 #include "KChartPaintContext.h"
 #include "KChartPainterSaver_p.h"
+#include "KChartTickResamplingModel.h"
 
 using namespace KChart;
 
@@ -303,6 +304,16 @@ void StockDiagram::paint( PaintContext *context )
 
 void StockDiagram::resize( const QSizeF &size )
 {
+    TickResamplingModel* resampler = qobject_cast< TickResamplingModel* >( model() );
+    if ( resampler && resampler->pixelsPerBucket() > 0 ) {
+        const int bucketCount = qMax( 1, static_cast< int >( size.width() * coordinatePlane()->zoomFactorX() ) /
+                                         resampler->pixelsPerBucket() );
+        if ( bucketCount != resampler->maximumBucketCount() ) {
+            // changing the model while the chart is being laid out is asking for trouble
+            QMetaObject::invokeMethod( resampler, "setMaximumBucketCount", Qt::QueuedConnection,
+                                       Q_ARG( int, bucketCount ) );
+        }
+    }
     d->compressor.setResolution( static_cast< int >( size.width() * coordinatePlane()->zoomFactorX() ),
                                  static_cast< int >( size.height() * coordinatePlane()->zoomFactorY() ) );
     setDataBoundariesDirty();
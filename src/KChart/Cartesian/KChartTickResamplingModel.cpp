@@ -0,0 +1,470 @@
+/**
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "KChartTickResamplingModel.h"
+
+#include <QDateTime>
+#include <QPointer>
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+
+#include "KChartMath_p.h"
+
+using namespace KChart;
+
+namespace {
+
+struct Tick
+{
+    qreal time;
+    qreal price;
+    qreal volume;
+
+    bool operator<( const Tick& other ) const { return time < other.time; }
+};
+
+struct Bucket
+{
+    qint64 index; // the bucket covers [ index * interval, ( index + 1 ) * interval )
+    qreal open;
+    qreal high;
+    qreal low;
+    qreal close;
+    qreal volume;
+    int tickCount;
+};
+
+// index / 2, rounded down also for negative indexes
+qint64 halfIndex( qint64 index )
+{
+    return index >= 0 ? index / 2 : -( ( -index + 1 ) / 2 );
+}
+
+}
+
+class Q_DECL_HIDDEN TickResamplingModel::Private
+{
+public:
+    Private()
+        : timeColumn( 0 ),
+          priceColumn( 1 ),
+          volumeColumn( 2 ),
+          stockType( StockDiagram::OpenHighLowClose ),
+          baseInterval( 1.0 ),
+          intervalFactor( 1 ),
+          maximumBucketCount( 0 ),
+          pixelsPerBucket( 0 ),
+          processedRows( 0 )
+    {
+    }
+
+    qreal interval() const { return baseInterval * intervalFactor; }
+    bool readTick( int row, Tick* tick ) const;
+    // adds the tick to the last of the buckets or appends a new one; false if the tick
+    // belongs into an earlier bucket
+    bool appendTick( QVector< Bucket >* target, const Tick& tick ) const;
+    // double the interval until the buckets do not exceed maximumBucketCount
+    void fitBuckets();
+    QVariant bucketValue( const Bucket& bucket, int column ) const;
+
+    QPointer< QAbstractItemModel > sourceModel;
+    int timeColumn;
+    int priceColumn;
+    int volumeColumn;
+    StockDiagram::Type stockType;
+    qreal baseInterval;
+    qint64 intervalFactor;
+    int maximumBucketCount;
+    int pixelsPerBucket;
+    QVector< Bucket > buckets;
+    // the rows of the source model that went into the buckets
+    int processedRows;
+};
+
+bool TickResamplingModel::Private::readTick( int row, Tick* tick ) const
+{
+    const QVariant time = sourceModel->data( sourceModel->index( row, timeColumn ) );
+    bool ok = false;
+    if ( time.userType() == QMetaType::QDateTime ) {
+        tick->time = time.toDateTime().toMSecsSinceEpoch() / 1000.0;
+        ok = time.toDateTime().isValid();
+    } else {
+        tick->time = time.toReal( &ok );
+    }
+    if ( !ok || ISNAN( tick->time ) ) {
+        return false;
+    }
+    tick->price = sourceModel->data( sourceModel->index( row, priceColumn ) ).toReal( &ok );
+    if ( !ok || ISNAN( tick->price ) ) {
+        return false;
+    }
+    tick->volume = 0.0;
+    if ( volumeColumn >= 0 && volumeColumn < sourceModel->columnCount() ) {
+        tick->volume = sourceModel->data( sourceModel->index( row, volumeColumn ) ).toReal();
+    }
+    return true;
+}
+
+bool TickResamplingModel::Private::appendTick( QVector< Bucket >* target, const Tick& tick ) const
+{
+    const qint64 index = qint64( std::floor( tick.time / interval() ) );
+    if ( target->isEmpty() || index > target->last().index ) {
+        const Bucket bucket = { index, tick.price, tick.price, tick.price, tick.price, tick.volume, 1 };
+        target->append( bucket );
+        return true;
+    }
+    Bucket& bucket = target->last();
+    if ( index < bucket.index ) {
+        return false;
+    }
+    bucket.high = qMax( bucket.high, tick.price );
+    bucket.low = qMin( bucket.low, tick.price );
+    bucket.close = tick.price;
+    bucket.volume += tick.volume;
+    ++bucket.tickCount;
+    return true;
+}
+
+void TickResamplingModel::Private::fitBuckets()
+{
+    if ( maximumBucketCount <= 0 ) {
+        return;
+    }
+    while ( buckets.size() > maximumBucketCount ) {
+        // the buckets of twice the interval are made of pairs of the current ones
+        int merged = 0;
+        for ( int i = 0; i < buckets.size(); ++i ) {
+            Bucket bucket = buckets.at( i );
+            bucket.index = halfIndex( bucket.index );
+            if ( merged > 0 && buckets.at( merged - 1 ).index == bucket.index ) {
+                Bucket& previous = buckets[ merged - 1 ];
+                previous.high = qMax( previous.high, bucket.high );
+                previous.low = qMin( previous.low, bucket.low );
+                previous.close = bucket.close;
+                previous.volume += bucket.volume;
+                previous.tickCount += bucket.tickCount;
+            } else {
+                buckets[ merged++ ] = bucket;
+            }
+        }
+        buckets.resize( merged );
+        intervalFactor *= 2;
+    }
+}
+
+QVariant TickResamplingModel::Private::bucketValue( const Bucket& bucket, int column ) const
+{
+    if ( stockType == StockDiagram::HighLowClose ) {
+        ++column; // there is no open column
+    }
+    switch ( column ) {
+    case 0: return bucket.open;
+    case 1: return bucket.high;
+    case 2: return bucket.low;
+    case 3: return bucket.close;
+    }
+    return QVariant();
+}
+
+
+TickResamplingModel::TickResamplingModel( QObject* parent )
+    : QAbstractTableModel( parent ),
+      d( new Private )
+{
+}
+
+TickResamplingModel::~TickResamplingModel()
+{
+    delete d;
+}
+
+void TickResamplingModel::setSourceModel( QAbstractItemModel* sourceModel )
+{
+    if ( d->sourceModel == sourceModel ) {
+        return;
+    }
+    if ( d->sourceModel ) {
+        disconnect( d->sourceModel, nullptr, this, nullptr );
+    }
+    d->sourceModel = sourceModel;
+    if ( sourceModel ) {
+        connect( sourceModel, SIGNAL(rowsInserted(QModelIndex,int,int)),
+                 this, SLOT(slotRowsInserted(QModelIndex,int,int)) );
+        connect( sourceModel, SIGNAL(dataChanged(QModelIndex,QModelIndex)),
+                 this, SLOT(rebuild()) );
+        connect( sourceModel, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+                 this, SLOT(rebuild()) );
+        connect( sourceModel, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
+                 this, SLOT(rebuild()) );
+        connect( sourceModel, SIGNAL(columnsInserted(QModelIndex,int,int)),
+                 this, SLOT(rebuild()) );
+        connect( sourceModel, SIGNAL(columnsRemoved(QModelIndex,int,int)),
+                 this, SLOT(rebuild()) );
+        connect( sourceModel, SIGNAL(layoutChanged()),
+                 this, SLOT(rebuild()) );
+        connect( sourceModel, SIGNAL(modelReset()),
+                 this, SLOT(rebuild()) );
+        connect( sourceModel, SIGNAL(destroyed()),
+                 this, SLOT(slotSourceModelDestroyed()) );
+    }
+    rebuild();
+}
+
+QAbstractItemModel* TickResamplingModel::sourceModel() const
+{
+    return d->sourceModel;
+}
+
+void TickResamplingModel::setTimeColumn( int column )
+{
+    if ( d->timeColumn != column ) {
+        d->timeColumn = column;
+        rebuild();
+    }
+}
+
+int TickResamplingModel::timeColumn() const
+{
+    return d->timeColumn;
+}
+
+void TickResamplingModel::setPriceColumn( int column )
+{
+    if ( d->priceColumn != column ) {
+        d->priceColumn = column;
+        rebuild();
+    }
+}
+
+int TickResamplingModel::priceColumn() const
+{
+    return d->priceColumn;
+}
+
+void TickResamplingModel::setVolumeColumn( int column )
+{
+    if ( d->volumeColumn != column ) {
+        d->volumeColumn = column;
+        rebuild();
+    }
+}
+
+int TickResamplingModel::volumeColumn() const
+{
+    return d->volumeColumn;
+}
+
+void TickResamplingModel::setStockType( StockDiagram::Type type )
+{
+    if ( d->stockType != type ) {
+        beginResetModel();
+        d->stockType = type;
+        endResetModel();
+    }
+}
+
+StockDiagram::Type TickResamplingModel::stockType() const
+{
+    return d->stockType;
+}
+
+void TickResamplingModel::setBaseInterval( qreal interval )
+{
+    if ( interval > 0.0 && d->baseInterval != interval ) {
+        d->baseInterval = interval;
+        rebuild();
+    }
+}
+
+qreal TickResamplingModel::baseInterval() const
+{
+    return d->baseInterval;
+}
+
+qreal TickResamplingModel::interval() const
+{
+    return d->interval();
+}
+
+void TickResamplingModel::setMaximumBucketCount( int count )
+{
+    count = qMax( 0, count );
+    if ( d->maximumBucketCount != count ) {
+        d->maximumBucketCount = count;
+        rebuild();
+    }
+}
+
+int TickResamplingModel::maximumBucketCount() const
+{
+    return d->maximumBucketCount;
+}
+
+void TickResamplingModel::setPixelsPerBucket( int pixels )
+{
+    d->pixelsPerBucket = qMax( 0, pixels );
+}
+
+int TickResamplingModel::pixelsPerBucket() const
+{
+    return d->pixelsPerBucket;
+}
+
+qreal TickResamplingModel::bucketStart( int row ) const
+{
+    return d->buckets.at( row ).index * d->interval();
+}
+
+qreal TickResamplingModel::bucketVolume( int row ) const
+{
+    return d->buckets.at( row ).volume;
+}
+
+int TickResamplingModel::bucketTickCount( int row ) const
+{
+    return d->buckets.at( row ).tickCount;
+}
+
+int TickResamplingModel::rowCount( const QModelIndex& parent ) const
+{
+    return parent.isValid() ? 0 : d->buckets.size();
+}
+
+int TickResamplingModel::columnCount( const QModelIndex& parent ) const
+{
+    if ( parent.isValid() ) {
+        return 0;
+    }
+    return d->stockType == StockDiagram::HighLowClose ? 3 : 4;
+}
+
+QVariant TickResamplingModel::data( const QModelIndex& index, int role ) const
+{
+    if ( !index.isValid() || ( role != Qt::DisplayRole && role != Qt::EditRole ) ) {
+        return QVariant();
+    }
+    return d->bucketValue( d->buckets.at( index.row() ), index.column() );
+}
+
+QVariant TickResamplingModel::headerData( int section, Qt::Orientation orientation, int role ) const
+{
+    if ( role != Qt::DisplayRole ) {
+        return QAbstractTableModel::headerData( section, orientation, role );
+    }
+    if ( orientation == Qt::Vertical ) {
+        if ( section >= 0 && section < d->buckets.size() ) {
+            return bucketStart( section );
+        }
+    } else {
+        const int column = d->stockType == StockDiagram::HighLowClose ? section + 1 : section;
+        switch ( column ) {
+        case 0: return tr( "Open" );
+        case 1: return tr( "High" );
+        case 2: return tr( "Low" );
+        case 3: return tr( "Close" );
+        }
+    }
+    return QAbstractTableModel::headerData( section, orientation, role );
+}
+
+void TickResamplingModel::slotRowsInserted( const QModelIndex& parent, int first, int last )
+{
+    if ( parent.isValid() ) {
+        return;
+    }
+    if ( first != d->processedRows ) {
+        // not appended, the ticks after the new ones would have to be redistributed
+        rebuild();
+        return;
+    }
+
+    // the ticks go into a copy of the last bucket and new buckets after it
+    const int oldCount = d->buckets.size();
+    QVector< Bucket > buckets;
+    if ( oldCount > 0 ) {
+        buckets.append( d->buckets.last() );
+    }
+    for ( int row = first; row <= last; ++row ) {
+        Tick tick;
+        if ( d->readTick( row, &tick ) && !d->appendTick( &buckets, tick ) ) {
+            rebuild();
+            return;
+        }
+    }
+    d->processedRows = last + 1;
+
+    const int reused = oldCount > 0 ? 1 : 0;
+    const int added = buckets.size() - reused;
+    if ( d->maximumBucketCount > 0 && oldCount + added > d->maximumBucketCount ) {
+        // the interval grows, which changes all buckets
+        beginResetModel();
+        d->buckets.resize( oldCount - reused );
+        d->buckets += buckets;
+        d->fitBuckets();
+        endResetModel();
+        return;
+    }
+
+    if ( reused && buckets.first().tickCount != d->buckets.last().tickCount ) {
+        d->buckets.last() = buckets.first();
+        emit dataChanged( index( oldCount - 1, 0 ), index( oldCount - 1, columnCount() - 1 ) );
+    }
+    if ( added > 0 ) {
+        beginInsertRows( QModelIndex(), oldCount, oldCount + added - 1 );
+        d->buckets += buckets.mid( reused );
+        endInsertRows();
+    }
+}
+
+void TickResamplingModel::slotSourceModelDestroyed()
+{
+    d->sourceModel = nullptr;
+    rebuild();
+}
+
+void TickResamplingModel::rebuild()
+{
+    beginResetModel();
+    d->buckets.clear();
+    d->intervalFactor = 1;
+    d->processedRows = 0;
+    if ( d->sourceModel ) {
+        const int rowCount = d->sourceModel->rowCount();
+        QVector< Tick > ticks;
+        ticks.reserve( rowCount );
+        for ( int row = 0; row < rowCount; ++row ) {
+            Tick tick;
+            if ( d->readTick( row, &tick ) ) {
+                ticks.append( tick );
+            }
+        }
+        // keeps the order of ticks with the same time, which decides about open and close
+        std::stable_sort( ticks.begin(), ticks.end() );
+        for ( const Tick& tick : qAsConst( ticks ) ) {
+            d->appendTick( &d->buckets, tick );
+            if ( d->maximumBucketCount > 0 && d->buckets.size() > d->maximumBucketCount ) {
+                d->fitBuckets();
+            }
+        }
+        d->processedRows = rowCount;
+    }
+    endResetModel();
+}
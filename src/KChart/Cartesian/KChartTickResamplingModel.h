@@ -0,0 +1,124 @@
+/**
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef KCHARTTICKRESAMPLINGMODEL_H
+#define KCHARTTICKRESAMPLINGMODEL_H
+
+#include <QAbstractTableModel>
+
+#include "KChartStockDiagram.h"
+
+namespace KChart {
+
+    /**
+     * \brief Aggregates tick data into buckets of open, high, low and close values for a StockDiagram.
+     *
+     * The source model contains one row per tick, with the time of the tick, its price and
+     * optionally its volume in the columns set with setTimeColumn(), setPriceColumn() and
+     * setVolumeColumn(). The time is either a number, e.g. seconds since some epoch, or a
+     * QDateTime. Ticks are expected in chronological order.
+     *
+     * Each row of this model is one bucket containing at least one tick, with the columns
+     * a StockDiagram of stockType() expects: open, high, low and close for
+     * OpenHighLowClose and Candlestick diagrams, high, low and close for HighLowClose ones.
+     * The buckets start at multiples of interval(), which is baseInterval() unless
+     * maximumBucketCount() is set: then it is doubled until the ticks fit into that many
+     * buckets.
+     *
+     * Ticks appended to the source model are added to the buckets as they arrive, so that
+     * only the last bucket and the new ones are announced as changed. Any other change
+     * of the source model rebuilds all buckets.
+     *
+     * \code
+     * KChart::TickResamplingModel resampler;
+     * resampler.setSourceModel( ticks );
+     * resampler.setBaseInterval( 60.0 ); // one minute candles at least
+     * resampler.setPixelsPerBucket( 6 ); // but no more than fit into the diagram
+     * stockDiagram->setModel( &resampler );
+     * \endcode
+     */
+class KCHART_EXPORT TickResamplingModel : public QAbstractTableModel
+{
+    Q_OBJECT
+    Q_DISABLE_COPY( TickResamplingModel )
+    class Private;
+public:
+    explicit TickResamplingModel( QObject* parent = nullptr );
+    ~TickResamplingModel();
+
+    void setSourceModel( QAbstractItemModel* sourceModel );
+    QAbstractItemModel* sourceModel() const;
+
+    /** The columns of the source model with the time, price and volume of the ticks.
+     *  The defaults are 0, 1 and 2. Set the volume column to -1 if there is none. */
+    void setTimeColumn( int column );
+    int timeColumn() const;
+    void setPriceColumn( int column );
+    int priceColumn() const;
+    void setVolumeColumn( int column );
+    int volumeColumn() const;
+
+    /** The kind of StockDiagram that is fed, which determines the columns of this model.
+     *  The default is StockDiagram::OpenHighLowClose. */
+    void setStockType( StockDiagram::Type type );
+    StockDiagram::Type stockType() const;
+
+    /** The shortest time span covered by one bucket, in the unit of the time column
+     *  (seconds for QDateTime times). The default is 1.0. */
+    void setBaseInterval( qreal interval );
+    qreal baseInterval() const;
+
+    /** The time span currently covered by one bucket. */
+    qreal interval() const;
+
+    /** The maximum number of buckets, 0 for no limit. This is the default. */
+    int maximumBucketCount() const;
+
+    /** If not 0, a StockDiagram using this model sets maximumBucketCount() to its width
+     *  divided by \a pixels. The default is 0. */
+    void setPixelsPerBucket( int pixels );
+    int pixelsPerBucket() const;
+
+    /** \return The start time of the bucket in \a row. */
+    qreal bucketStart( int row ) const;
+    /** \return The summed up volume of the ticks in the bucket in \a row. */
+    qreal bucketVolume( int row ) const;
+    /** \return The number of ticks in the bucket in \a row. */
+    int bucketTickCount( int row ) const;
+
+    int rowCount( const QModelIndex& parent = QModelIndex() ) const override;
+    int columnCount( const QModelIndex& parent = QModelIndex() ) const override;
+    QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const override;
+    QVariant headerData( int section, Qt::Orientation orientation, int role = Qt::DisplayRole ) const override;
+
+public Q_SLOTS:
+    void setMaximumBucketCount( int count );
+
+private Q_SLOTS:
+    void slotRowsInserted( const QModelIndex& parent, int first, int last );
+    void slotSourceModelDestroyed();
+    void rebuild();
+
+private:
+    Private* const d;
+};
+
+}
+
+#endif // KCHARTTICKRESAMPLINGMODEL_H
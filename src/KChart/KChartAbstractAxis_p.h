@@ -64,7 +64,8 @@ public:
     }
     bool hasDiagram( AbstractDiagram* diagram ) const;
 
-    void updateLayouts();
+    // repaints the axis, axes with a place in the chart's layout re-lay it out as needed
+    virtual void updateLayouts();
 
     DiagramObserver* observer;
 
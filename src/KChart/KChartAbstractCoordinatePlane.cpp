@@ -76,8 +76,6 @@ void AbstractCoordinatePlane::addDiagram ( AbstractDiagram* diagram )
     layoutDiagrams();
     layoutPlanes(); // there might be new axes, etc
     connect( diagram, SIGNAL(modelsChanged()), this, SLOT(layoutPlanes()) );
-    connect( diagram, SIGNAL(modelDataChanged()), this, SLOT(update()) );
-    connect( diagram, SIGNAL(modelDataChanged()), this, SLOT(relayout()) );
     connect( this, SIGNAL(boundariesChanged()), diagram, SIGNAL(boundariesChanged()) );
 
     update();
@@ -114,9 +112,8 @@ void AbstractCoordinatePlane::takeDiagram ( AbstractDiagram* diagram )
         diagram->setParent( nullptr );
         diagram->setCoordinatePlane( nullptr );
         disconnect( diagram, SIGNAL(modelsChanged()), this, SLOT(layoutPlanes()) );
-        disconnect( diagram, SIGNAL(modelDataChanged()), this, SLOT(update()) );
-        disconnect( diagram, SIGNAL(modelDataChanged()), this, SLOT(relayout()) );
         layoutDiagrams();
+        layoutPlanes(); // the axes of the diagram are gone
         update();
     }
 }
@@ -172,7 +169,11 @@ void KChart::AbstractCoordinatePlane::setGridNeedsRecalculate()
 
 void KChart::AbstractCoordinatePlane::setReferenceCoordinatePlane( AbstractCoordinatePlane * plane )
 {
+    if ( d->referenceCoordinatePlane == plane ) {
+        return;
+    }
     d->referenceCoordinatePlane = plane;
+    layoutPlanes(); // planes sharing axes share a layout
 }
 
 AbstractCoordinatePlane * KChart::AbstractCoordinatePlane::referenceCoordinatePlane( ) const
@@ -251,6 +252,11 @@ void KChart::AbstractCoordinatePlane::update()
     emit needUpdate();
 }
 
+void KChart::AbstractCoordinatePlane::update( const QRect& rect )
+{
+    emit needPartialUpdate( rect );
+}
+
 void KChart::AbstractCoordinatePlane::relayout()
 {
     //qDebug("KChart::AbstractCoordinatePlane::relayout() called");
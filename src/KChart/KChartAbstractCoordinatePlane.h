@@ -303,6 +303,11 @@ namespace KChart {
           * Calling update() on the plane triggers the global KChart::Chart::update()
           */
         void update();
+        /**
+          * Repaints only \a rect of the chart, in the coordinates of the chart. This is used
+          * when the data of a diagram changed without affecting the axes or the layout.
+          */
+        void update( const QRect& rect );
         /**
           * Calling relayout() on the plane triggers the global KChart::Chart::slotRelayout()
           */
@@ -323,6 +328,9 @@ namespace KChart {
         /** Emitted when plane needs to update its drawings. */
         void needUpdate();
 
+        /** Emitted when only \a rect of the chart needs to be repainted. */
+        void needPartialUpdate( const QRect& rect );
+
         /** Emitted when plane needs to trigger the Chart's layouting. */
         void needRelayout();
 
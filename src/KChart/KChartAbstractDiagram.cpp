@@ -36,6 +36,7 @@
 #include "KChartAbstractThreeDAttributes.h"
 #include "KChartThreeDLineAttributes.h"
 #include "KChartPainterSaver_p.h"
+#include "KChartPerfObserver_p.h"
 
 #include <limits>
 
@@ -60,6 +61,7 @@ void AbstractDiagram::init()
 {
     _d->diagram = this;
     d->reverseMapper.setDiagram( this );
+    connect( this, SIGNAL(propertiesChanged()), this, SLOT(slotPropertiesChanged()) );
 }
 
 
@@ -113,6 +115,7 @@ AbstractCoordinatePlane* AbstractDiagram::coordinatePlane() const
 const QPair<QPointF, QPointF> AbstractDiagram::dataBoundaries () const
 {
     if ( d->databoundariesDirty ) {
+        const PerfPhaseTimer perfTimer( PerfObserver::DataBoundariesPhase, this );
         d->databoundaries = calculateDataBoundaries ();
         d->databoundariesDirty = false;
     }
@@ -122,6 +125,9 @@ const QPair<QPointF, QPointF> AbstractDiagram::dataBoundaries () const
 void AbstractDiagram::setDataBoundariesDirty() const
 {
     d->databoundariesDirty = true;
+    ++d->revision;
+    d->undamagedBoundariesValid = false;
+    d->percentRowSums.clear();
     update();
 }
 
@@ -246,10 +252,62 @@ void AbstractDiagram::dataChanged( const QModelIndex &topLeft,
                                    const QModelIndex &bottomRight,
                                    const QVector<int> & )
 {
-    Q_UNUSED( topLeft );
-    Q_UNUSED( bottomRight );
-    // We are still too dumb to do intelligent updates...
-    setDataBoundariesDirty();
+    // Only the changed rows need their percent sums recalculated, the data
+    // boundaries and the repaint are taken care of in slotModelDataChanged()
+    const int lastRow = qMin( bottomRight.row(), d->percentRowSums.size() - 1 );
+    for ( int row = qMax( topLeft.row(), 0 ); row <= lastRow; ++row )
+        d->percentRowSums[ row ] = std::numeric_limits< qreal >::quiet_NaN();
+}
+
+void AbstractDiagram::slotModelDataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight )
+{
+    // Whether the data boundaries changed can only be told once everybody else, e.g. the
+    // data compressor, has seen the change, so the repaint is decided on later.
+    if ( !d->damageRepaintScheduled ) {
+        d->undamagedBoundariesValid = !d->databoundariesDirty;
+        d->undamagedBoundaries = d->databoundaries;
+        d->damagedFirstRow = topLeft.row();
+        d->damagedLastRow = bottomRight.row();
+        d->damageRepaintScheduled = true;
+        QMetaObject::invokeMethod( this, "slotRepaintDamagedRows", Qt::QueuedConnection );
+    } else {
+        d->damagedFirstRow = qMin( d->damagedFirstRow, topLeft.row() );
+        d->damagedLastRow = qMax( d->damagedLastRow, bottomRight.row() );
+    }
+    d->databoundariesDirty = true;
+    ++d->revision;
+    emit modelDataChanged();
+}
+
+void AbstractDiagram::slotPropertiesChanged()
+{
+    ++d->revision;
+}
+
+void AbstractDiagram::slotRepaintDamagedRows()
+{
+    if ( !d->damageRepaintScheduled ) {
+        return;
+    }
+    d->damageRepaintScheduled = false;
+    if ( !d->plane ) {
+        return;
+    }
+
+    // Changes spanning all rows are most likely changed dataset attributes, which may
+    // affect the legend, so they are never treated as local.
+    const int rowCount = d->attributesModel->rowCount( attributesModelRootIndex() );
+    const bool wholeDataset = d->damagedFirstRow <= 0 && d->damagedLastRow >= rowCount - 1;
+    if ( !wholeDataset && d->undamagedBoundariesValid && dataBoundaries() == d->undamagedBoundaries ) {
+        // the axes, grid and layout stay the same, only the changed rows need repainting
+        const QRect damaged = d->damagedRect( d->damagedFirstRow, d->damagedLastRow );
+        if ( damaged.isValid() ) {
+            d->plane->update( damaged );
+            return;
+        }
+    }
+    d->plane->update();
+    d->plane->relayout();
     scheduleDelayedItemsLayout();
 }
 
@@ -437,24 +495,7 @@ void AbstractDiagram::paintMarker( QPainter* painter,
 
     const PainterSaver painterSaver( painter );
 
-    QSizeF maSize = ma.markerSize();
-    const qreal diagramWidth = d->diagramSize.width();
-    const qreal diagramHeight = d->diagramSize.height();
-
-    switch( ma.markerSizeMode() ) {
-    case MarkerAttributes::AbsoluteSize:
-        // Unscaled, i.e. without the painter's "zoom"
-        maSize.rwidth()  /= painter->matrix().m11();
-        maSize.rheight() /= painter->matrix().m22();
-        break;
-    case MarkerAttributes::AbsoluteSizeScaled:
-        // Keep maSize as is. It is specified directly in pixels and desired
-        // to be effected by the painter's "zoom".
-        break;
-    case MarkerAttributes::RelativeToDiagramWidthHeightMin:
-        maSize *= qMin( diagramWidth, diagramHeight );
-        break;
-    }
+    const QSizeF maSize = d->markerSize( ma, painter );
 
     QBrush indexBrush( brush( index ) );
     QPen indexPen( ma.pen() );
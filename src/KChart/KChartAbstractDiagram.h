@@ -646,6 +646,11 @@ namespace KChart {
     protected Q_SLOTS:
         void setDataBoundariesDirty() const;
 
+    private Q_SLOTS:
+        void slotModelDataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight );
+        void slotRepaintDamagedRows();
+        void slotPropertiesChanged();
+
     protected:
         /**
          * \deprecated
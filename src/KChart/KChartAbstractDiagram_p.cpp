@@ -32,12 +32,17 @@
 
 #include "KChartBarDiagram.h"
 #include "KChartFrameAttributes.h"
+#include "KChartMath_p.h"
 #include "KChartPainterSaver_p.h"
+#include "KChartPerfObserver_p.h"
+#include "KChartTextMeasurementCache.h"
 
 #include <QAbstractTextDocumentLayout>
 #include <QTextBlock>
 #include <QApplication>
 
+#include <limits>
+
 
 using namespace KChart;
 
@@ -78,7 +83,14 @@ AbstractDiagram::Private::Private()
   , percent( false )
   , datasetDimension( 1 )
   , databoundariesDirty( true )
+  , revision( 0 )
+  , damagedFirstRow( -1 )
+  , damagedLastRow( -1 )
+  , undamagedBoundariesValid( false )
+  , damageRepaintScheduled( false )
+  , culledDataValueTexts( 0 )
   , mCachedFontMetrics( QFontMetrics( qApp->font() ) )
+  , mCachedPaintDevice( nullptr )
 {
 }
 
@@ -126,7 +138,11 @@ void AbstractDiagram::Private::setAttributesModel( AttributesModel* amodel )
             disconnect( attributesModel, SIGNAL(layoutChanged()),
                         diagram, SLOT(setDataBoundariesDirty()) );
             disconnect( attributesModel, SIGNAL(dataChanged(QModelIndex,QModelIndex)),
-                        diagram, SIGNAL(modelDataChanged()));
+                        diagram, SLOT(slotModelDataChanged(QModelIndex,QModelIndex)) );
+            disconnect( attributesModel, SIGNAL(attributesChanged(QModelIndex,QModelIndex)),
+                        diagram, SLOT(slotPropertiesChanged()) );
+            disconnect( attributesModel, SIGNAL(headerDataChanged(Qt::Orientation,int,int)),
+                        diagram, SLOT(slotPropertiesChanged()) );
         }
     }
 
@@ -145,7 +161,12 @@ void AbstractDiagram::Private::setAttributesModel( AttributesModel* amodel )
     connect( amodel, SIGNAL(layoutChanged()),
              diagram, SLOT(setDataBoundariesDirty()) );
     connect( amodel, SIGNAL(dataChanged(QModelIndex,QModelIndex)),
-             diagram, SIGNAL(modelDataChanged()));
+             diagram, SLOT(slotModelDataChanged(QModelIndex,QModelIndex)) );
+    // pens, brushes and other attributes cached by the diagram are tied to the revision
+    connect( amodel, SIGNAL(attributesChanged(QModelIndex,QModelIndex)),
+             diagram, SLOT(slotPropertiesChanged()) );
+    connect( amodel, SIGNAL(headerDataChanged(Qt::Orientation,int,int)),
+             diagram, SLOT(slotPropertiesChanged()) );
 
     attributesModel = amodel;
 }
@@ -161,18 +182,33 @@ AbstractDiagram::Private::Private( const AbstractDiagram::Private& rhs ) :
     antiAliasing( rhs.antiAliasing ),
     percent( rhs.percent ),
     datasetDimension( rhs.datasetDimension ),
-    mCachedFontMetrics( rhs.cachedFontMetrics() )
+    revision( 0 ),
+    damagedFirstRow( -1 ),
+    damagedLastRow( -1 ),
+    undamagedBoundariesValid( false ),
+    damageRepaintScheduled( false ),
+    culledDataValueTexts( 0 ),
+    mCachedFontMetrics( rhs.cachedFontMetrics() ),
+    mCachedFont( rhs.mCachedFont ),
+    mCachedPaintDevice( rhs.mCachedPaintDevice )
 {
     attributesModel = new PrivateAttributesModel( nullptr, nullptr);
     attributesModel->initFrom( rhs.attributesModel );
 }
 
-// FIXME: Optimize if necessary
 qreal AbstractDiagram::Private::calcPercentValue( const QModelIndex & index ) const
 {
-    qreal sum = 0.0;
-    for ( int col = 0; col < attributesModel->columnCount( QModelIndex() ); col++ )
-        sum += attributesModel->data( attributesModel->index( index.row(), col, QModelIndex() ) ).toReal(); // checked
+    const int rowCount = attributesModel->rowCount( QModelIndex() );
+    if ( percentRowSums.size() != rowCount )
+        percentRowSums.fill( std::numeric_limits< qreal >::quiet_NaN(), rowCount );
+    // every label of a row needs the same sum, so only add up the row once
+    qreal sum = index.row() >= 0 && index.row() < rowCount ? percentRowSums.at( index.row() ) : 0.0;
+    if ( ISNAN( sum ) ) {
+        sum = 0.0;
+        for ( int col = 0; col < attributesModel->columnCount( QModelIndex() ); col++ )
+            sum += attributesModel->data( attributesModel->index( index.row(), col, QModelIndex() ) ).toReal(); // checked
+        percentRowSums[ index.row() ] = sum;
+    }
     if ( sum == 0.0 )
         return 0.0;
     return attributesModel->data( attributesModel->mapFromSource( index ) ).toReal() / sum * 100.0;
@@ -240,18 +276,13 @@ void AbstractDiagram::Private::addLabel(
 
         // get the size of the label text using a subset of the information going into the final layout
         const QString text = formatDataValueText( dva, index, value );
-        QTextDocument doc;
-        doc.setDocumentMargin( 0 );
-        if ( Qt::mightBeRichText( text ) ) {
-            doc.setHtml( text );
-        } else {
-            doc.setPlainText( text );
-        }
         const QFont calculatedFont( dva.textAttributes()
                                     .calculatedFont( plane, KChartEnums::MeasureOrientationMinimum ) );
-        doc.setDefaultFont( calculatedFont );
-
-        const QRectF plainRect = doc.documentLayout()->frameBoundingRect( doc.rootFrame() );
+        const TextMeasurementCache::Layout layout = Qt::mightBeRichText( text )
+                                                    ? TextMeasurementCache::RichTextDocumentLayout
+                                                    : TextMeasurementCache::PlainTextDocumentLayout;
+        const QRectF plainRect( QPointF( 0.0, 0.0 ),
+                                TextMeasurementCache::instance()->textSize( text, calculatedFont, layout ) );
 
         /*
         * A few hints on how the positioning of the text frame is done:
@@ -340,7 +371,8 @@ const QFontMetrics* AbstractDiagram::Private::cachedFontMetrics( const QFont& fo
 {
     if ( ( font != mCachedFont ) || ( paintDevice != mCachedPaintDevice ) ) {
         mCachedFontMetrics = QFontMetrics( font, const_cast<QPaintDevice *>( paintDevice ) );
-        // TODO what about setting mCachedFont and mCachedPaintDevice?
+        mCachedFont = font;
+        mCachedPaintDevice = const_cast<QPaintDevice *>( paintDevice );
     }
     return &mCachedFontMetrics;
 }
@@ -376,6 +408,7 @@ void AbstractDiagram::Private::forgetAlreadyPaintedDataValues()
 {
     alreadyDrawnDataValueTexts.clear();
     prevPaintedDataValueText.clear();
+    culledDataValueTexts = 0;
 }
 
 void AbstractDiagram::Private::paintDataValueTextsAndMarkers(
@@ -388,6 +421,7 @@ void AbstractDiagram::Private::paintDataValueTextsAndMarkers(
     if ( justCalculateRect && !cumulatedBoundingRect ) {
         qWarning() << Q_FUNC_INFO << "Neither painting nor finding the bounding rect, what are we doing?";
     }
+    const PerfPhaseTimer perfTimer( PerfObserver::LabelLayoutPhase, diagram );
 
     const PainterSaver painterSaver( ctx->painter() );
     ctx->painter()->setClipping( false );
@@ -435,6 +469,7 @@ void AbstractDiagram::Private::paintDataValueTextsAndMarkers(
     if ( cumulatedBoundingRect ) {
         *cumulatedBoundingRect = ctx->painter()->transform().inverted().mapRect( *cumulatedBoundingRect );
     }
+    perfReportCounter( PerfObserver::LabelsCulledCounter, diagram, culledDataValueTexts );
 }
 
 QString AbstractDiagram::Private::formatDataValueText( const DataValueAttributes &dva,
@@ -543,6 +578,7 @@ void AbstractDiagram::Private::paintDataValueText(
             if ( alreadyDrawnDataValueTexts.at( i ).intersects( path ) ) {
                 // qDebug() << "not painting this label due to overlap";
                 drawIt = false;
+                ++culledDataValueTexts;
                 break;
             }
         }
@@ -583,6 +619,27 @@ void AbstractDiagram::Private::paintDataValueText(
     }
 }
 
+QSizeF AbstractDiagram::Private::markerSize( const MarkerAttributes& markerAttributes,
+                                            const QPainter* painter ) const
+{
+    QSizeF maSize = markerAttributes.markerSize();
+    switch( markerAttributes.markerSizeMode() ) {
+    case MarkerAttributes::AbsoluteSize:
+        // Unscaled, i.e. without the painter's "zoom"
+        maSize.rwidth()  /= painter->matrix().m11();
+        maSize.rheight() /= painter->matrix().m22();
+        break;
+    case MarkerAttributes::AbsoluteSizeScaled:
+        // Keep maSize as is. It is specified directly in pixels and desired
+        // to be effected by the painter's "zoom".
+        break;
+    case MarkerAttributes::RelativeToDiagramWidthHeightMin:
+        maSize *= qMin( diagramSize.width(), diagramSize.height() );
+        break;
+    }
+    return maSize;
+}
+
 QModelIndex AbstractDiagram::Private::indexAt( const QPoint& point ) const
 {
     QModelIndexList l = indexesAt( point );
@@ -647,6 +704,13 @@ void AbstractDiagram::Private::resetDatasetAttrs( int dataset, int role )
     attributesModel->resetHeaderData( column, Qt::Horizontal, role );
 }
 
+QRect AbstractDiagram::Private::damagedRect( int firstRow, int lastRow ) const
+{
+    Q_UNUSED( firstRow );
+    Q_UNUSED( lastRow );
+    return QRect();
+}
+
 bool AbstractDiagram::Private::isTransposed() const
 {
      // Determine the diagram that specifies the orientation.
@@ -34,6 +34,7 @@
 #include "KChartAbstractDiagram.h"
 #include "KChartAbstractCoordinatePlane.h"
 #include "KChartDataValueAttributes.h"
+#include "KChartMarkerAttributes.h"
 #include "KChartBackgroundAttributes.h"
 #include "KChartRelativePosition.h"
 #include "KChartPosition.h"
@@ -46,6 +47,7 @@
 #include <QMap>
 #include <QPoint>
 #include <QPointer>
+#include <QVector>
 #include <QFont>
 #include <QFontMetrics>
 #include <QPaintDevice>
@@ -155,6 +157,12 @@ namespace KChart {
             return attributesModel->columnCount( attributesModelRootIndex ) / datasetDimension;
         }
 
+        /**
+         * \return The size of the markers painted with \a markerAttributes by \a painter,
+         * taking the marker size mode into account.
+         */
+        QSizeF markerSize( const MarkerAttributes& markerAttributes, const QPainter* painter ) const;
+
         virtual QModelIndex indexAt( const QPoint& point ) const;
 
         QModelIndexList indexesAt( const QPoint& point ) const;
@@ -186,6 +194,13 @@ namespace KChart {
          */
         bool isTransposed() const;
 
+        /**
+         * \return The part of the chart, in chart coordinates, that needs to be repainted after
+         * the data in rows \a firstRow to \a lastRow changed without changing the data boundaries.
+         * An invalid rectangle means that everything needs to be repainted.
+         */
+        virtual QRect damagedRect( int firstRow, int lastRow ) const;
+
         static Private* get( AbstractDiagram *diagram ) { return diagram->_d; }
 
         AbstractDiagram* diagram;
@@ -207,12 +222,26 @@ namespace KChart {
         int datasetDimension;
         mutable QPair<QPointF,QPointF> databoundaries;
         mutable bool databoundariesDirty;
+        // incremented whenever the data or the attributes change, so that derived classes
+        // can tell whether what they cached from them is still valid
+        mutable uint revision;
+        // row sums used by calcPercentValue(), NaN if not calculated yet
+        mutable QVector<qreal> percentRowSums;
+        // The rows changed since the last repaint, and the data boundaries from before the
+        // first of these changes: if they stay the same, only the damaged part is repainted.
+        int damagedFirstRow;
+        int damagedLastRow;
+        QPair<QPointF,QPointF> undamagedBoundaries;
+        mutable bool undamagedBoundariesValid;
+        bool damageRepaintScheduled;
 
         QMap< Qt::Orientation, QString > unitSuffix;
         QMap< Qt::Orientation, QString > unitPrefix;
         QMap< int, QMap< Qt::Orientation, QString > > unitSuffixMap;
         QMap< int, QMap< Qt::Orientation, QString > > unitPrefixMap;
         QList< QPainterPath > alreadyDrawnDataValueTexts;
+        // data value texts left out because they overlapped others, for PerfObserver
+        int culledDataValueTexts;
 
     private:
         QString prevPaintedDataValueText;
@@ -21,11 +21,14 @@
 
 #include "KChartPalette.h"
 #include "KChartGlobal.h"
+#include "KChartDatasetSelectionProxyModel.h"
+#include "KChartSharedModelDataCache_p.h"
 #include "KChartMath_p.h"
 
 #include <QDebug>
 #include <QPen>
 #include <QPointer>
+#include <QSharedPointer>
 
 #include <KChartTextAttributes.h>
 #include <KChartFrameAttributes.h>
@@ -60,6 +63,11 @@ public:
     int dataDimension;
     AttributesModel::PaletteType paletteType;
     Palette palette;
+    // the source model, if its cells can be read without creating an index for them
+    QPointer< DatasetSelectionProxyModel > datasetSelection;
+    // keeps the values of the source model shared by the diagrams showing it, see
+    // CartesianDiagramDataCompressor
+    QSharedPointer< SharedModelDataCache > valueCache;
 };
 
 AttributesModel::Private::Private()
@@ -88,7 +96,12 @@ AttributesModel::~AttributesModel()
 
 void AttributesModel::initFrom( const AttributesModel* other )
 {
+    // the attributes are copied, the source model stays
+    const QPointer< DatasetSelectionProxyModel > datasetSelection = d->datasetSelection;
+    const QSharedPointer< SharedModelDataCache > valueCache = d->valueCache;
     *d = *other->d;
+    d->datasetSelection = datasetSelection;
+    d->valueCache = valueCache;
 }
 
 bool AttributesModel::compareHeaderDataMaps( const QMap< int, QMap< int, QVariant > >& mapA,
@@ -334,22 +347,23 @@ QVariant AttributesModel::data( const QModelIndex& index, int role ) const
     }
 
     if ( index.isValid() ) {
-        const QVariant sourceData = sourceModel()->data( mapToSource( index ), role );
+        const QVariant sourceData = d->datasetSelection
+                                    ? d->datasetSelection->data( index.row(), index.column(), role )
+                                    : sourceModel()->data( mapToSource( index ), role );
         if ( sourceData.isValid() ) {
             return sourceData;
         }
     }
 
     // check if we are storing a value for this role at this cell index
-    if ( d->dataMap.contains( index.column() ) ) {
-        const QMap< int,  QMap< int, QVariant > >& colDataMap = d->dataMap[ index.column() ];
-        if ( colDataMap.contains( index.row() ) ) {
-            const QMap< int, QVariant >& dataMap = colDataMap[ index.row() ];
-            if ( dataMap.contains( role ) ) {
-                const QVariant v = dataMap[ role ];
-                if ( v.isValid() ) {
-                    return v;
-                }
+    // (only const lookups here, diagrams may be painted in several threads at once)
+    const QMap< int, QMap< int, QMap< int, QVariant > > >::const_iterator colIt = d->dataMap.constFind( index.column() );
+    if ( colIt != d->dataMap.constEnd() ) {
+        const QMap< int, QMap< int, QVariant > >::const_iterator rowIt = colIt->constFind( index.row() );
+        if ( rowIt != colIt->constEnd() ) {
+            const QVariant v = rowIt->value( role );
+            if ( v.isValid() ) {
+                return v;
             }
         }
     }
@@ -469,6 +483,13 @@ void AttributesModel::setPaletteType( AttributesModel::PaletteType type )
     default:
         qWarning( "Unknown palette type!" );
     }
+    // the brushes and pens of all datasets that have none set explicitly change
+    const int numRows = rowCount( QModelIndex() );
+    const int numCols = columnCount( QModelIndex() );
+    if ( sourceModel() && numRows > 0 && numCols > 0 ) {
+        emit attributesChanged( index( 0, 0, QModelIndex() ),
+                                index( numRows - 1, numCols - 1, QModelIndex() ) );
+    }
 }
 
 AttributesModel::PaletteType AttributesModel::paletteType() const
@@ -540,7 +561,11 @@ void AttributesModel::setSourceModel( QAbstractItemModel* sourceModel )
         disconnect( this->sourceModel(), SIGNAL(layoutChanged()),
                                    this, SIGNAL(layoutChanged()) );
     }
+    // attached before connecting below, so the cache learns of changes of the source first
+    d->valueCache = sourceModel ? SharedModelDataCache::attach( sourceModel )
+                                : QSharedPointer< SharedModelDataCache >();
     QAbstractProxyModel::setSourceModel( sourceModel );
+    d->datasetSelection = qobject_cast< DatasetSelectionProxyModel* >( sourceModel );
     if ( this->sourceModel() != nullptr )
     {
         connect( this->sourceModel(), SIGNAL(dataChanged(QModelIndex,QModelIndex)),
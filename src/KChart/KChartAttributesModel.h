@@ -74,7 +74,7 @@ public:
      * internally used ones. */
     bool isKnownAttributesRole( int role ) const;
 
-    /** Sets the palettetype used by this attributesmodel */
+    /** Sets the palettetype used by this attributesmodel, emits attributesChanged() for all cells */
     void setPaletteType( PaletteType type );
     PaletteType paletteType() const;
 
@@ -34,7 +34,9 @@
 #include <QEvent>
 
 #include "KChartCartesianCoordinatePlane.h"
+#include "KChartCartesianCoordinatePlane_p.h"
 #include "KChartAbstractCartesianDiagram.h"
+#include "KChartDiagramLayers_p.h"
 #include "KChartHeaderFooter.h"
 #include "KChartEnums.h"
 #include "KChartLegend.h"
@@ -42,6 +44,7 @@
 #include <KChartTextAttributes.h>
 #include <KChartMarkerAttributes.h>
 #include "KChartPainterSaver_p.h"
+#include "KChartPerfObserver_p.h"
 #include "KChartPrintingParameters.h"
 
 #include <algorithm>
@@ -281,9 +284,15 @@ void Chart::Private::slotUnregisterDestroyedPlane( AbstractCoordinatePlane* plan
     plane->layoutPlanes();
 }
 
+void Chart::Private::slotPartialUpdate( const QRect& rect )
+{
+    chart->update( rect );
+}
+
 Chart::Private::Private( Chart* chart_ )
     : chart( chart_ )
     , useNewLayoutSystem( false )
+    , parallelPainting( false )
     , layout(nullptr)
     , vLayout(nullptr)
     , planesLayout(nullptr)
@@ -649,6 +658,7 @@ QHash<AbstractCoordinatePlane*, PlaneInfo> Chart::Private::buildPlaneLayoutInfos
 
 void Chart::Private::slotLayoutPlanes()
 {
+    const PerfPhaseTimer perfTimer( PerfObserver::LayoutPhase, chart );
     /*TODO make sure this is really needed */
     const QBoxLayout::Direction oldPlanesDirection = planesLayout ? planesLayout->direction()
                                                                   : QBoxLayout::TopToBottom;
@@ -662,6 +672,8 @@ void Chart::Private::slotLayoutPlanes()
 
     Q_FOREACH( AbstractLayoutItem* plane, planeLayoutItems ) {
         plane->removeFromParentLayout();
+        // the layouts are deleted below, and axes left out of the new ones must not refer to them
+        plane->setParentLayout( nullptr );
     }
     //TODO they should get a correct parent, but for now it works
     Q_FOREACH( AbstractLayoutItem* plane, planeLayoutItems ) {
@@ -1092,11 +1104,22 @@ void Chart::Private::slotResizePlanes()
 void Chart::Private::updateDirtyLayouts()
 {
     if ( isPlanesLayoutDirty ) {
+        // slotLayoutPlanes() rebuilds the layouts whenever planes, axes or diagrams come or go,
+        // so a new size only needs the existing layouts to distribute the space again
         Q_FOREACH ( AbstractCoordinatePlane* p, coordinatePlanes ) {
             p->setGridNeedsRecalculate();
-            p->layoutPlanes();
-            p->layoutDiagrams();
         }
+        Q_FOREACH ( AbstractLayoutItem* item, planeLayoutItems ) {
+            if ( CartesianAxis* axis = dynamic_cast< CartesianAxis* >( item ) ) {
+                axis->setCachedSizeDirty();
+            }
+        }
+        const PerfPhaseTimer perfTimer( PerfObserver::LayoutPhase, chart );
+        invalidateLayoutTree( layout );
+        if ( overrideSize.isValid() ) {
+            layout->setGeometry( QRect( QPoint( 0, 0 ), overrideSize ) );
+        }
+        slotResizePlanes();
     }
     if ( isPlanesLayoutDirty || isFloatingLegendsLayoutDirty ) {
         chart->reLayoutFloatingLegends();
@@ -1114,7 +1137,7 @@ void Chart::Private::reapplyInternalLayouts()
     slotResizePlanes();
 }
 
-void Chart::Private::paintAll( QPainter* painter )
+void Chart::Private::paintAll( QPainter* painter, const QRect& exposedRect )
 {
     updateDirtyLayouts();
 
@@ -1129,15 +1152,42 @@ void Chart::Private::paintAll( QPainter* painter )
 
     chart->reLayoutFloatingLegends();
 
+    // the diagrams only paint the data in the exposed part of the chart
+    Q_FOREACH( AbstractCoordinatePlane* plane, coordinatePlanes ) {
+        if ( CartesianCoordinatePlane* cartesianPlane = qobject_cast< CartesianCoordinatePlane* >( plane ) ) {
+            CartesianCoordinatePlane::Private::get( cartesianPlane )->exposedRect = exposedRect;
+        }
+    }
+    const bool paintLayers = parallelPainting && DiagramLayers::isSupported( painter );
+    if ( paintLayers ) {
+        DiagramLayers::paint( coordinatePlanes, painter );
+    }
+    // planes and axes stay inside of their geometry, so they can be left out when only a
+    // part of the chart is repainted
     Q_FOREACH( AbstractLayoutItem* planeLayoutItem, planeLayoutItems ) {
+        if ( exposedRect.isValid() && !exposedRect.intersects( planeLayoutItem->geometry() ) ) {
+            continue;
+        }
         planeLayoutItem->paintAll( *painter );
     }
+    if ( paintLayers ) {
+        DiagramLayers::discard( coordinatePlanes );
+    }
+    Q_FOREACH( AbstractCoordinatePlane* plane, coordinatePlanes ) {
+        if ( CartesianCoordinatePlane* cartesianPlane = qobject_cast< CartesianCoordinatePlane* >( plane ) ) {
+            CartesianCoordinatePlane::Private::get( cartesianPlane )->exposedRect = QRect();
+        }
+    }
+    // so do headers, footers and legends
     Q_FOREACH( TextArea* textLayoutItem, textLayoutItems ) {
+        if ( exposedRect.isValid() && !exposedRect.intersects( textLayoutItem->geometry() ) ) {
+            continue;
+        }
         textLayoutItem->paintAll( *painter );
     }
     Q_FOREACH( Legend *legend, legends ) {
         const bool hidden = legend->isHidden() && legend->testAttribute( Qt::WA_WState_ExplicitShowHide );
-        if ( !hidden ) {
+        if ( !hidden && ( !exposedRect.isValid() || exposedRect.intersects( legend->geometry() ) ) ) {
             //qDebug() << "painting legend at " << legend->geometry();
             legend->paintIntoRect( *painter, legend->geometry() );
         }
@@ -1245,6 +1295,7 @@ void Chart::insertCoordinatePlane( int index, AbstractCoordinatePlane* plane )
     connect( plane, SIGNAL(destroyedCoordinatePlane(AbstractCoordinatePlane*)),
              d,   SLOT(slotUnregisterDestroyedPlane(AbstractCoordinatePlane*)) );
     connect( plane, SIGNAL(needUpdate()),       this,   SLOT(update()) );
+    connect( plane, SIGNAL(needPartialUpdate(QRect)), d, SLOT(slotPartialUpdate(QRect)) );
     connect( plane, SIGNAL(needRelayout()),     d,      SLOT(slotResizePlanes()) ) ;
     connect( plane, SIGNAL(needLayoutPlanes()), d,      SLOT(slotLayoutPlanes()) ) ;
     connect( plane, SIGNAL(propertiesChanged()),this, SIGNAL(propertiesChanged()) );
@@ -1419,10 +1470,10 @@ void Chart::reLayoutFloatingLegends()
 }
 
 
-void Chart::paintEvent( QPaintEvent* )
+void Chart::paintEvent( QPaintEvent* event )
 {
     QPainter painter( this );
-    d->paintAll( &painter );
+    d->paintAll( &painter, event->rect() );
     emit finishedDrawing();
 }
 
@@ -1777,3 +1828,17 @@ void Chart::setUseNewLayoutSystem( bool value )
     if ( d_func()->useNewLayoutSystem != value )
         d_func()->useNewLayoutSystem = value;
 }
+
+bool Chart::isParallelPaintingEnabled() const
+{
+    return d_func()->parallelPainting;
+}
+
+void Chart::setParallelPaintingEnabled( bool enabled )
+{
+    if ( d_func()->parallelPainting == enabled ) {
+        return;
+    }
+    d_func()->parallelPainting = enabled;
+    update();
+}
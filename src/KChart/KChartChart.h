@@ -119,6 +119,28 @@ namespace KChart {
         bool useNewLayoutSystem() const;
         void setUseNewLayoutSystem( bool value );
 
+        /**
+         * \brief Paint the diagrams of cartesian coordinate planes in parallel.
+         *
+         * When enabled, every visible diagram of the chart's cartesian coordinate planes,
+         * including overlaid planes, is painted into an image of its own using the global
+         * QThreadPool. The images are then composited in the order the diagrams would have
+         * been painted in. Charts with many diagrams are painted faster on machines with
+         * several cores, at the cost of the memory for the images.
+         *
+         * Layers are only used when painting on a raster device like a widget or a QImage
+         * without rotation or scaling, otherwise the diagrams are painted directly as usual.
+         *
+         * \note The models of the diagrams are read from several threads at once while
+         * painting, so their data() and headerData() must be safe to call concurrently,
+         * which is the case for QStandardItemModel and most models that do not fetch
+         * data lazily.
+         *
+         * Disabled by default.
+         */
+        void setParallelPaintingEnabled( bool enabled );
+        bool isParallelPaintingEnabled() const;
+
         /**
           \brief Specify the frame attributes to be used, by default is it a thin black line.
 
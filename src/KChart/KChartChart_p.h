@@ -124,6 +124,7 @@ class Q_DECL_HIDDEN Chart::Private : public QObject
 
         enum AxisType { Abscissa, Ordinate };
         bool useNewLayoutSystem;
+        bool parallelPainting;
         CoordinatePlaneList coordinatePlanes;
         HeaderFooterList headerFooters;
         LegendList legends;
@@ -169,7 +170,8 @@ class Q_DECL_HIDDEN Chart::Private : public QObject
         void createLayouts();
         void updateDirtyLayouts();
         void reapplyInternalLayouts(); // TODO: see if this can be merged with updateDirtyLayouts()
-        void paintAll( QPainter* painter );
+        // \a exposedRect is the part of the chart that needs painting, all of it if invalid
+        void paintAll( QPainter* painter, const QRect& exposedRect = QRect() );
 
         struct AxisInfo {
             AxisInfo()
@@ -188,6 +190,7 @@ class Q_DECL_HIDDEN Chart::Private : public QObject
         void slotUnregisterDestroyedLegend( Legend * legend );
         void slotUnregisterDestroyedHeaderFooter( HeaderFooter* headerFooter );
         void slotUnregisterDestroyedPlane( AbstractCoordinatePlane* plane );
+        void slotPartialUpdate( const QRect& rect );
 };
 
 }
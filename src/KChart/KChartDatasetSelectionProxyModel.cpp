@@ -0,0 +1,572 @@
+/*
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "KChartDatasetSelectionProxyModel.h"
+
+#include <QPersistentModelIndex>
+#include <QVector>
+
+using namespace KChart;
+
+namespace {
+
+/*
+ * The selection of rows or of columns, as a table from proxy to source and one from source
+ * to proxy. Without a description, everything is passed through and both tables are empty.
+ */
+class DatasetMapping
+{
+public:
+    DatasetMapping()
+        : described( false )
+    {
+    }
+
+    void reset()
+    {
+        described = false;
+        sourceToProxy.clear();
+        proxyToSource.clear();
+    }
+
+    void describe( const DatasetDescriptionVector& configuration, int sourceCount )
+    {
+        described = true;
+        // the configuration is the proxy-to-source map, the way DatasetProxyModel reads it
+        proxyToSource = configuration;
+        sourceToProxy.fill( -1, sourceCount );
+        for ( int proxy = 0; proxy < configuration.count(); ++proxy ) {
+            const int source = configuration.at( proxy );
+            if ( source == -1 ) {
+                continue;
+            }
+            Q_ASSERT_X( source >= 0 && source < sourceCount,
+                        "DatasetSelectionProxyModel::describe",
+                        "column index outside of source model" );
+            Q_ASSERT_X( sourceToProxy.at( source ) == -1,
+                        "DatasetSelectionProxyModel::describe",
+                        "no duplicates allowed in mapping configuration, mapping has to be reversible" );
+            sourceToProxy[ source ] = proxy;
+        }
+    }
+
+    int count( int sourceCount ) const
+    {
+        return described ? proxyToSource.count() : sourceCount;
+    }
+
+    int toSource( int proxy ) const
+    {
+        if ( !described ) {
+            return proxy;
+        }
+        return proxy >= 0 && proxy < proxyToSource.count() ? proxyToSource.at( proxy ) : -1;
+    }
+
+    int toProxy( int source ) const
+    {
+        if ( !described ) {
+            return source;
+        }
+        return source >= 0 && source < sourceToProxy.count() ? sourceToProxy.at( source ) : -1;
+    }
+
+    // the smallest proxy range covering the selected ones of the source range
+    bool toProxyRange( int sourceFirst, int sourceLast, int* first, int* last ) const
+    {
+        if ( !described ) {
+            *first = sourceFirst;
+            *last = sourceLast;
+            return true;
+        }
+        *first = proxyToSource.count();
+        *last = -1;
+        const int end = qMin( sourceLast, sourceToProxy.count() - 1 );
+        for ( int source = qMax( sourceFirst, 0 ); source <= end; ++source ) {
+            const int proxy = sourceToProxy.at( source );
+            if ( proxy != -1 ) {
+                *first = qMin( *first, proxy );
+                *last = qMax( *last, proxy );
+            }
+        }
+        return *first <= *last;
+    }
+
+    void sourceInserted( int first, int last )
+    {
+        const int n = last - first + 1;
+        sourceToProxy.insert( qMin( first, sourceToProxy.count() ), n, -1 );
+        for ( int& source : proxyToSource ) {
+            if ( source >= first ) {
+                source += n;
+            }
+        }
+    }
+
+    // selected rows or columns that are removed disappear from the proxy
+    void sourceRemoved( int first, int last )
+    {
+        const int n = last - first + 1;
+        DatasetDescriptionVector remaining;
+        remaining.reserve( proxyToSource.count() );
+        for ( int source : qAsConst( proxyToSource ) ) {
+            if ( source < first || source == -1 ) {
+                remaining.append( source );
+            } else if ( source > last ) {
+                remaining.append( source - n );
+            }
+        }
+        proxyToSource = remaining;
+        sourceToProxy.fill( -1, qMax( sourceToProxy.count() - n, 0 ) );
+        for ( int proxy = 0; proxy < proxyToSource.count(); ++proxy ) {
+            const int source = proxyToSource.at( proxy );
+            if ( source >= 0 && source < sourceToProxy.count() ) {
+                sourceToProxy[ source ] = proxy;
+            }
+        }
+    }
+
+    bool described;
+    DatasetDescriptionVector sourceToProxy;
+    DatasetDescriptionVector proxyToSource;
+};
+
+}
+
+class Q_DECL_HIDDEN DatasetSelectionProxyModel::Private
+{
+public:
+    Private()
+        : resetPending( false )
+    {
+    }
+
+    DatasetMapping rows;
+    DatasetMapping columns;
+    QPersistentModelIndex rootIndex;
+    // a removal of selected rows or columns is announced as a reset
+    bool resetPending;
+};
+
+DatasetSelectionProxyModel::DatasetSelectionProxyModel( QObject* parent )
+    : QAbstractProxyModel( parent ),
+      d( new Private )
+{
+}
+
+DatasetSelectionProxyModel::~DatasetSelectionProxyModel()
+{
+    delete d;
+}
+
+void DatasetSelectionProxyModel::setSourceModel( QAbstractItemModel* sourceModel )
+{
+    if ( sourceModel == this->sourceModel() ) {
+        return;
+    }
+    beginResetModel();
+    if ( this->sourceModel() ) {
+        disconnect( this->sourceModel(), nullptr, this, nullptr );
+    }
+    QAbstractProxyModel::setSourceModel( sourceModel );
+    d->rows.reset();
+    d->columns.reset();
+    d->rootIndex = QModelIndex();
+    if ( sourceModel ) {
+        connect( sourceModel, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)),
+                 this, SLOT(slotDataChanged(QModelIndex,QModelIndex,QVector<int>)) );
+        connect( sourceModel, SIGNAL(headerDataChanged(Qt::Orientation,int,int)),
+                 this, SLOT(slotHeaderDataChanged(Qt::Orientation,int,int)) );
+        connect( sourceModel, SIGNAL(rowsAboutToBeInserted(QModelIndex,int,int)),
+                 this, SLOT(slotRowsAboutToBeInserted(QModelIndex,int,int)) );
+        connect( sourceModel, SIGNAL(rowsInserted(QModelIndex,int,int)),
+                 this, SLOT(slotRowsInserted(QModelIndex,int,int)) );
+        connect( sourceModel, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)),
+                 this, SLOT(slotRowsAboutToBeRemoved(QModelIndex,int,int)) );
+        connect( sourceModel, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+                 this, SLOT(slotRowsRemoved(QModelIndex,int,int)) );
+        connect( sourceModel, SIGNAL(columnsAboutToBeInserted(QModelIndex,int,int)),
+                 this, SLOT(slotColumnsAboutToBeInserted(QModelIndex,int,int)) );
+        connect( sourceModel, SIGNAL(columnsInserted(QModelIndex,int,int)),
+                 this, SLOT(slotColumnsInserted(QModelIndex,int,int)) );
+        connect( sourceModel, SIGNAL(columnsAboutToBeRemoved(QModelIndex,int,int)),
+                 this, SLOT(slotColumnsAboutToBeRemoved(QModelIndex,int,int)) );
+        connect( sourceModel, SIGNAL(columnsRemoved(QModelIndex,int,int)),
+                 this, SLOT(slotColumnsRemoved(QModelIndex,int,int)) );
+        // moves and layout changes are rare enough to be announced as resets
+        connect( sourceModel, SIGNAL(rowsAboutToBeMoved(QModelIndex,int,int,QModelIndex,int)),
+                 this, SLOT(slotSourceAboutToBeReset()) );
+        connect( sourceModel, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
+                 this, SLOT(slotSourceReset()) );
+        connect( sourceModel, SIGNAL(columnsAboutToBeMoved(QModelIndex,int,int,QModelIndex,int)),
+                 this, SLOT(slotSourceAboutToBeReset()) );
+        connect( sourceModel, SIGNAL(columnsMoved(QModelIndex,int,int,QModelIndex,int)),
+                 this, SLOT(slotSourceReset()) );
+        connect( sourceModel, SIGNAL(layoutAboutToBeChanged()),
+                 this, SLOT(slotSourceAboutToBeReset()) );
+        connect( sourceModel, SIGNAL(layoutChanged()),
+                 this, SLOT(slotSourceReset()) );
+        connect( sourceModel, SIGNAL(modelAboutToBeReset()),
+                 this, SLOT(slotSourceAboutToBeReset()) );
+        connect( sourceModel, SIGNAL(modelReset()),
+                 this, SLOT(slotSourceReset()) );
+        connect( sourceModel, SIGNAL(destroyed()),
+                 this, SLOT(slotSourceModelDestroyed()) );
+    }
+    endResetModel();
+}
+
+void DatasetSelectionProxyModel::setSourceRootIndex( const QModelIndex& rootIndex )
+{
+    Q_ASSERT( !rootIndex.isValid() || rootIndex.model() == sourceModel() );
+    beginResetModel();
+    d->rootIndex = rootIndex;
+    d->rows.reset();
+    d->columns.reset();
+    endResetModel();
+}
+
+QModelIndex DatasetSelectionProxyModel::sourceRootIndex() const
+{
+    return d->rootIndex;
+}
+
+int DatasetSelectionProxyModel::mapRowToSource( int row ) const
+{
+    return d->rows.toSource( row );
+}
+
+int DatasetSelectionProxyModel::mapRowFromSource( int sourceRow ) const
+{
+    return d->rows.toProxy( sourceRow );
+}
+
+int DatasetSelectionProxyModel::mapColumnToSource( int column ) const
+{
+    return d->columns.toSource( column );
+}
+
+int DatasetSelectionProxyModel::mapColumnFromSource( int sourceColumn ) const
+{
+    return d->columns.toProxy( sourceColumn );
+}
+
+void DatasetSelectionProxyModel::resetDatasetDescriptions()
+{
+    beginResetModel();
+    d->rows.reset();
+    d->columns.reset();
+    endResetModel();
+}
+
+void DatasetSelectionProxyModel::setDatasetRowDescriptionVector( const DatasetDescriptionVector& rowConfig )
+{
+    Q_ASSERT_X( sourceModel(), "DatasetSelectionProxyModel::setDatasetRowDescriptionVector",
+                "A source model must be set before the selection can be configured." );
+    beginResetModel();
+    d->rows.describe( rowConfig, sourceModel()->rowCount( d->rootIndex ) );
+    endResetModel();
+}
+
+void DatasetSelectionProxyModel::setDatasetColumnDescriptionVector( const DatasetDescriptionVector& columnConfig )
+{
+    Q_ASSERT_X( sourceModel(), "DatasetSelectionProxyModel::setDatasetColumnDescriptionVector",
+                "A source model must be set before the selection can be configured." );
+    beginResetModel();
+    d->columns.describe( columnConfig, sourceModel()->columnCount( d->rootIndex ) );
+    endResetModel();
+}
+
+void DatasetSelectionProxyModel::setDatasetDescriptionVectors( const DatasetDescriptionVector& rowConfig,
+                                                               const DatasetDescriptionVector& columnConfig )
+{
+    Q_ASSERT_X( sourceModel(), "DatasetSelectionProxyModel::setDatasetDescriptionVectors",
+                "A source model must be set before the selection can be configured." );
+    // one reset for both
+    beginResetModel();
+    d->rows.describe( rowConfig, sourceModel()->rowCount( d->rootIndex ) );
+    d->columns.describe( columnConfig, sourceModel()->columnCount( d->rootIndex ) );
+    endResetModel();
+}
+
+QVariant DatasetSelectionProxyModel::data( int row, int column, int role ) const
+{
+    const QAbstractItemModel* source = sourceModel();
+    const int sourceRow = d->rows.toSource( row );
+    const int sourceColumn = d->columns.toSource( column );
+    if ( !source || sourceRow < 0 || sourceColumn < 0 ) {
+        return QVariant();
+    }
+    return source->data( source->index( sourceRow, sourceColumn, d->rootIndex ), role );
+}
+
+QModelIndex DatasetSelectionProxyModel::mapFromSource( const QModelIndex& sourceIndex ) const
+{
+    if ( !sourceIndex.isValid() || !sourceModel() ) {
+        return QModelIndex();
+    }
+    Q_ASSERT( sourceIndex.model() == sourceModel() );
+    if ( sourceIndex.parent() != d->rootIndex ) {
+        return QModelIndex();
+    }
+    const int row = d->rows.toProxy( sourceIndex.row() );
+    const int column = d->columns.toProxy( sourceIndex.column() );
+    if ( row < 0 || column < 0 ) {
+        return QModelIndex();
+    }
+    return createIndex( row, column );
+}
+
+QModelIndex DatasetSelectionProxyModel::mapToSource( const QModelIndex& proxyIndex ) const
+{
+    if ( !proxyIndex.isValid() || !sourceModel() ) {
+        return QModelIndex();
+    }
+    Q_ASSERT( proxyIndex.model() == this );
+    const int sourceRow = d->rows.toSource( proxyIndex.row() );
+    const int sourceColumn = d->columns.toSource( proxyIndex.column() );
+    if ( sourceRow < 0 || sourceColumn < 0 ) {
+        return QModelIndex();
+    }
+    return sourceModel()->index( sourceRow, sourceColumn, d->rootIndex );
+}
+
+QModelIndex DatasetSelectionProxyModel::index( int row, int column, const QModelIndex& parent ) const
+{
+    if ( parent.isValid() || row < 0 || column < 0
+         || row >= rowCount() || column >= columnCount() ) {
+        return QModelIndex();
+    }
+    return createIndex( row, column );
+}
+
+QModelIndex DatasetSelectionProxyModel::parent( const QModelIndex& child ) const
+{
+    Q_UNUSED( child );
+    return QModelIndex();
+}
+
+bool DatasetSelectionProxyModel::hasChildren( const QModelIndex& parent ) const
+{
+    return !parent.isValid() && rowCount() > 0 && columnCount() > 0;
+}
+
+int DatasetSelectionProxyModel::rowCount( const QModelIndex& parent ) const
+{
+    if ( parent.isValid() || !sourceModel() ) {
+        return 0;
+    }
+    return d->rows.count( d->rows.described ? 0 : sourceModel()->rowCount( d->rootIndex ) );
+}
+
+int DatasetSelectionProxyModel::columnCount( const QModelIndex& parent ) const
+{
+    if ( parent.isValid() || !sourceModel() ) {
+        return 0;
+    }
+    return d->columns.count( d->columns.described ? 0 : sourceModel()->columnCount( d->rootIndex ) );
+}
+
+QVariant DatasetSelectionProxyModel::data( const QModelIndex& index, int role ) const
+{
+    if ( !index.isValid() ) {
+        return QVariant();
+    }
+    Q_ASSERT( index.model() == this );
+    return data( index.row(), index.column(), role );
+}
+
+bool DatasetSelectionProxyModel::setData( const QModelIndex& index, const QVariant& value, int role )
+{
+    const QModelIndex sourceIndex = mapToSource( index );
+    if ( !sourceIndex.isValid() ) {
+        return false;
+    }
+    return sourceModel()->setData( sourceIndex, value, role );
+}
+
+QVariant DatasetSelectionProxyModel::headerData( int section, Qt::Orientation orientation, int role ) const
+{
+    if ( !sourceModel() ) {
+        return QVariant();
+    }
+    const int sourceSection = orientation == Qt::Horizontal ? d->columns.toSource( section )
+                                                            : d->rows.toSource( section );
+    if ( sourceSection < 0 ) {
+        return QVariant();
+    }
+    return sourceModel()->headerData( sourceSection, orientation, role );
+}
+
+Qt::ItemFlags DatasetSelectionProxyModel::flags( const QModelIndex& index ) const
+{
+    const QModelIndex sourceIndex = mapToSource( index );
+    if ( !sourceIndex.isValid() ) {
+        return Qt::NoItemFlags;
+    }
+    return sourceModel()->flags( sourceIndex );
+}
+
+void DatasetSelectionProxyModel::slotDataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight,
+                                                  const QVector< int >& roles )
+{
+    if ( !topLeft.isValid() || !bottomRight.isValid() || topLeft.parent() != d->rootIndex ) {
+        return;
+    }
+    int firstRow, lastRow, firstColumn, lastColumn;
+    if ( !d->rows.toProxyRange( topLeft.row(), bottomRight.row(), &firstRow, &lastRow )
+         || !d->columns.toProxyRange( topLeft.column(), bottomRight.column(), &firstColumn, &lastColumn ) ) {
+        return;
+    }
+    emit dataChanged( createIndex( firstRow, firstColumn ), createIndex( lastRow, lastColumn ), roles );
+}
+
+void DatasetSelectionProxyModel::slotHeaderDataChanged( Qt::Orientation orientation, int first, int last )
+{
+    const DatasetMapping& mapping = orientation == Qt::Horizontal ? d->columns : d->rows;
+    int proxyFirst, proxyLast;
+    if ( mapping.toProxyRange( first, last, &proxyFirst, &proxyLast ) ) {
+        emit headerDataChanged( orientation, proxyFirst, proxyLast );
+    }
+}
+
+void DatasetSelectionProxyModel::slotRowsAboutToBeInserted( const QModelIndex& parent, int first, int last )
+{
+    if ( parent == d->rootIndex && !d->rows.described ) {
+        beginInsertRows( QModelIndex(), first, last );
+    }
+}
+
+void DatasetSelectionProxyModel::slotRowsInserted( const QModelIndex& parent, int first, int last )
+{
+    if ( parent != d->rootIndex ) {
+        return;
+    }
+    if ( d->rows.described ) {
+        // the new rows are not part of the selection, only the source rows behind it moved
+        d->rows.sourceInserted( first, last );
+    } else {
+        endInsertRows();
+    }
+}
+
+void DatasetSelectionProxyModel::slotRowsAboutToBeRemoved( const QModelIndex& parent, int first, int last )
+{
+    if ( parent != d->rootIndex ) {
+        return;
+    }
+    if ( !d->rows.described ) {
+        beginRemoveRows( QModelIndex(), first, last );
+        return;
+    }
+    int proxyFirst, proxyLast;
+    if ( d->rows.toProxyRange( first, last, &proxyFirst, &proxyLast ) ) {
+        d->resetPending = true;
+        beginResetModel();
+    }
+}
+
+void DatasetSelectionProxyModel::slotRowsRemoved( const QModelIndex& parent, int first, int last )
+{
+    if ( parent != d->rootIndex ) {
+        return;
+    }
+    if ( !d->rows.described ) {
+        endRemoveRows();
+        return;
+    }
+    d->rows.sourceRemoved( first, last );
+    if ( d->resetPending ) {
+        d->resetPending = false;
+        endResetModel();
+    }
+}
+
+void DatasetSelectionProxyModel::slotColumnsAboutToBeInserted( const QModelIndex& parent, int first, int last )
+{
+    if ( parent == d->rootIndex && !d->columns.described ) {
+        beginInsertColumns( QModelIndex(), first, last );
+    }
+}
+
+void DatasetSelectionProxyModel::slotColumnsInserted( const QModelIndex& parent, int first, int last )
+{
+    if ( parent != d->rootIndex ) {
+        return;
+    }
+    if ( d->columns.described ) {
+        d->columns.sourceInserted( first, last );
+    } else {
+        endInsertColumns();
+    }
+}
+
+void DatasetSelectionProxyModel::slotColumnsAboutToBeRemoved( const QModelIndex& parent, int first, int last )
+{
+    if ( parent != d->rootIndex ) {
+        return;
+    }
+    if ( !d->columns.described ) {
+        beginRemoveColumns( QModelIndex(), first, last );
+        return;
+    }
+    int proxyFirst, proxyLast;
+    if ( d->columns.toProxyRange( first, last, &proxyFirst, &proxyLast ) ) {
+        d->resetPending = true;
+        beginResetModel();
+    }
+}
+
+void DatasetSelectionProxyModel::slotColumnsRemoved( const QModelIndex& parent, int first, int last )
+{
+    if ( parent != d->rootIndex ) {
+        return;
+    }
+    if ( !d->columns.described ) {
+        endRemoveColumns();
+        return;
+    }
+    d->columns.sourceRemoved( first, last );
+    if ( d->resetPending ) {
+        d->resetPending = false;
+        endResetModel();
+    }
+}
+
+void DatasetSelectionProxyModel::slotSourceAboutToBeReset()
+{
+    beginResetModel();
+}
+
+void DatasetSelectionProxyModel::slotSourceReset()
+{
+    d->rows.reset();
+    d->columns.reset();
+    endResetModel();
+}
+
+void DatasetSelectionProxyModel::slotSourceModelDestroyed()
+{
+    // QAbstractProxyModel has already forgotten the source model
+    beginResetModel();
+    d->rows.reset();
+    d->columns.reset();
+    d->rootIndex = QModelIndex();
+    endResetModel();
+}
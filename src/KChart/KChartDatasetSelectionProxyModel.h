@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef KCHARTDATASETSELECTIONPROXYMODEL_H
+#define KCHARTDATASETSELECTIONPROXYMODEL_H
+
+#include <QAbstractProxyModel>
+
+#include "KChartDatasetProxyModel.h"
+
+namespace KChart {
+
+    /**
+     * \brief Selects and reorders rows and columns of a table model, like DatasetProxyModel, without sorting or filtering.
+     *
+     * The selection is configured with the same dataset description vectors as
+     * DatasetProxyModel: position x of a description is the proxy row or column, the value
+     * is the source row or column shown there. Without a description, all rows or columns
+     * of the source model are passed through unchanged.
+     *
+     * Rows and columns are mapped through plain lookup tables in both directions, so mapping
+     * an index costs the same for every row and column. Changes of the source model are
+     * forwarded as whole ranges: dataChanged() of a block of cells becomes one dataChanged()
+     * covering the selected cells of the block, and rows or columns inserted into a source
+     * without a description for them are inserted into this model in one go. Rows and
+     * columns inserted into a source with a description are not selected by it. Like with
+     * DatasetProxyModel, a reset or a layout change of the source model resets the dataset
+     * descriptions.
+     *
+     * Diagrams whose model is a DatasetSelectionProxyModel read their values through
+     * data( int, int, int ), without creating an index of this model for each cell.
+     *
+     * \code
+     * KChart::DatasetSelectionProxyModel selection;
+     * selection.setSourceModel( model );
+     * selection.setDatasetColumnDescriptionVector( KChart::DatasetDescriptionVector() << 3 << 1 );
+     * diagram->setModel( &selection );
+     * \endcode
+     */
+class KCHART_EXPORT DatasetSelectionProxyModel : public QAbstractProxyModel
+{
+    Q_OBJECT
+    Q_DISABLE_COPY( DatasetSelectionProxyModel )
+    class Private;
+public:
+    explicit DatasetSelectionProxyModel( QObject* parent = nullptr );
+    ~DatasetSelectionProxyModel();
+
+    void setSourceModel( QAbstractItemModel* sourceModel ) override;
+
+    /** Set the root index of the table in the source model. This resets the dataset descriptions. */
+    void setSourceRootIndex( const QModelIndex& rootIndex );
+    QModelIndex sourceRootIndex() const;
+
+    /** \return The source row shown in proxy row \a row, or -1 if there is none. */
+    int mapRowToSource( int row ) const;
+    /** \return The proxy row showing source row \a sourceRow, or -1 if it is not selected. */
+    int mapRowFromSource( int sourceRow ) const;
+    /** \return The source column shown in proxy column \a column, or -1 if there is none. */
+    int mapColumnToSource( int column ) const;
+    /** \return The proxy column showing source column \a sourceColumn, or -1 if it is not selected. */
+    int mapColumnFromSource( int sourceColumn ) const;
+
+    /** \return The data of the cell in \a row and \a column for \a role, like data( index( row, column ), role ). */
+    QVariant data( int row, int column, int role = Qt::DisplayRole ) const;
+
+    QModelIndex mapFromSource( const QModelIndex& sourceIndex ) const override;
+    QModelIndex mapToSource( const QModelIndex& proxyIndex ) const override;
+
+    QModelIndex index( int row, int column, const QModelIndex& parent = QModelIndex() ) const override;
+    QModelIndex parent( const QModelIndex& child ) const override;
+    bool hasChildren( const QModelIndex& parent = QModelIndex() ) const override;
+    int rowCount( const QModelIndex& parent = QModelIndex() ) const override;
+    int columnCount( const QModelIndex& parent = QModelIndex() ) const override;
+
+    QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const override;
+    bool setData( const QModelIndex& index, const QVariant& value, int role = Qt::EditRole ) override;
+    QVariant headerData( int section, Qt::Orientation orientation, int role = Qt::DisplayRole ) const override;
+    Qt::ItemFlags flags( const QModelIndex& index ) const override;
+
+public Q_SLOTS:
+    /** Reset all dataset descriptions, so that all rows and columns of the source model are shown. */
+    void resetDatasetDescriptions();
+
+    /** Configure the dataset selection for the columns.
+        Every call to this method replaces the previous column description. */
+    void setDatasetColumnDescriptionVector( const DatasetDescriptionVector& columnConfig );
+
+    /** Configure the dataset selection for the rows.
+        Every call to this method replaces the previous row description. */
+    void setDatasetRowDescriptionVector( const DatasetDescriptionVector& rowConfig );
+
+    /** Convenience method to configure rows and columns in one step. */
+    void setDatasetDescriptionVectors( const DatasetDescriptionVector& rowConfig,
+                                       const DatasetDescriptionVector& columnConfig );
+
+private Q_SLOTS:
+    void slotDataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector< int >& roles );
+    void slotHeaderDataChanged( Qt::Orientation orientation, int first, int last );
+    void slotRowsAboutToBeInserted( const QModelIndex& parent, int first, int last );
+    void slotRowsInserted( const QModelIndex& parent, int first, int last );
+    void slotRowsAboutToBeRemoved( const QModelIndex& parent, int first, int last );
+    void slotRowsRemoved( const QModelIndex& parent, int first, int last );
+    void slotColumnsAboutToBeInserted( const QModelIndex& parent, int first, int last );
+    void slotColumnsInserted( const QModelIndex& parent, int first, int last );
+    void slotColumnsAboutToBeRemoved( const QModelIndex& parent, int first, int last );
+    void slotColumnsRemoved( const QModelIndex& parent, int first, int last );
+    void slotSourceAboutToBeReset();
+    void slotSourceReset();
+    void slotSourceModelDestroyed();
+
+private:
+    Private* const d;
+};
+
+}
+
+#endif // KCHARTDATASETSELECTIONPROXYMODEL_H
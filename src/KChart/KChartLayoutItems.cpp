@@ -27,6 +27,7 @@
 #include "KChartPaintContext.h"
 #include "KChartPainterSaver_p.h"
 #include "KChartPrintingParameters.h"
+#include "KChartTextMeasurementCache.h"
 #include "KChartMath_p.h"
 
 #include <QTextCursor>
@@ -410,10 +411,8 @@ QSize KChart::TextLayoutItem::unrotatedTextSize( QFont fnt ) const
         fnt = realFont(); // this is the cached font in most cases
     }
 
-    const QFontMetricsF fm( fnt, GlobalMeasureScaling::paintDevice() );
-    QRect veryLarge( 0, 0, 100000, 100000 );
-    // this overload of boundingRect() interprets \n as line breaks, not as regular characters.
-    return fm.boundingRect( veryLarge, Qt::AlignLeft | Qt::AlignTop, mText ).size().toSize();
+    // shared with all other text in all charts, the same strings get measured over and over
+    return TextMeasurementCache::instance()->textSize( mText, fnt ).toSize();
 }
 
 int KChart::TextLayoutItem::marginWidth() const
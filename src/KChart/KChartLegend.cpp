@@ -27,6 +27,7 @@
 #include <KChartDiagramObserver.h>
 #include "KChartLayoutItems.h"
 #include "KChartPrintingParameters.h"
+#include "KChartPerfObserver_p.h"
 
 #include <QFont>
 #include <QGridLayout>
@@ -54,7 +55,11 @@ Legend::Private::Private() :
     titleText( QObject::tr( "Legend" ) ),
     spacing( 1 ),
     useAutomaticMarkerSize( true ),
-    legendStyle( MarkersOnly )
+    legendStyle( MarkersOnly ),
+    maximumVisibleItemCount( 0 ),
+    firstVisibleItem( 0 ),
+    itemFontHeight( 0.0 ),
+    itemMaxLineLength( 0 )
 {
     // By default we specify a simple, hard point as the 'relative' position's ref. point,
     // since we can not be sure that there will be any parent specified for the legend.
@@ -231,7 +236,8 @@ bool Legend::compare( const Legend* other ) const
             (titleText()              == other->titleText())&&
             (titleTextAttributes()    == other->titleTextAttributes()) &&
             (spacing()                == other->spacing()) &&
-            (legendStyle()            == other->legendStyle());
+            (legendStyle()            == other->legendStyle()) &&
+            (maximumVisibleItemCount() == other->maximumVisibleItemCount());
 }
 
 
@@ -607,7 +613,9 @@ void Legend::setText( uint dataset, const QString& text )
         return;
     }
     d->texts[ dataset ] = text;
-    setNeedRebuild();
+    if ( !d->updateShownText( this, dataset ) ) {
+        setNeedRebuild();
+    }
 }
 
 QString Legend::text( uint dataset ) const
@@ -628,7 +636,9 @@ void Legend::setColor( uint dataset, const QColor& color )
 {
     if ( d->brushes[ dataset ] != color ) {
         d->brushes[ dataset ] = color;
-        setNeedRebuild();
+        if ( !d->updateShownMarker( this, dataset ) ) {
+            setNeedRebuild();
+        }
         update();
     }
 }
@@ -637,7 +647,9 @@ void Legend::setBrush( uint dataset, const QBrush& brush )
 {
     if ( d->brushes[ dataset ] != brush ) {
         d->brushes[ dataset ] = brush;
-        setNeedRebuild();
+        if ( !d->updateShownMarker( this, dataset ) ) {
+            setNeedRebuild();
+        }
         update();
     }
 }
@@ -794,6 +806,58 @@ uint Legend::spacing() const
     return d->spacing;
 }
 
+void Legend::setMaximumVisibleItemCount( int count )
+{
+    count = qMax( count, 0 );
+    if ( d->maximumVisibleItemCount == count ) {
+        return;
+    }
+    d->maximumVisibleItemCount = count;
+    setNeedRebuild();
+}
+
+int Legend::maximumVisibleItemCount() const
+{
+    return d->maximumVisibleItemCount;
+}
+
+void Legend::setFirstVisibleItem( int item )
+{
+    item = qMax( item, 0 );
+    if ( d->firstVisibleItem == item ) {
+        return;
+    }
+    d->firstVisibleItem = item;
+    if ( d->maximumVisibleItemCount ) {
+        setNeedRebuild();
+    }
+}
+
+int Legend::firstVisibleItem() const
+{
+    return d->firstVisibleItem;
+}
+
+int Legend::pageCount() const
+{
+    if ( !d->maximumVisibleItemCount ) {
+        return 1;
+    }
+    const int itemCount = d->modelLabels.count();
+    return qMax( 1, ( itemCount + d->maximumVisibleItemCount - 1 ) / d->maximumVisibleItemCount );
+}
+
+void Legend::setPage( int page )
+{
+    page = qBound( 0, page, pageCount() - 1 );
+    setFirstVisibleItem( page * d->maximumVisibleItemCount );
+}
+
+int Legend::page() const
+{
+    return d->maximumVisibleItemCount ? d->firstVisibleItem / d->maximumVisibleItemCount : 0;
+}
+
 void Legend::setDefaultColors()
 {
     Palette pal = Palette::defaultPalette();
@@ -903,6 +967,39 @@ HDatasetItem::HDatasetItem()
      spacer(nullptr)
 {}
 
+// If we show a marker on a line, we paint it after 8 pixels
+// of the line have been painted. This allows to see the line style
+// at the right side of the marker without the line needing to
+// be too long.
+// (having the marker in the middle of the line would require longer lines)
+static const int lineLengthLeftOfMarker = 8;
+
+AbstractLayoutItem* Legend::Private::createMarkerLine( Legend *q, int dataset ) const
+{
+    // It is possible to set the marker brush through markerAttributes as well as
+    // the dataset brush set in the diagram - the markerAttributes have higher precedence.
+    MarkerAttributes markerAttrs = q->markerAttributes( dataset );
+    markerAttrs.setMarkerSize( markerSize( q, dataset, itemFontHeight ) );
+    const QBrush markerBrush = markerAttrs.markerColor().isValid() ?
+                               QBrush( markerAttrs.markerColor() ) : q->brush( dataset );
+
+    switch ( q->legendStyle() ) {
+    case MarkersOnly:
+        return new MarkerLayoutItem( q->diagram(), markerAttrs, markerBrush,
+                                     markerAttrs.pen(), Qt::AlignLeft | Qt::AlignVCenter );
+    case LinesOnly:
+        return new LineLayoutItem( q->diagram(), itemMaxLineLength, q->pen( dataset ),
+                                   legendLineSymbolAlignment, Qt::AlignCenter );
+    case MarkersAndLines:
+        return new LineWithMarkerLayoutItem(
+            q->diagram(), itemMaxLineLength, q->pen( dataset ), lineLengthLeftOfMarker, markerAttrs,
+            markerBrush, markerAttrs.pen(), Qt::AlignCenter );
+    default:
+        Q_ASSERT( false );
+    }
+    return nullptr;
+}
+
 static void updateToplevelLayout(QWidget *w)
 {
     while ( w ) {
@@ -921,6 +1018,7 @@ static void updateToplevelLayout(QWidget *w)
 
 void Legend::buildLegend()
 {
+    const PerfPhaseTimer perfTimer( PerfObserver::LegendBuildPhase, this );
     /* Grid layout partitioning (horizontal orientation): row zero is the title, row one the divider
        line between title and dataset items, row two for each item: line, marker, text label and separator
        line in that order.
@@ -971,13 +1069,9 @@ void Legend::buildLegend()
 
     const QSizeF maxMarkerSize = d->maxMarkerSize( this, fontHeight );
 
-    // If we show a marker on a line, we paint it after 8 pixels
-    // of the line have been painted. This allows to see the line style
-    // at the right side of the marker without the line needing to
-    // be too long.
-    // (having the marker in the middle of the line would require longer lines)
-    const int lineLengthLeftOfMarker = 8;
-
+    // Marker sizes and line lengths are taken from all datasets, not just the shown ones, so
+    // that the legend does not change its shape when scrolling. This is cheap because nothing
+    // is measured here.
     int maxLineLength = 18;
     {
         bool hasComplexPenStyle = false;
@@ -998,37 +1092,26 @@ void Legend::buildLegend()
         }
     }
 
-    // for all datasets: add (line)marker items and text items to the layout;
+    d->itemFontHeight = fontHeight;
+    d->itemMaxLineLength = maxLineLength;
+
+    // only the shown datasets get layout items
+    const int itemCount = d->modelLabels.count();
+    int firstItem = 0;
+    int endItem = itemCount;
+    if ( d->maximumVisibleItemCount ) {
+        d->firstVisibleItem = qBound( 0, d->firstVisibleItem, qMax( 0, itemCount - 1 ) );
+        firstItem = d->firstVisibleItem;
+        endItem = qMin( itemCount, firstItem + d->maximumVisibleItemCount );
+    }
+
+    // for the shown datasets: add (line)marker items and text items to the layout;
     // actual layout happens in flowHDatasetItems() for horizontal layout, here for vertical
-    for ( int dataset = 0; dataset < d->modelLabels.count(); ++dataset ) {
-        const int vLayoutRow = 2 + dataset * 2;
+    for ( int dataset = firstItem; dataset < endItem; ++dataset ) {
+        const int vLayoutRow = 2 + ( dataset - firstItem ) * 2;
         HDatasetItem dsItem;
 
-        // It is possible to set the marker brush through markerAttributes as well as
-        // the dataset brush set in the diagram - the markerAttributes have higher precedence.
-        MarkerAttributes markerAttrs = markerAttributes( dataset );
-        markerAttrs.setMarkerSize( d->markerSize( this, dataset, fontHeight ) );
-        const QBrush markerBrush = markerAttrs.markerColor().isValid() ?
-                                   QBrush( markerAttrs.markerColor() ) : brush( dataset );
-
-        switch ( legendStyle() ) {
-        case MarkersOnly:
-            dsItem.markerLine = new MarkerLayoutItem( diagram(), markerAttrs, markerBrush,
-                                                      markerAttrs.pen(), Qt::AlignLeft | Qt::AlignVCenter );
-            break;
-        case LinesOnly:
-            dsItem.markerLine = new LineLayoutItem( diagram(), maxLineLength, pen( dataset ),
-                                                    d->legendLineSymbolAlignment, Qt::AlignCenter );
-            break;
-        case MarkersAndLines:
-            dsItem.markerLine = new LineWithMarkerLayoutItem(
-                diagram(), maxLineLength, pen( dataset ), lineLengthLeftOfMarker, markerAttrs,
-                markerBrush, markerAttrs.pen(), Qt::AlignCenter );
-            break;
-        default:
-            Q_ASSERT( false );
-        }
-
+        dsItem.markerLine = d->createMarkerLine( this, dataset );
         dsItem.label = new TextLayoutItem( text( dataset ), textAttributes(), referenceArea(),
                                            measureOrientation, d->textAlignment );
         dsItem.label->setParentWidget( this );
@@ -1041,6 +1124,7 @@ void Legend::buildLegend()
         }
 
         // (actual) vertical layout here
+        d->vLayoutDatasets << dsItem;
         if ( dsItem.markerLine ) {
             d->layout->addItem( dsItem.markerLine, vLayoutRow, 1, 1, 1, Qt::AlignCenter );
             d->paintItems << dsItem.markerLine;
@@ -1049,7 +1133,7 @@ void Legend::buildLegend()
         d->paintItems << dsItem.label;
 
         // horizontal separator line, only between items
-        if ( showLines() && dataset != d->modelLabels.count() - 1 ) {
+        if ( showLines() && dataset != endItem - 1 ) {
             HorizontalLineLayoutItem* lineItem = new HorizontalLineLayoutItem;
             d->layout->addItem( lineItem, vLayoutRow + 1, 0, 1, 5, Qt::AlignCenter );
             d->paintItems << lineItem;
@@ -1061,10 +1145,10 @@ void Legend::buildLegend()
     }
 
     // vertical line (only in vertical mode)
-    if ( orientation() == Qt::Vertical && showLines() && d->modelLabels.count() ) {
+    if ( orientation() == Qt::Vertical && showLines() && endItem > firstItem ) {
         VerticalLineLayoutItem* lineItem = new VerticalLineLayoutItem;
         d->paintItems << lineItem;
-        d->layout->addItem( lineItem, 2, 2, d->modelLabels.count() * 2, 1 );
+        d->layout->addItem( lineItem, 2, 2, ( endItem - firstItem ) * 2, 1 );
     }
 
     updateToplevelLayout( this );
@@ -1075,6 +1159,67 @@ void Legend::buildLegend()
 #endif
 }
 
+HDatasetItem* Legend::Private::shownDatasetItem( Legend *q, uint dataset )
+{
+    QList< HDatasetItem >& items = q->orientation() == Qt::Horizontal ? hLayoutDatasets
+                                                                      : vLayoutDatasets;
+    const int index = int( dataset ) - ( maximumVisibleItemCount ? firstVisibleItem : 0 );
+    if ( index < 0 || index >= items.count() ) {
+        return nullptr;
+    }
+    return &items[ index ];
+}
+
+// The updateShown...() functions apply a change to a single dataset without rebuilding the
+// whole legend. They return false if a rebuild is needed after all.
+
+bool Legend::Private::updateShownText( Legend *q, uint dataset )
+{
+    HDatasetItem* item = shownDatasetItem( q, dataset );
+    if ( !item ) {
+        // nothing to do for a dataset that is scrolled out of view
+        return maximumVisibleItemCount && int( dataset ) < modelLabels.count();
+    }
+    item->label->setText( q->text( dataset ) );
+    if ( q->orientation() == Qt::Horizontal ) {
+        reflowHDatasetItems( q );
+    }
+    layout->invalidate();
+    updateToplevelLayout( q );
+    emit q->propertiesChanged();
+    return true;
+}
+
+bool Legend::Private::updateShownMarker( Legend *q, uint dataset )
+{
+    HDatasetItem* item = shownDatasetItem( q, dataset );
+    if ( !item ) {
+        return maximumVisibleItemCount && int( dataset ) < modelLabels.count();
+    }
+    // the brush does not influence the size, so the new item can simply take the old one's place
+    AbstractLayoutItem* oldItem = item->markerLine;
+    item->markerLine = createMarkerLine( q, dataset );
+    if ( q->orientation() == Qt::Horizontal ) {
+        // this detaches the old item from its line and puts the new one in
+        reflowHDatasetItems( q );
+    } else {
+        for ( int i = 0; i < layout->count(); i++ ) {
+            if ( layout->itemAt( i ) == oldItem ) {
+                int row, column, rowSpan, columnSpan;
+                layout->getItemPosition( i, &row, &column, &rowSpan, &columnSpan );
+                layout->takeAt( i );
+                layout->addItem( item->markerLine, row, column, rowSpan, columnSpan, Qt::AlignCenter );
+                break;
+            }
+        }
+        paintItems.replace( paintItems.indexOf( oldItem ), item->markerLine );
+    }
+    item->markerLine->setGeometry( oldItem->geometry() );
+    delete oldItem;
+    emit q->propertiesChanged();
+    return true;
+}
+
 int HDatasetItem::height() const
 {
     return qMax( markerLine->sizeHint().height(), label->sizeHint().height() );
@@ -1248,6 +1393,7 @@ void Legend::Private::destroyOldLayout()
     }
     Q_ASSERT( !layout->count() );
     hLayoutDatasets.clear();
+    vLayoutDatasets.clear();
     paintItems.clear();
 }
 
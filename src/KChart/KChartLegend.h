@@ -390,6 +390,37 @@ m_legend->setFloatingPosition( relativePosition );
     void setSpacing( uint space );
     uint spacing() const;
 
+    /**
+     * Show at most \a count dataset items at a time, 0 (the default) shows all of them.
+     *
+     * Only the items that are shown get created and measured, so a legend for thousands of
+     * datasets costs about as much as one for \a count datasets. Use setFirstVisibleItem()
+     * to scroll or setPage() to page through the others.
+     */
+    void setMaximumVisibleItemCount( int count );
+    int maximumVisibleItemCount() const;
+
+    /**
+     * Make \a item the first dataset item shown when maximumVisibleItemCount() is set.
+     * Items are counted like the \a dataset argument of text() and brush().
+     */
+    void setFirstVisibleItem( int item );
+    int firstVisibleItem() const;
+
+    /**
+     * \return The number of pages of maximumVisibleItemCount() items each, 1 if all items
+     * are shown at once.
+     */
+    int pageCount() const;
+
+    /**
+     * Show the items of page \a page, counting from 0. Pages past the last one show the
+     * last page.
+     * \sa setMaximumVisibleItemCount, setFirstVisibleItem
+     */
+    void setPage( int page );
+    int page() const;
+
     // called internally by KChart::Chart, when painting into a custom QPainter
     void forceRebuild() override;
 
@@ -95,6 +95,10 @@ public:
     void reflowHDatasetItems( Legend *q );
     void flowHDatasetItems( Legend *q );
     void destroyOldLayout();
+    AbstractLayoutItem* createMarkerLine( Legend *q, int dataset ) const;
+    HDatasetItem* shownDatasetItem( Legend *q, uint dataset );
+    bool updateShownText( Legend *q, uint dataset );
+    bool updateShownMarker( Legend *q, uint dataset );
 
 private:
     // user-settable
@@ -118,6 +122,8 @@ private:
     uint spacing;
     bool useAutomaticMarkerSize;
     LegendStyle legendStyle;
+    int maximumVisibleItemCount;
+    int firstVisibleItem;
 
     // internal
     mutable QStringList modelLabels;
@@ -128,6 +134,10 @@ private:
     QVector< AbstractLayoutItem* > paintItems;
     QGridLayout* layout;
     QList< HDatasetItem > hLayoutDatasets;
+    QList< HDatasetItem > vLayoutDatasets; // only markerLine and label are used
+    // the parameters the dataset items were last built with, for updating single items
+    qreal itemFontHeight;
+    int itemMaxLineLength;
     DiagramsObserversList observers;
 };
 
@@ -34,6 +34,7 @@ class Q_DECL_HIDDEN PaintContext::Private {
 public:
     QPainter* painter;
     QRectF rect;
+    QRectF exposedRect;
     AbstractCoordinatePlane* plane;
 
     Private()
@@ -62,6 +63,16 @@ void PaintContext::setRectangle ( const QRectF& rect )
     d->rect = rect;
 }
 
+const QRectF PaintContext::exposedRect() const
+{
+    return d->exposedRect;
+}
+
+void PaintContext::setExposedRect( const QRectF& rect )
+{
+    d->exposedRect = rect;
+}
+
 QPainter* PaintContext::painter() const
 {
     return d->painter;
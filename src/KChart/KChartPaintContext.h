@@ -44,6 +44,14 @@ namespace KChart {
         const QRectF rectangle () const;
         void setRectangle( const QRectF& rect );
 
+        /**
+          * The part of the chart that needs painting, when only a part of it is repainted,
+          * e.g. after a few values changed. Diagrams may leave out what is outside of it.
+          * Invalid if everything needs painting, which is the default.
+          */
+        const QRectF exposedRect() const;
+        void setExposedRect( const QRectF& rect );
+
         QPainter* painter() const;
         void setPainter( QPainter* painter );
 
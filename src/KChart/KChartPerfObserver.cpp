@@ -0,0 +1,247 @@
+/**
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "KChartPerfObserver.h"
+
+#include <QAtomicPointer>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QObject>
+#include <QThread>
+#include <QVector>
+
+using namespace KChart;
+
+static QAtomicPointer< PerfObserver > s_observer;
+
+static const QElapsedTimer& perfClock()
+{
+    static const QElapsedTimer timer = [] { QElapsedTimer t; t.start(); return t; }();
+    return timer;
+}
+
+PerfObserver::PerfObserver()
+{
+}
+
+PerfObserver::~PerfObserver()
+{
+    // do not leave a dangling observer behind
+    s_observer.testAndSetOrdered( this, nullptr );
+}
+
+void PerfObserver::setObserver( PerfObserver* observer )
+{
+    perfClock(); // start the clock before the first event
+    s_observer.storeRelease( observer );
+}
+
+PerfObserver* PerfObserver::observer()
+{
+    return s_observer.loadAcquire();
+}
+
+qint64 PerfObserver::clock()
+{
+    return perfClock().nsecsElapsed();
+}
+
+const char* PerfObserver::phaseName( Phase phase )
+{
+    switch ( phase ) {
+    case LayoutPhase: return "Layout";
+    case DataBoundariesPhase: return "DataBoundaries";
+    case CompressionPhase: return "Compression";
+    case DiagramPaintPhase: return "DiagramPaint";
+    case LabelLayoutPhase: return "LabelLayout";
+    case AxisPaintPhase: return "AxisPaint";
+    case LegendBuildPhase: return "LegendBuild";
+    }
+    return "Unknown";
+}
+
+const char* PerfObserver::counterName( Counter counter )
+{
+    switch ( counter ) {
+    case DataLookupsCounter: return "DataLookups";
+    case LabelsCulledCounter: return "LabelsCulled";
+    case CacheHitsCounter: return "CacheHits";
+    case CacheMissesCounter: return "CacheMisses";
+    }
+    return "Unknown";
+}
+
+
+namespace {
+
+struct TraceEvent
+{
+    const char* name;
+    const char* sourceClass;
+    QString sourceName;
+    quintptr sourceAddress;
+    int thread;
+    bool isCounter;
+    qint64 time; // nanoseconds
+    qint64 durationOrValue;
+};
+
+}
+
+class Q_DECL_HIDDEN ChromeTraceRecorder::Private
+{
+public:
+    int threadId( QThread* thread )
+    {
+        QHash< QThread*, int >::const_iterator it = threads.constFind( thread );
+        if ( it != threads.constEnd() ) {
+            return *it;
+        }
+        const int id = threads.count() + 1;
+        threads.insert( thread, id );
+        return id;
+    }
+
+    void record( const char* name, const QObject* source, bool isCounter, qint64 time, qint64 durationOrValue )
+    {
+        TraceEvent event;
+        event.name = name;
+        // the source may be gone by the time the trace is written, so keep its description only
+        event.sourceClass = source ? source->metaObject()->className() : nullptr;
+        event.sourceAddress = quintptr( source );
+        if ( source ) {
+            event.sourceName = source->objectName();
+        }
+        event.isCounter = isCounter;
+        event.time = time;
+        event.durationOrValue = durationOrValue;
+
+        QMutexLocker locker( &mutex );
+        event.thread = threadId( QThread::currentThread() );
+        events.append( event );
+    }
+
+    mutable QMutex mutex;
+    QVector< TraceEvent > events;
+    QHash< QThread*, int > threads;
+};
+
+ChromeTraceRecorder::ChromeTraceRecorder()
+    : d( new Private )
+{
+}
+
+ChromeTraceRecorder::~ChromeTraceRecorder()
+{
+    // before d is gone, see ~PerfObserver()
+    s_observer.testAndSetOrdered( this, nullptr );
+    delete d;
+}
+
+void ChromeTraceRecorder::phaseFinished( Phase phase, const QObject* source,
+                                         qint64 startNSecs, qint64 durationNSecs )
+{
+    d->record( phaseName( phase ), source, false, startNSecs, durationNSecs );
+}
+
+void ChromeTraceRecorder::counterReported( Counter counter, const QObject* source,
+                                           qint64 timeNSecs, qint64 value )
+{
+    d->record( counterName( counter ), source, true, timeNSecs, value );
+}
+
+int ChromeTraceRecorder::eventCount() const
+{
+    QMutexLocker locker( &d->mutex );
+    return d->events.count();
+}
+
+void ChromeTraceRecorder::clear()
+{
+    QMutexLocker locker( &d->mutex );
+    d->events.clear();
+}
+
+QByteArray ChromeTraceRecorder::toJson() const
+{
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+
+    QMutexLocker locker( &d->mutex );
+    for ( const TraceEvent& event : qAsConst( d->events ) ) {
+        QJsonObject json;
+        json.insert( QStringLiteral( "name" ), QString::fromLatin1( event.name ) );
+        json.insert( QStringLiteral( "cat" ), QStringLiteral( "kchart" ) );
+        json.insert( QStringLiteral( "pid" ), pid );
+        json.insert( QStringLiteral( "tid" ), event.thread );
+        // the format wants microseconds
+        json.insert( QStringLiteral( "ts" ), event.time / 1000.0 );
+
+        QJsonObject args;
+        if ( event.isCounter ) {
+            // every argument of a counter is a series of numbers, so the source goes into the
+            // id, which also gives each source a track of its own
+            json.insert( QStringLiteral( "ph" ), QStringLiteral( "C" ) );
+            if ( event.sourceClass ) {
+                QString id = QString::fromLatin1( event.sourceClass );
+                if ( !event.sourceName.isEmpty() ) {
+                    id += QLatin1Char( ' ' ) + event.sourceName;
+                }
+                id += QStringLiteral( " 0x" ) + QString::number( event.sourceAddress, 16 );
+                json.insert( QStringLiteral( "id" ), id );
+            }
+            args.insert( QStringLiteral( "value" ), event.durationOrValue );
+        } else {
+            json.insert( QStringLiteral( "ph" ), QStringLiteral( "X" ) );
+            json.insert( QStringLiteral( "dur" ), event.durationOrValue / 1000.0 );
+            if ( event.sourceClass ) {
+                args.insert( QStringLiteral( "class" ), QString::fromLatin1( event.sourceClass ) );
+            }
+            if ( !event.sourceName.isEmpty() ) {
+                args.insert( QStringLiteral( "object" ), event.sourceName );
+            }
+        }
+        json.insert( QStringLiteral( "args" ), args );
+        traceEvents.append( json );
+    }
+    locker.unlock();
+
+    QJsonObject root;
+    root.insert( QStringLiteral( "traceEvents" ), traceEvents );
+    root.insert( QStringLiteral( "displayTimeUnit" ), QStringLiteral( "ms" ) );
+    return QJsonDocument( root ).toJson( QJsonDocument::Compact );
+}
+
+bool ChromeTraceRecorder::save( const QString& fileName ) const
+{
+    QFile file( fileName );
+    if ( !file.open( QIODevice::WriteOnly | QIODevice::Truncate ) ) {
+        return false;
+    }
+    const QByteArray json = toJson();
+    return file.write( json ) == json.size();
+}
@@ -0,0 +1,176 @@
+/**
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef KCHARTPERFOBSERVER_H
+#define KCHARTPERFOBSERVER_H
+
+#include <QByteArray>
+
+#include "KChartGlobal.h"
+
+QT_BEGIN_NAMESPACE
+class QObject;
+class QString;
+QT_END_NAMESPACE
+
+namespace KChart {
+
+    /**
+     * \brief Receives timing and counter events from the layout and painting code.
+     *
+     * Install an observer with setObserver() to find out where the time goes when charts
+     * are laid out and painted. The library reports how long each phase took, and counters
+     * like the number of data points drawn. The object that did the work is passed as the
+     * source, e.g. the chart, diagram, axis or legend.
+     *
+     * Only one observer can be installed at a time. It is called from the thread that does
+     * the work, so implementations must be thread safe if charts are painted outside of the
+     * GUI thread. When no observer is installed the instrumentation costs one pointer
+     * comparison per phase.
+     *
+     * Subclasses must remove themselves with setObserver( nullptr ) in their own destructor
+     * if they are still installed. ~PerfObserver() does so as well, but only after the
+     * subclass is destroyed, while events may still come in.
+     *
+     * \sa ChromeTraceRecorder
+     */
+class KCHART_EXPORT PerfObserver
+{
+    Q_DISABLE_COPY( PerfObserver )
+public:
+    enum Phase {
+        /// Chart::Private::slotLayoutPlanes(), setting up the layout of the coordinate planes
+        LayoutPhase,
+        /// AbstractDiagram::calculateDataBoundaries()
+        DataBoundariesPhase,
+        /// Setting up and filling the data compressor of a cartesian diagram
+        CompressionPhase,
+        /// Painting one diagram, excluding its axes
+        DiagramPaintPhase,
+        /// Laying out and painting the data value texts of a diagram
+        LabelLayoutPhase,
+        /// Painting one axis
+        AxisPaintPhase,
+        /// Legend::buildLegend()
+        LegendBuildPhase
+    };
+
+    enum Counter {
+        /// Data points a cartesian diagram looked up in its compressor while painting. This is
+        /// the sum of CacheHitsCounter and CacheMissesCounter; a point that is looked up more
+        /// than once counts more than once, and not every point looked up is painted.
+        DataLookupsCounter,
+        /// Data value texts not painted because they would have overlapped others
+        LabelsCulledCounter,
+        /// Data points of a cartesian diagram that were served from the compressor cache
+        CacheHitsCounter,
+        /// Data points of a cartesian diagram that had to be read from the model
+        CacheMissesCounter
+    };
+
+    PerfObserver();
+    virtual ~PerfObserver();
+
+    /**
+     * Called when \a source finished \a phase. Times are in nanoseconds, \a startNSecs
+     * is relative to clock().
+     */
+    virtual void phaseFinished( Phase phase, const QObject* source,
+                                qint64 startNSecs, qint64 durationNSecs ) = 0;
+
+    /**
+     * Called when \a source reports the value of \a counter for the phase it just
+     * finished. \a timeNSecs is relative to clock().
+     */
+    virtual void counterReported( Counter counter, const QObject* source,
+                                  qint64 timeNSecs, qint64 value ) = 0;
+
+    /**
+     * Install \a observer, or remove the current one if \a observer is null.
+     * The observer is not owned by the library.
+     */
+    static void setObserver( PerfObserver* observer );
+    static PerfObserver* observer();
+
+    /**
+     * \return The nanoseconds elapsed on the monotonic clock all events are timed with.
+     */
+    static qint64 clock();
+
+    static const char* phaseName( Phase phase );
+    static const char* counterName( Counter counter );
+};
+
+    /**
+     * \brief A PerfObserver recording the events in the Chrome trace event format.
+     *
+     * The resulting JSON can be loaded in chrome://tracing, Perfetto or any other viewer
+     * of that format. Phases are recorded as complete ("X") events, counters as counter
+     * ("C") events. The source of a counter is its "id", so each source gets a track of its
+     * own. The recorder removes itself as the observer when it is destroyed.
+     *
+     * \code
+     * KChart::ChromeTraceRecorder recorder;
+     * KChart::PerfObserver::setObserver( &recorder );
+     * // ... show and use the charts ...
+     * KChart::PerfObserver::setObserver( nullptr );
+     * recorder.save( "chart-trace.json" );
+     * \endcode
+     */
+class KCHART_EXPORT ChromeTraceRecorder : public PerfObserver
+{
+    Q_DISABLE_COPY( ChromeTraceRecorder )
+    class Private;
+public:
+    ChromeTraceRecorder();
+    ~ChromeTraceRecorder();
+
+    void phaseFinished( Phase phase, const QObject* source,
+                        qint64 startNSecs, qint64 durationNSecs ) override;
+    void counterReported( Counter counter, const QObject* source,
+                          qint64 timeNSecs, qint64 value ) override;
+
+    /**
+     * \return The number of events recorded so far.
+     */
+    int eventCount() const;
+
+    /**
+     * Forget all recorded events.
+     */
+    void clear();
+
+    /**
+     * \return The recorded events as a JSON document in the Chrome trace event format.
+     */
+    QByteArray toJson() const;
+
+    /**
+     * Write toJson() to \a fileName.
+     * \return false if the file could not be written.
+     */
+    bool save( const QString& fileName ) const;
+
+private:
+    Private* const d;
+};
+
+}
+
+#endif // KCHARTPERFOBSERVER_H
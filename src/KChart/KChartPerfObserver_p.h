@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef KCHARTPERFOBSERVER_P_H
+#define KCHARTPERFOBSERVER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "KChartPerfObserver.h"
+
+
+namespace KChart {
+
+/**
+   \internal
+
+   @short Reports the time spent in its scope as a PerfObserver phase
+
+   \code
+   const KChart::PerfPhaseTimer timer( KChart::PerfObserver::LegendBuildPhase, this );
+   \endcode
+
+   Nothing is measured if no observer is installed when the timer is created.
+*/
+class PerfPhaseTimer
+{
+public:
+    PerfPhaseTimer( PerfObserver::Phase phase, const QObject* source )
+        : m_observer( PerfObserver::observer() ),
+          m_phase( phase ),
+          m_source( source ),
+          m_start( m_observer ? PerfObserver::clock() : 0 )
+    {
+    }
+
+    ~PerfPhaseTimer()
+    {
+        if ( m_observer ) {
+            m_observer->phaseFinished( m_phase, m_source, m_start, PerfObserver::clock() - m_start );
+        }
+    }
+
+private:
+    Q_DISABLE_COPY( PerfPhaseTimer )
+    PerfObserver* const m_observer;
+    const PerfObserver::Phase m_phase;
+    const QObject* const m_source;
+    const qint64 m_start;
+};
+
+/**
+   \internal
+
+   Reports \a value for \a counter to the installed observer, if any.
+*/
+inline void perfReportCounter( PerfObserver::Counter counter, const QObject* source, qint64 value )
+{
+    if ( PerfObserver* observer = PerfObserver::observer() ) {
+        observer->counterReported( counter, source, PerfObserver::clock(), value );
+    }
+}
+
+}
+
+#endif /* KCHARTPERFOBSERVER_P_H */
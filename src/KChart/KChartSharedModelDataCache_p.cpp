@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "KChartSharedModelDataCache_p.h"
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPair>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QWeakPointer>
+
+#include <limits>
+
+using namespace KChart;
+
+typedef QPair< const QAbstractItemModel*, int > CacheKey;
+typedef QHash< CacheKey, QWeakPointer< SharedModelDataCache > > CacheRegistry;
+
+static CacheRegistry& registry()
+{
+    static CacheRegistry caches;
+    return caches;
+}
+
+static QMutex& registryMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+SharedModelDataCache::SharedModelDataCache( QAbstractItemModel* model, int role )
+    : QObject( nullptr ),
+      m_model( model ),
+      m_role( role ),
+      m_generation( 0 )
+{
+    connect( model, SIGNAL(dataChanged(QModelIndex,QModelIndex)),
+             this, SLOT(slotDataChanged(QModelIndex,QModelIndex)) );
+    connect( model, SIGNAL(rowsInserted(QModelIndex,int,int)),
+             this, SLOT(slotRowsInserted(QModelIndex,int,int)) );
+    connect( model, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+             this, SLOT(slotRowsRemoved(QModelIndex,int,int)) );
+    connect( model, SIGNAL(columnsInserted(QModelIndex,int,int)),
+             this, SLOT(slotColumnsInserted(QModelIndex,int,int)) );
+    connect( model, SIGNAL(columnsRemoved(QModelIndex,int,int)),
+             this, SLOT(slotColumnsRemoved(QModelIndex,int,int)) );
+    connect( model, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
+             this, SLOT(clear()) );
+    connect( model, SIGNAL(columnsMoved(QModelIndex,int,int,QModelIndex,int)),
+             this, SLOT(clear()) );
+    connect( model, SIGNAL(layoutChanged()),
+             this, SLOT(clear()) );
+    connect( model, SIGNAL(modelReset()),
+             this, SLOT(clear()) );
+    connect( model, SIGNAL(destroyed()),
+             this, SLOT(slotModelDestroyed()) );
+}
+
+SharedModelDataCache::~SharedModelDataCache()
+{
+    if ( !m_model ) {
+        return; // unregistered when the model was destroyed
+    }
+    QMutexLocker locker( &registryMutex() );
+    // the entry of this cache has expired by now, unless a new cache took its place already
+    const CacheKey key( m_model, m_role );
+    if ( registry().value( key ).isNull() ) {
+        registry().remove( key );
+    }
+}
+
+QSharedPointer< SharedModelDataCache > SharedModelDataCache::attach( QAbstractItemModel* model, int role )
+{
+    Q_ASSERT( model );
+    QMutexLocker locker( &registryMutex() );
+    const CacheKey key( model, role );
+    QSharedPointer< SharedModelDataCache > cache = registry().value( key ).toStrongRef();
+    if ( !cache ) {
+        cache = QSharedPointer< SharedModelDataCache >( new SharedModelDataCache( model, role ) );
+        registry().insert( key, cache );
+    }
+    return cache;
+}
+
+QSharedPointer< SharedModelDataCache > SharedModelDataCache::find( const QAbstractItemModel* model, int role )
+{
+    QMutexLocker locker( &registryMutex() );
+    return registry().value( CacheKey( model, role ) ).toStrongRef();
+}
+
+QAbstractItemModel* SharedModelDataCache::model() const
+{
+    return m_model;
+}
+
+int SharedModelDataCache::role() const
+{
+    return m_role;
+}
+
+void SharedModelDataCache::addTable( const QModelIndex& root )
+{
+    QWriteLocker locker( &m_lock );
+    if ( !m_model || findTable( root ) >= 0 ) {
+        return;
+    }
+    Table table;
+    table.root = root;
+    table.topLevel = !root.isValid();
+    m_tables.append( table );
+    resetTable( &m_tables.last() );
+}
+
+qreal SharedModelDataCache::value( const QModelIndex& root, int row, int column ) const
+{
+    if ( row < 0 || column < 0 ) {
+        return std::numeric_limits< qreal >::quiet_NaN();
+    }
+    const QAbstractItemModel* model = nullptr;
+    quint64 generation = 0;
+    bool keep = false;
+    {
+        QReadLocker locker( &m_lock );
+        model = m_model;
+        if ( !model ) {
+            return std::numeric_limits< qreal >::quiet_NaN();
+        }
+        const int tableIndex = findTable( root );
+        // if the table was not added, or the model grew without telling, the value is read
+        // but there is no place to keep it
+        if ( tableIndex >= 0 ) {
+            const Table& table = m_tables.at( tableIndex );
+            keep = row < table.rows.count() && column < table.columnCount;
+            if ( keep ) {
+                const Cell& cell = table.rows.at( row ).at( column );
+                if ( cell.valid ) {
+                    return cell.value;
+                }
+            }
+        }
+        generation = m_generation;
+    }
+
+    // the model is read without holding the lock, it may call back into the cache
+    const qreal result = fetch( model, root, row, column );
+
+    if ( keep ) {
+        QWriteLocker locker( &m_lock );
+        const int tableIndex = findTable( root );
+        if ( m_generation == generation && tableIndex >= 0 ) {
+            Table& table = m_tables[ tableIndex ];
+            if ( row < table.rows.count() && column < table.columnCount ) {
+                const Cell cell = { result, true };
+                table.rows[ row ][ column ] = cell;
+            }
+        }
+    }
+    return result;
+}
+
+int SharedModelDataCache::findTable( const QModelIndex& root ) const
+{
+    const bool topLevel = !root.isValid();
+    for ( int i = 0; i < m_tables.count(); ++i ) {
+        const Table& table = m_tables.at( i );
+        if ( table.topLevel == topLevel && table.root == root ) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void SharedModelDataCache::resetTable( Table* table ) const
+{
+    table->columnCount = m_model->columnCount( table->root );
+    const Cell invalid = { 0.0, false };
+    table->rows.fill( QVector< Cell >( table->columnCount, invalid ), m_model->rowCount( table->root ) );
+}
+
+qreal SharedModelDataCache::fetch( const QAbstractItemModel* model, const QModelIndex& root,
+                                   int row, int column ) const
+{
+    const QVariant data = model->index( row, column, root ).data( m_role );
+    return data.isNull() ? std::numeric_limits< qreal >::quiet_NaN() : data.value< qreal >();
+}
+
+void SharedModelDataCache::dropOrphanedTables()
+{
+    for ( int i = m_tables.count() - 1; i >= 0; --i ) {
+        if ( !m_tables.at( i ).topLevel && !m_tables.at( i ).root.isValid() ) {
+            m_tables.remove( i );
+        }
+    }
+}
+
+void SharedModelDataCache::slotDataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight )
+{
+    if ( !topLeft.isValid() || !bottomRight.isValid() ) {
+        return;
+    }
+    QWriteLocker locker( &m_lock );
+    ++m_generation;
+    const int tableIndex = findTable( topLeft.parent() );
+    if ( tableIndex < 0 ) {
+        return;
+    }
+    Table* table = &m_tables[ tableIndex ];
+    const int lastRow = qMin( bottomRight.row(), table->rows.count() - 1 );
+    const int lastColumn = qMin( bottomRight.column(), table->columnCount - 1 );
+    for ( int row = qMax( topLeft.row(), 0 ); row <= lastRow; ++row ) {
+        QVector< Cell >& cells = table->rows[ row ];
+        for ( int column = qMax( topLeft.column(), 0 ); column <= lastColumn; ++column ) {
+            cells[ column ].valid = false;
+        }
+    }
+}
+
+void SharedModelDataCache::slotRowsInserted( const QModelIndex& parent, int first, int last )
+{
+    QWriteLocker locker( &m_lock );
+    ++m_generation;
+    const int tableIndex = findTable( parent );
+    if ( tableIndex < 0 ) {
+        return;
+    }
+    Table* table = &m_tables[ tableIndex ];
+    const Cell invalid = { 0.0, false };
+    table->rows.insert( qMin( first, table->rows.count() ), last - first + 1,
+                        QVector< Cell >( table->columnCount, invalid ) );
+}
+
+void SharedModelDataCache::slotRowsRemoved( const QModelIndex& parent, int first, int last )
+{
+    QWriteLocker locker( &m_lock );
+    ++m_generation;
+    dropOrphanedTables();
+    const int tableIndex = findTable( parent );
+    if ( tableIndex < 0 || first >= m_tables.at( tableIndex ).rows.count() ) {
+        return;
+    }
+    Table* table = &m_tables[ tableIndex ];
+    table->rows.remove( first, qMin( last, table->rows.count() - 1 ) - first + 1 );
+}
+
+void SharedModelDataCache::slotColumnsInserted( const QModelIndex& parent, int first, int last )
+{
+    QWriteLocker locker( &m_lock );
+    ++m_generation;
+    const int tableIndex = findTable( parent );
+    if ( tableIndex < 0 ) {
+        return;
+    }
+    Table* table = &m_tables[ tableIndex ];
+    const int start = qMin( first, table->columnCount );
+    const int count = last - first + 1;
+    const Cell invalid = { 0.0, false };
+    for ( QVector< Cell >& cells : table->rows ) {
+        cells.insert( start, count, invalid );
+    }
+    table->columnCount += count;
+}
+
+void SharedModelDataCache::slotColumnsRemoved( const QModelIndex& parent, int first, int last )
+{
+    QWriteLocker locker( &m_lock );
+    ++m_generation;
+    dropOrphanedTables();
+    const int tableIndex = findTable( parent );
+    if ( tableIndex < 0 || first >= m_tables.at( tableIndex ).columnCount ) {
+        return;
+    }
+    Table* table = &m_tables[ tableIndex ];
+    const int count = qMin( last, table->columnCount - 1 ) - first + 1;
+    for ( QVector< Cell >& cells : table->rows ) {
+        cells.remove( first, count );
+    }
+    table->columnCount -= count;
+}
+
+void SharedModelDataCache::slotModelDestroyed()
+{
+    {
+        QMutexLocker locker( &registryMutex() );
+        registry().remove( CacheKey( m_model, m_role ) );
+    }
+    QWriteLocker locker( &m_lock );
+    ++m_generation;
+    m_model = nullptr;
+    m_tables.clear();
+}
+
+void SharedModelDataCache::clear()
+{
+    QWriteLocker locker( &m_lock );
+    ++m_generation;
+    if ( !m_model ) {
+        return;
+    }
+    // the tables are kept, value() cannot add them again
+    dropOrphanedTables();
+    for ( Table& table : m_tables ) {
+        resetTable( &table );
+    }
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef KCHARTSHAREDMODELDATACACHE_P_H
+#define KCHARTSHAREDMODELDATACACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QModelIndex>
+#include <QObject>
+#include <QPersistentModelIndex>
+#include <QReadWriteLock>
+#include <QSharedPointer>
+#include <QVector>
+
+#include "kchart_export.h"
+
+QT_BEGIN_NAMESPACE
+class QAbstractItemModel;
+QT_END_NAMESPACE
+
+namespace KChart {
+
+/**
+   \internal
+
+   @short The values of one role of a model, read once and shared by all diagrams showing it
+
+   There is at most one cache per model and role, see attach(). It holds the values of every
+   table (root index) of the model that was asked for, as qreal, with NaN for null values.
+   It lives as long as a shared pointer to it is held; the AttributesModel of each diagram
+   holds one for its source model, so that the values of a model shown by several diagrams are
+   fetched and stored once.
+
+   The cache connects to the model before any AttributesModel of it, so it has already seen a
+   change of the model when the diagrams hear of it.
+
+   value() may be called from several threads at once, e.g. by diagrams painted in parallel.
+   Cached values are read under a read lock only; values that are not cached yet are read
+   from the model without holding any lock. Everything else, addTable() in particular, must
+   be called from the thread of the model.
+*/
+class KCHART_EXPORT SharedModelDataCache : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY( SharedModelDataCache )
+public:
+    ~SharedModelDataCache();
+
+    /**
+       \return The cache of \a role of \a model, created if there is none yet.
+    */
+    static QSharedPointer< SharedModelDataCache > attach( QAbstractItemModel* model,
+                                                          int role = Qt::DisplayRole );
+
+    /**
+       \return The cache of \a role of \a model, or a null pointer if there is none.
+    */
+    static QSharedPointer< SharedModelDataCache > find( const QAbstractItemModel* model,
+                                                        int role = Qt::DisplayRole );
+
+    QAbstractItemModel* model() const;
+    int role() const;
+
+    /**
+       Keeps the values of the table below \a root from now on. value() does not add tables
+       by itself, as it would have to create a QPersistentModelIndex for \a root, which is
+       only allowed in the thread of the model.
+    */
+    void addTable( const QModelIndex& root );
+
+    /**
+       \return The value of the cell in \a row and \a column of the table below \a root,
+       read from the model if it is not cached yet. The values of tables that were not
+       added with addTable() are read from the model every time.
+    */
+    qreal value( const QModelIndex& root, int row, int column ) const;
+
+private Q_SLOTS:
+    void slotDataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight );
+    void slotRowsInserted( const QModelIndex& parent, int first, int last );
+    void slotRowsRemoved( const QModelIndex& parent, int first, int last );
+    void slotColumnsInserted( const QModelIndex& parent, int first, int last );
+    void slotColumnsRemoved( const QModelIndex& parent, int first, int last );
+    void slotModelDestroyed();
+    void clear();
+
+private:
+    SharedModelDataCache( QAbstractItemModel* model, int role );
+
+    struct Cell
+    {
+        qreal value;
+        bool valid;
+    };
+
+    struct Table
+    {
+        QPersistentModelIndex root;
+        bool topLevel;
+        int columnCount;
+        QVector< QVector< Cell > > rows;
+    };
+
+    // the index of the table in m_tables that is below \a root, or -1
+    int findTable( const QModelIndex& root ) const;
+    // size \a table like its part of the model, with none of its values read yet
+    void resetTable( Table* table ) const;
+    qreal fetch( const QAbstractItemModel* model, const QModelIndex& root, int row, int column ) const;
+    // forget the tables whose root index was removed from the model
+    void dropOrphanedTables();
+
+    QAbstractItemModel* m_model;
+    const int m_role;
+    mutable QReadWriteLock m_lock;
+    mutable QVector< Table > m_tables;
+    // increased whenever cached values become invalid, so that value() does not store
+    // a value it read from the model before the change
+    quint64 m_generation;
+};
+
+}
+
+#endif /* KCHARTSHAREDMODELDATACACHE_P_H */
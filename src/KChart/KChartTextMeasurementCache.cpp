@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "KChartTextMeasurementCache.h"
+
+#include "KChartMeasure.h"
+
+#include <QAbstractTextDocumentLayout>
+#include <QCache>
+#include <QFont>
+#include <QFontMetricsF>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPaintDevice>
+#include <QTextDocument>
+#include <QTransform>
+
+using namespace KChart;
+
+namespace {
+
+struct MeasurementKey
+{
+    MeasurementKey( const QString& _text, const QFont& _font, int _layout, qreal _rotation,
+                    int _dpiX, int _dpiY )
+        : text( _text )
+        , font( _font )
+        , layout( _layout )
+        , rotation( _rotation == 0.0 ? 0.0 : _rotation ) // fold -0.0 into 0.0 for hashing
+        , dpiX( _dpiX )
+        , dpiY( _dpiY )
+    {}
+
+    bool operator==( const MeasurementKey& other ) const
+    {
+        return text == other.text && layout == other.layout && rotation == other.rotation &&
+               dpiX == other.dpiX && dpiY == other.dpiY && font == other.font;
+    }
+
+    QString text;
+    QFont font;
+    int layout;
+    qreal rotation;
+    // the resolution rather than the device itself, paint devices come and go
+    int dpiX;
+    int dpiY;
+};
+
+uint qHash( const MeasurementKey& key, uint seed = 0 )
+{
+    seed = ::qHash( key.text, seed );
+    seed = ::qHash( key.font, seed );
+    seed = ::qHash( key.rotation, seed );
+    return seed ^ uint( key.layout ) ^ ( uint( key.dpiX ) << 8 ) ^ ( uint( key.dpiY ) << 20 );
+}
+
+}
+
+class Q_DECL_HIDDEN TextMeasurementCache::Private
+{
+public:
+    Private()
+        : sizes( 4096 )
+        , hits( 0 )
+        , misses( 0 )
+    {}
+
+    mutable QMutex mutex;
+    QCache< MeasurementKey, QSizeF > sizes;
+    quint64 hits;
+    quint64 misses;
+};
+
+static QSizeF measureText( const QString& text, const QFont& font, int layout, qreal rotation,
+                           const QPaintDevice* paintDevice )
+{
+    QSizeF size;
+    if ( layout == TextMeasurementCache::FontMetricsLayout ) {
+        const QFontMetricsF fm( font, const_cast< QPaintDevice* >( paintDevice ) );
+        const QRectF veryLarge( 0, 0, 100000, 100000 );
+        size = fm.boundingRect( veryLarge, Qt::AlignLeft | Qt::AlignTop, text ).size();
+    } else {
+        QTextDocument doc;
+        doc.setDocumentMargin( 0 );
+        if ( layout == TextMeasurementCache::RichTextDocumentLayout ) {
+            doc.setHtml( text );
+        } else {
+            doc.setPlainText( text );
+        }
+        doc.setDefaultFont( font );
+        size = doc.documentLayout()->frameBoundingRect( doc.rootFrame() ).size();
+    }
+
+    if ( rotation != 0.0 ) {
+        QTransform t;
+        t.rotate( rotation );
+        size = t.mapRect( QRectF( QPointF( 0.0, 0.0 ), size ) ).size();
+    }
+    return size;
+}
+
+TextMeasurementCache::TextMeasurementCache()
+    : d( new Private )
+{
+}
+
+TextMeasurementCache::~TextMeasurementCache()
+{
+    delete d;
+}
+
+TextMeasurementCache* TextMeasurementCache::instance()
+{
+    static TextMeasurementCache instance;
+    return &instance;
+}
+
+QSizeF TextMeasurementCache::textSize( const QString& text, const QFont& font, Layout layout,
+                                       qreal rotation, const QPaintDevice* paintDevice )
+{
+    if ( !paintDevice ) {
+        paintDevice = GlobalMeasureScaling::paintDevice();
+    }
+    const MeasurementKey key( text, font, layout, rotation,
+                              paintDevice ? paintDevice->logicalDpiX() : -1,
+                              paintDevice ? paintDevice->logicalDpiY() : -1 );
+
+    {
+        QMutexLocker locker( &d->mutex );
+        if ( const QSizeF* size = d->sizes.object( key ) ) {
+            ++d->hits;
+            return *size;
+        }
+        ++d->misses;
+    }
+
+    // measure without holding the lock, text layout is by far the most expensive part
+    const QSizeF size = measureText( text, font, layout, rotation, paintDevice );
+
+    QMutexLocker locker( &d->mutex );
+    d->sizes.insert( key, new QSizeF( size ) );
+    return size;
+}
+
+void TextMeasurementCache::setCapacity( int capacity )
+{
+    QMutexLocker locker( &d->mutex );
+    d->sizes.setMaxCost( qMax( capacity, 0 ) );
+}
+
+int TextMeasurementCache::capacity() const
+{
+    QMutexLocker locker( &d->mutex );
+    return d->sizes.maxCost();
+}
+
+int TextMeasurementCache::count() const
+{
+    QMutexLocker locker( &d->mutex );
+    return d->sizes.count();
+}
+
+quint64 TextMeasurementCache::hitCount() const
+{
+    QMutexLocker locker( &d->mutex );
+    return d->hits;
+}
+
+quint64 TextMeasurementCache::missCount() const
+{
+    QMutexLocker locker( &d->mutex );
+    return d->misses;
+}
+
+void TextMeasurementCache::resetStatistics()
+{
+    QMutexLocker locker( &d->mutex );
+    d->hits = 0;
+    d->misses = 0;
+}
+
+void TextMeasurementCache::clear()
+{
+    QMutexLocker locker( &d->mutex );
+    d->sizes.clear();
+}
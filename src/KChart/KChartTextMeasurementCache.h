@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef KCHARTTEXTMEASUREMENTCACHE_H
+#define KCHARTTEXTMEASUREMENTCACHE_H
+
+#include <QSizeF>
+
+#include "KChartGlobal.h"
+
+QT_BEGIN_NAMESPACE
+class QFont;
+class QPaintDevice;
+class QString;
+QT_END_NAMESPACE
+
+namespace KChart {
+
+    /**
+     * \brief A chart-wide cache of text sizes.
+     *
+     * Axis labels, legend entries, headers, footers and data value texts all ask this cache
+     * for the size of their text instead of setting up font metrics or a text document each
+     * time. Entries are keyed by the text, the font, the rotation, the kind of layout and the
+     * resolution of the paint device; the least recently used ones are dropped once the
+     * capacity is reached.
+     *
+     * The cache is shared by all charts and may be used from several threads.
+     * hitCount() and missCount() tell how well it works for a given application.
+     */
+class KCHART_EXPORT TextMeasurementCache
+{
+    Q_DISABLE_COPY( TextMeasurementCache )
+    class Private;
+public:
+    enum Layout {
+        /// Measured with QFontMetricsF::boundingRect( QRect, int, QString ), honoring line breaks.
+        FontMetricsLayout,
+        /// Measured as the frame of a QTextDocument set up with setPlainText().
+        PlainTextDocumentLayout,
+        /// Measured as the frame of a QTextDocument set up with setHtml().
+        RichTextDocumentLayout
+    };
+
+    /**
+     * \return The cache shared by all charts.
+     */
+    static TextMeasurementCache* instance();
+
+    /**
+     * \return The size of \a text laid out in \a font as described by \a layout.
+     * If \a rotation (in degrees) is not 0, the size of the bounding rectangle of the
+     * rotated text is returned. \a paintDevice defaults to
+     * GlobalMeasureScaling::paintDevice().
+     */
+    QSizeF textSize( const QString& text, const QFont& font, Layout layout = FontMetricsLayout,
+                     qreal rotation = 0.0, const QPaintDevice* paintDevice = nullptr );
+
+    /**
+     * Set the maximum number of measurements kept. The default is 4096.
+     */
+    void setCapacity( int capacity );
+    int capacity() const;
+
+    /**
+     * \return The number of measurements currently kept.
+     */
+    int count() const;
+
+    /**
+     * \return How many calls of textSize() were answered from the cache.
+     */
+    quint64 hitCount() const;
+
+    /**
+     * \return How many calls of textSize() had to measure the text.
+     */
+    quint64 missCount() const;
+
+    /**
+     * Set hitCount() and missCount() back to zero.
+     */
+    void resetStatistics();
+
+    /**
+     * Forget all measurements, e.g. after the application font database changed.
+     */
+    void clear();
+
+private:
+    TextMeasurementCache();
+    ~TextMeasurementCache();
+
+    Private* const d;
+};
+
+}
+
+#endif // KCHARTTEXTMEASUREMENTCACHE_H
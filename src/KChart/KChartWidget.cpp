@@ -80,47 +80,95 @@ void Widget::setDataset( int column, const QVector< qreal > & data, const QStrin
     if ( ! checkDatasetWidth( 1 ) )
         return;
 
-    QStandardItemModel & model = d->m_model;
+    WidgetModel & model = d->m_model;
 
     justifyModelSize( data.size(), column + 1 );
 
-    for ( int i = 0; i < data.size(); ++i )
-    {
-        const QModelIndex index = model.index( i, column );
-        model.setData( index, QVariant( data[i] ), Qt::DisplayRole );
-    }
+    model.setColumn( column, data );
+    if ( ! title.isEmpty() )
+        model.setHeaderData( column, Qt::Horizontal, QVariant( title ) );
+}
+
+void Widget::setDataset( int column, QVector< qreal > && data, const QString& title )
+{
+    if ( ! checkDatasetWidth( 1 ) )
+        return;
+
+    WidgetModel & model = d->m_model;
+
+    justifyModelSize( data.size(), column + 1 );
+
+    model.setColumn( column, std::move( data ) );
     if ( ! title.isEmpty() )
         model.setHeaderData( column, Qt::Horizontal, QVariant( title ) );
 }
 
+// splits (X, Y) pairs into the X and the Y values
+static void splitPairs( const QVector< QPair< qreal, qreal > > & data, QVector< qreal >* xValues, QVector< qreal >* yValues )
+{
+    xValues->reserve( data.size() );
+    yValues->reserve( data.size() );
+    for ( const QPair< qreal, qreal >& pair : data ) {
+        xValues->append( pair.first );
+        yValues->append( pair.second );
+    }
+}
+
 void Widget::setDataset( int column, const QVector< QPair< qreal, qreal > > & data, const QString& title )
 {
     if ( ! checkDatasetWidth( 2 ))
         return;
 
-    QStandardItemModel & model = d->m_model;
+    WidgetModel & model = d->m_model;
 
     justifyModelSize( data.size(), (column + 1) * 2 );
 
-    for ( int i = 0; i < data.size(); ++i )
-    {
-        QModelIndex index = model.index( i, column * 2 );
-        model.setData( index, QVariant( data[i].first ), Qt::DisplayRole );
-
-        index = model.index( i, column * 2 + 1 );
-        model.setData( index, QVariant( data[i].second ), Qt::DisplayRole );
-    }
+    QVector< qreal > xValues;
+    QVector< qreal > yValues;
+    splitPairs( data, &xValues, &yValues );
+    model.setColumn( column * 2, std::move( xValues ) );
+    model.setColumn( column * 2 + 1, std::move( yValues ) );
     if ( ! title.isEmpty() ) {
         model.setHeaderData( column,   Qt::Horizontal, QVariant( title ) );
     }
 }
 
+void Widget::appendToDataset( int column, const QVector< qreal > & data )
+{
+    if ( ! checkDatasetWidth( 1 ) )
+        return;
+
+    WidgetModel & model = d->m_model;
+    const int startRow = model.columnLength( column );
+
+    justifyModelSize( startRow + data.size(), column + 1 );
+
+    model.setColumn( column, startRow, data );
+}
+
+void Widget::appendToDataset( int column, const QVector< QPair< qreal, qreal > > & data )
+{
+    if ( ! checkDatasetWidth( 2 ))
+        return;
+
+    WidgetModel & model = d->m_model;
+    const int startRow = qMax( model.columnLength( column * 2 ), model.columnLength( column * 2 + 1 ) );
+
+    justifyModelSize( startRow + data.size(), (column + 1) * 2 );
+
+    QVector< qreal > xValues;
+    QVector< qreal > yValues;
+    splitPairs( data, &xValues, &yValues );
+    model.setColumn( column * 2, startRow, xValues );
+    model.setColumn( column * 2 + 1, startRow, yValues );
+}
+
 void Widget::setDataCell( int row, int column, qreal data )
 {
     if ( ! checkDatasetWidth( 1 ) )
         return;
 
-    QStandardItemModel & model = d->m_model;
+    WidgetModel & model = d->m_model;
 
     justifyModelSize( row + 1, column + 1 );
 
@@ -133,7 +181,7 @@ void Widget::setDataCell( int row, int column, QPair< qreal, qreal > data )
     if ( ! checkDatasetWidth( 2 ))
         return;
 
-    QStandardItemModel & model = d->m_model;
+    WidgetModel & model = d->m_model;
 
     justifyModelSize( row + 1, (column + 1) * 2 );
 
@@ -75,9 +75,15 @@ namespace KChart {
        ~Widget();
         /** Sets the data in the given column using a QVector of qreal for the Y values. */
         void setDataset( int column, const QVector< qreal > & data, const QString& title = QString() );
+        /** Sets the data in the given column, taking over \a data instead of copying it if possible. */
+        void setDataset( int column, QVector< qreal > && data, const QString& title = QString() );
         /** Sets the data in the given column using a QVector of QPairs
          *  of qreal for the (X, Y) values. */
         void setDataset( int column, const QVector< QPair< qreal, qreal > > &  data, const QString& title = QString() );
+        /** Appends the Y values in \a data to the given column. */
+        void appendToDataset( int column, const QVector< qreal > & data );
+        /** Appends the (X, Y) values in \a data to the given column. */
+        void appendToDataset( int column, const QVector< QPair< qreal, qreal > > & data );
         /** Sets the Y value data for a given cell. */
         void setDataCell( int row, int column, qreal data );
         /** Sets the data for a given column using an (X, Y) QPair of qreals. */
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "KChartWidgetModel_p.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "KChartMath_p.h"
+
+using namespace KChart;
+
+WidgetModel::WidgetModel( QObject* parent )
+    : QAbstractTableModel( parent ),
+      m_rowCount( 0 )
+{
+}
+
+WidgetModel::~WidgetModel()
+{
+}
+
+int WidgetModel::rowCount( const QModelIndex& parent ) const
+{
+    return parent.isValid() ? 0 : m_rowCount;
+}
+
+int WidgetModel::columnCount( const QModelIndex& parent ) const
+{
+    return parent.isValid() ? 0 : m_columns.size();
+}
+
+QVariant WidgetModel::data( const QModelIndex& index, int role ) const
+{
+    if ( !index.isValid() || ( role != Qt::DisplayRole && role != Qt::EditRole ) ) {
+        return QVariant();
+    }
+    const qreal value = m_columns.at( index.column() ).at( index.row() );
+    // like an empty cell of a QStandardItemModel
+    return ISNAN( value ) ? QVariant() : QVariant( value );
+}
+
+bool WidgetModel::setData( const QModelIndex& index, const QVariant& value, int role )
+{
+    if ( !index.isValid() || ( role != Qt::DisplayRole && role != Qt::EditRole ) ) {
+        return false;
+    }
+    qreal number = std::numeric_limits< qreal >::quiet_NaN();
+    if ( value.isValid() ) {
+        bool ok = false;
+        number = value.toReal( &ok );
+        if ( !ok ) {
+            return false;
+        }
+    }
+    m_columns[ index.column() ][ index.row() ] = number;
+    m_columnLengths[ index.column() ] = qMax( m_columnLengths.at( index.column() ), index.row() + 1 );
+    emit dataChanged( index, index );
+    return true;
+}
+
+QVariant WidgetModel::headerData( int section, Qt::Orientation orientation, int role ) const
+{
+    if ( orientation == Qt::Horizontal && ( role == Qt::DisplayRole || role == Qt::EditRole ) &&
+         section >= 0 && section < m_headers.size() && m_headers.at( section ).isValid() ) {
+        return m_headers.at( section );
+    }
+    return QAbstractTableModel::headerData( section, orientation, role );
+}
+
+bool WidgetModel::setHeaderData( int section, Qt::Orientation orientation, const QVariant& value, int role )
+{
+    if ( orientation != Qt::Horizontal || ( role != Qt::DisplayRole && role != Qt::EditRole ) ||
+         section < 0 || section >= m_headers.size() ) {
+        return false;
+    }
+    m_headers[ section ] = value;
+    emit headerDataChanged( orientation, section, section );
+    return true;
+}
+
+Qt::ItemFlags WidgetModel::flags( const QModelIndex& index ) const
+{
+    return QAbstractTableModel::flags( index ) | Qt::ItemIsEditable;
+}
+
+bool WidgetModel::insertRows( int row, int count, const QModelIndex& parent )
+{
+    if ( parent.isValid() || row < 0 || row > m_rowCount || count < 1 ) {
+        return false;
+    }
+    beginInsertRows( parent, row, row + count - 1 );
+    for ( int column = 0; column < m_columns.size(); ++column ) {
+        m_columns[ column ].insert( row, count, std::numeric_limits< qreal >::quiet_NaN() );
+        if ( row < m_columnLengths.at( column ) ) {
+            m_columnLengths[ column ] += count;
+        }
+    }
+    m_rowCount += count;
+    endInsertRows();
+    return true;
+}
+
+bool WidgetModel::insertColumns( int column, int count, const QModelIndex& parent )
+{
+    if ( parent.isValid() || column < 0 || column > m_columns.size() || count < 1 ) {
+        return false;
+    }
+    beginInsertColumns( parent, column, column + count - 1 );
+    m_columns.insert( column, count, QVector< qreal >( m_rowCount, std::numeric_limits< qreal >::quiet_NaN() ) );
+    m_columnLengths.insert( column, count, 0 );
+    m_headers.insert( column, count, QVariant() );
+    endInsertColumns();
+    return true;
+}
+
+void WidgetModel::setColumn( int column, const QVector< qreal >& values )
+{
+    setColumn( column, 0, values );
+}
+
+void WidgetModel::setColumn( int column, QVector< qreal >&& values )
+{
+    Q_ASSERT( column >= 0 && column < m_columns.size() );
+    if ( values.size() != m_rowCount ) {
+        setColumn( column, 0, values );
+        return;
+    }
+    m_columns[ column ] = std::move( values );
+    m_columnLengths[ column ] = m_rowCount;
+    if ( m_rowCount > 0 ) {
+        emit dataChanged( index( 0, column ), index( m_rowCount - 1, column ) );
+    }
+}
+
+void WidgetModel::setColumn( int column, int startRow, const QVector< qreal >& values )
+{
+    Q_ASSERT( column >= 0 && column < m_columns.size() );
+    Q_ASSERT( startRow >= 0 && startRow + values.size() <= m_rowCount );
+    if ( values.isEmpty() ) {
+        return;
+    }
+    std::copy( values.constBegin(), values.constEnd(), m_columns[ column ].begin() + startRow );
+    const int endRow = startRow + values.size();
+    m_columnLengths[ column ] = qMax( m_columnLengths.at( column ), endRow );
+    emit dataChanged( index( startRow, column ), index( endRow - 1, column ) );
+}
+
+int WidgetModel::columnLength( int column ) const
+{
+    return m_columnLengths.value( column );
+}
+
+void WidgetModel::clear()
+{
+    beginResetModel();
+    m_columns.clear();
+    m_columnLengths.clear();
+    m_headers.clear();
+    m_rowCount = 0;
+    endResetModel();
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef KCHARTWIDGETMODEL_P_H
+#define KCHARTWIDGETMODEL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QAbstractTableModel>
+#include <QVariant>
+#include <QVector>
+
+namespace KChart {
+
+/**
+ * \internal
+ *
+ * The model behind KChart::Widget. The values are kept column by column in
+ * contiguous vectors of qreal, with NaN for the cells that were never set.
+ * Whole datasets can be replaced or extended at once, which is announced
+ * with a single signal instead of one per cell.
+ */
+class WidgetModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    explicit WidgetModel( QObject* parent = nullptr );
+    ~WidgetModel();
+
+    int rowCount( const QModelIndex& parent = QModelIndex() ) const override;
+    int columnCount( const QModelIndex& parent = QModelIndex() ) const override;
+    QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const override;
+    bool setData( const QModelIndex& index, const QVariant& value, int role = Qt::EditRole ) override;
+    QVariant headerData( int section, Qt::Orientation orientation, int role = Qt::DisplayRole ) const override;
+    bool setHeaderData( int section, Qt::Orientation orientation, const QVariant& value,
+                        int role = Qt::EditRole ) override;
+    Qt::ItemFlags flags( const QModelIndex& index ) const override;
+    bool insertRows( int row, int count, const QModelIndex& parent = QModelIndex() ) override;
+    bool insertColumns( int column, int count, const QModelIndex& parent = QModelIndex() ) override;
+
+    /**
+     * Sets the first values.size() cells of \a column. The model needs to have
+     * enough rows and columns already.
+     */
+    void setColumn( int column, const QVector< qreal >& values );
+    /**
+     * Same as above, but takes over \a values if they cover the whole column.
+     */
+    void setColumn( int column, QVector< qreal >&& values );
+    /**
+     * Sets the cells of \a column from row \a startRow on. The model needs to
+     * have enough rows and columns already.
+     */
+    void setColumn( int column, int startRow, const QVector< qreal >& values );
+
+    /**
+     * \return The number of rows of \a column up to the last one that was set.
+     */
+    int columnLength( int column ) const;
+
+    /** Removes all data, rows and columns. */
+    void clear();
+
+private:
+    QVector< QVector< qreal > > m_columns;
+    QVector< int > m_columnLengths;
+    QVector< QVariant > m_headers;
+    int m_rowCount;
+};
+
+}
+
+#endif // KCHARTWIDGETMODEL_P_H
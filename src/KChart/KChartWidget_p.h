@@ -36,9 +36,9 @@
 #include <KChartCartesianCoordinatePlane.h>
 #include <KChartPolarCoordinatePlane.h>
 #include "KChartMath_p.h"
+#include "KChartWidgetModel_p.h"
 
 #include <QGridLayout>
-#include <QStandardItemModel>
 
 /**
  * \internal
@@ -53,7 +53,7 @@ public:
 
 protected:
     QGridLayout layout;
-    QStandardItemModel m_model;
+    WidgetModel m_model;
     Chart m_chart;
     CartesianCoordinatePlane m_cartPlane;
     PolarCoordinatePlane m_polPlane;
@@ -33,6 +33,7 @@
 
 #include "KChartAbstractPieDiagram.h"
 #include "KChartAbstractPolarDiagram_p.h"
+#include "KChartAngleTable_p.h"
 #include <KChartAbstractThreeDAttributes.h>
 #include "KChartMath_p.h"
 
@@ -58,9 +59,19 @@ public:
         {
         }
 
+    /**
+     * \return The directions of the multiples of \a granularity, for drawing arcs
+     */
+    const AngleTable& arcSteps( qreal granularity ) const
+    {
+        arcStepTable.setStep( granularity );
+        return arcStepTable;
+    }
+
 private:
     qreal granularity;
     bool autoRotateLabels;
+    mutable AngleTable arcStepTable;
 };
 
 KCHART_IMPL_DERIVED_DIAGRAM( AbstractPieDiagram, AbstractPolarDiagram, PolarCoordinatePlane )
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KD Chart library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef KCHARTANGLETABLE_P_H
+#define KCHARTANGLETABLE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the KD Chart API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QPointF>
+#include <QVector>
+
+#include "KChartMath_p.h"
+
+
+namespace KChart {
+
+/**
+   \internal
+
+   @short The directions of the multiples of an angle, for walking along arcs
+
+   A direction is the cosine and sine of an angle, as returned by direction(). Rotating the
+   direction of a start angle by the table entries gives the directions of the following
+   points of an arc, without evaluating cos() and sin() for each of them.
+*/
+class AngleTable
+{
+public:
+    AngleTable()
+        : m_step( 0.0 )
+    {
+    }
+
+    /**
+       Prepares the multiples of \a stepDegrees up to a full circle, unless that was
+       done for this step already.
+    */
+    void setStep( qreal stepDegrees )
+    {
+        if ( stepDegrees == m_step ) {
+            return;
+        }
+        m_step = stepDegrees;
+        m_rotations.clear();
+        if ( !( stepDegrees > 0.0 ) ) {
+            return;
+        }
+        // two more than a full circle, arcs are walked in floating point steps
+        const int count = int( std::ceil( 360.0 / stepDegrees ) ) + 2;
+        m_rotations.resize( count );
+        for ( int i = 0; i < count; ++i ) {
+            m_rotations[ i ] = direction( i * stepDegrees );
+        }
+    }
+
+    qreal step() const
+    {
+        return m_step;
+    }
+
+    /**
+       \return The cosine and the sine of \a degrees, as x and y.
+    */
+    static QPointF direction( qreal degrees )
+    {
+        const qreal radians = DEGTORAD( degrees );
+        return QPointF( std::cos( radians ), std::sin( radians ) );
+    }
+
+    /**
+       \return The direction \a steps steps of step() degrees away from \a start, which is a
+       direction as returned by direction(). Negative \a steps go clockwise.
+    */
+    QPointF rotated( const QPointF& start, int steps ) const
+    {
+        const int i = steps < 0 ? -steps : steps;
+        if ( i >= m_rotations.count() ) {
+            return direction( std::atan2( start.y(), start.x() ) * 180.0 / M_PI + steps * m_step );
+        }
+        const QPointF& rotation = m_rotations.at( i );
+        const qreal sine = steps < 0 ? -rotation.y() : rotation.y();
+        return QPointF( start.x() * rotation.x() - start.y() * sine,
+                        start.y() * rotation.x() + start.x() * sine );
+    }
+
+private:
+    qreal m_step;
+    QVector< QPointF > m_rotations;
+};
+
+}
+
+#endif /* KCHARTANGLETABLE_P_H */
@@ -31,6 +31,8 @@
 #include <QPainter>
 #include <QStack>
 
+#include <algorithm>
+
 
 using namespace KChart;
 
@@ -295,65 +297,148 @@ static int wraparound( int i, int size )
     return i;
 }
 
-//#define SHUFFLE_DEBUG
+// vertical distance kept between labels moved to avoid a collision
+static const qreal labelSpacing = 1.0;
+
+// a run of labels stacked directly on top of each other, see stackLabels()
+struct LabelCluster
+{
+    qreal top;
+    qreal height;
+    // sum over all members of (preferred top - offset of the member inside the cluster)
+    qreal preferredTopSum;
+    int count;
+};
+
+// Place the labels in @p column into non-overlapping vertical slots as close as possible to where
+// they are now, and store the vertical offset of each in @p dy.
+// Labels are visited from top to bottom; overlapping runs are merged into clusters that are
+// centered on the average preferred position of their members, so this is a single pass.
+static void stackLabels( const QVector< QRectF >& rects, QVector< int > column, QVector< qreal >* dy )
+{
+    std::sort( column.begin(), column.end(), [&rects]( int a, int b ) {
+        return rects[ a ].top() < rects[ b ].top();
+    } );
+
+    QVector< LabelCluster > clusters;
+    clusters.reserve( column.count() );
+    for ( int label : qAsConst( column ) ) {
+        LabelCluster cluster;
+        cluster.top = rects[ label ].top();
+        cluster.height = rects[ label ].height() + labelSpacing;
+        cluster.preferredTopSum = cluster.top;
+        cluster.count = 1;
+        clusters.append( cluster );
+
+        while ( clusters.count() >= 2 ) {
+            LabelCluster& prev = clusters[ clusters.count() - 2 ];
+            const LabelCluster& last = clusters.last();
+            if ( prev.top + prev.height <= last.top ) {
+                break;
+            }
+            // the members of last are offset by prev.height in the merged cluster
+            prev.preferredTopSum += last.preferredTopSum - last.count * prev.height;
+            prev.count += last.count;
+            prev.height += last.height;
+            prev.top = prev.preferredTopSum / prev.count;
+            clusters.removeLast();
+        }
+    }
+
+    int i = 0;
+    for ( const LabelCluster& cluster : qAsConst( clusters ) ) {
+        qreal top = cluster.top;
+        for ( int j = 0; j < cluster.count; j++, i++ ) {
+            const int label = column[ i ];
+            ( *dy )[ label ] = top - rects[ label ].top();
+            top += rects[ label ].height() + labelSpacing;
+        }
+    }
+}
 
 void PieDiagram::shuffleLabels( QRectF* textBoundingRect )
 {
-    // things that could be improved here:
-    // - use a variable number (chosen using angle information) of neighbors to check
-    // - try harder to arrange the labels to look nice
-
-    // ideas:
-    // - leave labels that don't collide alone (only if they their offset is zero)
-    // - use a graphics view for collision detection
+    // The labels on each side of the pie are laid out as a column of vertical slots, so labels
+    // that don't collide stay where they are and the rest moves as little as possible.
+    // Exact intersection tests are only used to verify the result and to resolve the few
+    // collisions that the columns can't see, e.g. between labels straddling the vertical center
+    // line of the pie.
 
     LabelPaintCache& lpc = d->labelPaintCache;
     const int n = lpc.paintReplay.size();
-    bool modified = false;
-    qreal direction = 5.0;
-    QVector< qreal > offsets;
-    offsets.fill( 0.0, n );
+    if ( n < 2 ) {
+        return;
+    }
 
-    for ( bool lastRoundModified = true; lastRoundModified; ) {
-        lastRoundModified = false;
+    QVector< QRectF > rects( n );
+    QVector< int > leftColumn;
+    QVector< int > rightColumn;
+    for ( int i = 0; i < n; i++ ) {
+        rects[ i ] = lpc.paintReplay[ i ].labelArea.boundingRect();
+        const uint slice = lpc.paintReplay[ i ].index.column();
+        const qreal angle = DEGTORAD( d->startAngles[ slice ] + d->angleLens[ slice ] / 2.0 );
+        if ( cos( angle ) >= 0.0 ) {
+            rightColumn.append( i );
+        } else {
+            leftColumn.append( i );
+        }
+    }
 
-        for ( int i = 0; i < n; i++ ) {
-            const int neighborsToCheck = qMax( 10, lpc.paintReplay.size() - 1 );
-            const int minComp = wraparound( i - neighborsToCheck / 2, n );
-            const int maxComp = wraparound( i + ( neighborsToCheck + 1 ) / 2, n );
+    QVector< qreal > dy( n, 0.0 );
+    stackLabels( rects, leftColumn, &dy );
+    stackLabels( rects, rightColumn, &dy );
 
-            QPainterPath& path = lpc.paintReplay[ i ].labelArea;
+    bool modified = false;
+    for ( int i = 0; i < n; i++ ) {
+        if ( dy[ i ] != 0.0 ) {
+            lpc.paintReplay[ i ].labelArea.translate( 0.0, dy[ i ] );
+            rects[ i ].translate( 0.0, dy[ i ] );
+            modified = true;
+        }
+    }
 
-            for ( int j = minComp; j != maxComp; j = wraparound( j + 1, n ) ) {
-                if ( i == j ) {
-                    continue;
-                }
-                QPainterPath& otherPath = lpc.paintReplay[ j ].labelArea;
-
-                while ( ( offsets[ i ] + direction > 0 ) && otherPath.intersects( path ) ) {
-#ifdef SHUFFLE_DEBUG
-                    qDebug() << "collision involving" << j << "and" << i << " -- n =" << n;
-                    TextAttributes ta = lpc.paintReplay[ i ].attrs.textAttributes();
-                    ta.setPen( QPen( Qt::white ) );
-                    lpc.paintReplay[ i ].attrs.setTextAttributes( ta );
-#endif
-                    uint slice = lpc.paintReplay[ i ].index.column();
-                    qreal angle = DEGTORAD( d->startAngles[ slice ] + d->angleLens[ slice ] / 2.0 );
-                    qreal dx = cos( angle ) * direction;
-                    qreal dy = -sin( angle ) * direction;
-                    offsets[ i ] += direction;
-                    path.translate( dx, dy );
-                    lastRoundModified = true;
+    // verify, moving down any label that still collides with one above it
+    QVector< int > order( n );
+    for ( int i = 0; i < n; i++ ) {
+        order[ i ] = i;
+    }
+    std::sort( order.begin(), order.end(), [&rects]( int a, int b ) {
+        return rects[ a ].top() < rects[ b ].top();
+    } );
+
+    QVector< int > placed;
+    for ( int i : qAsConst( order ) ) {
+        // labels only ever move down, so those ending above this one can't collide with it or
+        // with any of the following ones anymore
+        for ( int j = 0; j < placed.count(); ) {
+            if ( rects[ placed[ j ] ].bottom() < rects[ i ].top() ) {
+                placed[ j ] = placed.last();
+                placed.removeLast();
+            } else {
+                j++;
+            }
+        }
+
+        QPainterPath& path = lpc.paintReplay[ i ].labelArea;
+        for ( bool moved = true; moved; ) {
+            moved = false;
+            for ( int other : qAsConst( placed ) ) {
+                if ( rects[ i ].intersects( rects[ other ] ) &&
+                     path.intersects( lpc.paintReplay[ other ].labelArea ) ) {
+                    const qreal push = rects[ other ].bottom() + labelSpacing - rects[ i ].top();
+                    path.translate( 0.0, push );
+                    rects[ i ].translate( 0.0, push );
+                    moved = true;
+                    modified = true;
                 }
             }
         }
-        direction *= -1.07; // this can "overshoot", but avoids getting trapped in local minimums
-        modified = modified || lastRoundModified;
+        placed.append( i );
     }
 
     if ( modified ) {
-        for ( int i = 0; i < lpc.paintReplay.size(); i++ ) {
-            *textBoundingRect |= lpc.paintReplay[ i ].labelArea.boundingRect();
+        for ( int i = 0; i < n; i++ ) {
+            *textBoundingRect |= rects[ i ];
         }
     }
 }
@@ -549,6 +634,13 @@ void PieDiagram::drawSlice( QPainter* painter, const QRectF& drawPosition, uint
     drawSliceSurface( painter, adjustedDrawPosition, slice );
 }
 
+// the point of the ellipse inscribed into boundingBox in the given direction, see AngleTable
+static QPointF ellipsePoint( const QRectF& boundingBox, const QPointF& direction )
+{
+    return QPointF( direction.x() * boundingBox.width() / 2.0 + boundingBox.center().x(),
+                    -direction.y() * boundingBox.height() / 2.0 + boundingBox.center().y() );
+}
+
 void PieDiagram::drawSliceSurface( QPainter* painter, const QRectF& drawPosition, uint slice )
 {
     // Is there anything to draw at all?
@@ -588,8 +680,10 @@ void PieDiagram::drawSliceSurface( QPainter* painter, const QRectF& drawPosition
         int iPoint = 0;
         bool perfectMatch = false;
 
+        const AngleTable& arcSteps = d->arcSteps( granularity() );
+        const QPointF startDirection = AngleTable::direction( startAngle );
         while ( degree <= angleLen ) {
-            poly[ iPoint ] = pointOnEllipse( drawPosition, startAngle + degree );
+            poly[ iPoint ] = ellipsePoint( drawPosition, arcSteps.rotated( startDirection, iPoint ) );
             //qDebug() << degree << angleLen << poly[ iPoint ];
             perfectMatch = ( degree == angleLen );
             degree += granularity();
@@ -792,8 +886,10 @@ void PieDiagram::draw3dOuterRim( QPainter* painter,
     qreal degree = endAngle;
     int iPoint = 0;
     bool perfectMatch = false;
+    const AngleTable& arcSteps = d->arcSteps( granularity() );
+    const QPointF endDirection = AngleTable::direction( endAngle );
     while ( degree >= startAngle ) {
-        poly[ numHalfPoints - iPoint - 1 ] = pointOnEllipse( rect, degree );
+        poly[ numHalfPoints - iPoint - 1 ] = ellipsePoint( rect, arcSteps.rotated( endDirection, -iPoint ) );
 
         perfectMatch = (degree == startAngle);
         degree -= granularity();
@@ -863,14 +959,7 @@ uint PieDiagram::findRightSlice( uint slice, int colCount )
 
 QPointF PieDiagram::pointOnEllipse( const QRectF& boundingBox, qreal angle )
 {
-    qreal angleRad = DEGTORAD( angle );
-    qreal cosAngle = cos( angleRad );
-    qreal sinAngle = -sin( angleRad );
-    qreal posX = cosAngle * boundingBox.width() / 2.0;
-    qreal posY = sinAngle * boundingBox.height() / 2.0;
-    return QPointF( posX + boundingBox.center().x(),
-                    posY + boundingBox.center().y() );
-
+    return ellipsePoint( boundingBox, AngleTable::direction( angle ) );
 }
 
 /*virtual*/
@@ -62,6 +62,8 @@ public:
     LabelDecorations labelDecorations() const;
 
     /// If @p enabled is set to true, labels that would overlap will be shuffled to avoid overlap.
+    /// The labels on each side of the pie are moved vertically, to the free position closest
+    /// to where they would otherwise be.
     /// \note Collision avoidance may allow labels to be closer than AbstractDiagram with
     ///       allowOverlappingDataValueTexts() == false, so you should usually also call
     ///       setAllowOverlappingDataValueTexts( true ) if you enable this feature.
@@ -27,6 +27,7 @@
 #include "KChartAbstractPolarDiagram.h"
 #include "KChartPolarDiagram.h"
 #include "KChartMath_p.h"
+#include "KChartPerfObserver_p.h"
 
 #include <QFont>
 #include <QList>
@@ -115,6 +116,7 @@ void PolarCoordinatePlane::paint ( QPainter* painter )
     // paint the diagrams which will re-use their DataValueTextInfoList(s) filled in step 1:
     for ( int i = 0; i < diags.size(); i++ ) {
         d->currentTransformation = & ( d->coordinateTransformations[i] );
+        const PerfPhaseTimer perfTimer( PerfObserver::DiagramPaintPhase, diags[i] );
         PainterSaver painterSaver( painter );
         PolarDiagram* polarDia = dynamic_cast<PolarDiagram*>( diags[i] );
         if ( polarDia ) {
@@ -183,6 +185,7 @@ void PolarCoordinatePlane::layoutDiagrams()
             diagramTransposition.startPosition = oldStartPosition;
             diagramTransposition.zoom = zoom;
             diagramTransposition.minValue = dataBoundariesPair.first.y() < 0 ? dataBoundariesPair.first.y() : 0.0;
+            diagramTransposition.updateSpokeDirections();
             d->coordinateTransformations.append( diagramTransposition );
         }
     update();
@@ -231,6 +234,7 @@ void PolarCoordinatePlane::setStartPosition( qreal degrees )
     {
         CoordinateTransformation& trans = *it;
         trans.startPosition = degrees;
+        trans.updateSpokeDirections();
     }
 }
 
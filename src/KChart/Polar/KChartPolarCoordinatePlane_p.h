@@ -36,6 +36,8 @@
 #include "KChartPolarGrid.h"
 #include "KChartMath_p.h"
 
+#include <QVector>
+
 
 namespace KChart {
 
@@ -54,6 +56,26 @@ struct PolarCoordinatePlane::CoordinateTransformation
     qreal startPosition;
     ZoomParameters zoom;
 
+    // the directions of the whole-numbered angular positions, usually the rows of the
+    // diagram, so that translating data points does not need cos() and sin()
+    QVector< QPointF > spokeDirections;
+
+    void updateSpokeDirections()
+    {
+        static const qreal maxSpokeCount = 1 << 16;
+        const qreal spokeCount = 360.0 / angleUnit;
+        spokeDirections.clear();
+        if ( !( spokeCount >= 0.0 && spokeCount < maxSpokeCount ) ) {
+            return;
+        }
+        // reversed radar diagrams start one spoke after the last one
+        spokeDirections.resize( int( spokeCount ) + 2 );
+        for ( int i = 0; i < spokeDirections.count(); ++i ) {
+            const qreal theta = DEGTORAD( ( i * -angleUnit ) - 90.0 - startPosition );
+            spokeDirections[ i ] = QPointF( cos( theta ), sin( theta ) );
+        }
+    }
+
     static QPointF polarToCartesian( qreal R, qreal theta )
     {
         // de-inline me
@@ -66,9 +88,16 @@ struct PolarCoordinatePlane::CoordinateTransformation
         // calculate the polar coordinates
         const qreal x = (diagramPoint.x() * radiusUnit) - (minValue * radiusUnit);
 //qDebug() << x << "=" << diagramPoint.x() << "*" << radiusUnit << "  startPosition: " << startPosition;
-        const qreal y = ( diagramPoint.y() * -angleUnit) - 90.0 - startPosition;
         // convert to cartesian coordinates
-        QPointF cartesianPoint = polarToCartesian( x, y );
+        QPointF cartesianPoint;
+        const qreal spoke = diagramPoint.y();
+        if ( spoke >= 0.0 && spoke < spokeDirections.count() && spoke == int( spoke ) ) {
+            const QPointF& direction = spokeDirections.at( int( spoke ) );
+            cartesianPoint = QPointF( x * direction.x(), x * direction.y() );
+        } else {
+            const qreal y = ( spoke * -angleUnit) - 90.0 - startPosition;
+            cartesianPoint = polarToCartesian( x, y );
+        }
         cartesianPoint.setX( cartesianPoint.x() * zoom.xFactor );
         cartesianPoint.setY( cartesianPoint.y() * zoom.yFactor );
 
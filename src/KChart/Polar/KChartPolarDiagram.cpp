@@ -21,6 +21,7 @@
 #include "KChartPolarDiagram_p.h"
 
 #include "KChartPaintContext.h"
+#include "KChartPolarCoordinatePlane.h"
 #include "KChartPainterSaver_p.h"
 #include "KChartMath_p.h"
 
@@ -30,12 +31,126 @@ using namespace KChart;
 
 PolarDiagram::Private::Private() :
     rotateCircularLabels( false ),
-    closeDatasets( false )
+    closeDatasets( false ),
+    geometryValid( false ),
+    fittedZoomX( 1.0 ),
+    fittedZoomY( 1.0 )
 {
 }
 
 PolarDiagram::Private::~Private() {}
 
+PolarDiagram::Private::GeometryKey::GeometryKey() :
+    revision( 0 ),
+    zoomX( 1.0 ),
+    zoomY( 1.0 ),
+    startPosition( 0.0 ),
+    radiusUnit( 0.0 ),
+    angleUnit( 0.0 )
+{
+}
+
+bool PolarDiagram::Private::GeometryKey::operator==( const GeometryKey& other ) const
+{
+    return revision == other.revision &&
+           rectangle == other.rectangle &&
+           planeGeometry == other.planeGeometry &&
+           zoomX == other.zoomX && zoomY == other.zoomY &&
+           zoomCenter == other.zoomCenter &&
+           startPosition == other.startPosition &&
+           radiusUnit == other.radiusUnit &&
+           angleUnit == other.angleUnit;
+}
+
+PolarDiagram::Private::GeometryKey PolarDiagram::Private::geometryKey( PaintContext* ctx ) const
+{
+    GeometryKey key;
+    // the revision covers the data, the attributes and thereby also the data boundaries
+    // the plane derives the transformation of this diagram from
+    key.revision = revision;
+    key.rectangle = ctx->rectangle();
+    key.planeGeometry = plane->geometry();
+    key.zoomX = plane->zoomFactorX();
+    key.zoomY = plane->zoomFactorY();
+    key.zoomCenter = plane->zoomCenter();
+    if ( const PolarCoordinatePlane* polarPlane = qobject_cast< const PolarCoordinatePlane* >( plane.data() ) ) {
+        key.startPosition = polarPlane->startPosition();
+        key.radiusUnit = polarPlane->radiusUnit();
+        key.angleUnit = polarPlane->angleUnit();
+    }
+    return key;
+}
+
+void PolarDiagram::Private::syncValueCache() const
+{
+    if ( valueCache.model() != diagram->model() ) {
+        valueCache.setModel( diagram->model() );
+    }
+    if ( valueCache.rootIndex() != diagram->rootIndex() ) {
+        valueCache.setRootIndex( diagram->rootIndex() );
+    }
+}
+
+qreal PolarDiagram::Private::valueAt( int row, int column ) const
+{
+    const qreal value = valueCache.data( valueCache.model()->index( row, column, valueCache.rootIndex() ) );
+    // like QVariant::toReal(), which was used before, take missing values as 0
+    return ISNAN( value ) ? 0.0 : value;
+}
+
+void PolarDiagram::Private::updateGeometry( PaintContext* ctx )
+{
+    const GeometryKey key = geometryKey( ctx );
+    if ( geometryValid && key == geometry ) {
+        return;
+    }
+    geometry = key;
+    geometryValid = true;
+
+    syncValueCache();
+    QAbstractItemModel* model = diagram->model();
+    const QModelIndex rootIndex = diagram->rootIndex();
+
+    const int rowCount = model->rowCount( rootIndex );
+    const int colCount = model->columnCount( rootIndex );
+    const QPointF topLeft = ctx->rectangle().topLeft();
+
+    // Calculate the data points and their labels in one go, the labels are painted
+    // from labelPaintCache by every following paint
+    labelPaintCache.clear();
+    datasetPolygons.resize( colCount );
+    for ( int iCol = 0; iCol < colCount; ++iCol ) {
+        QPolygonF& polygon = datasetPolygons[ iCol ];
+        polygon.resize( rowCount );
+        for ( int iRow = 0; iRow < rowCount; ++iRow ) {
+            const qreal value = valueAt( iRow, iCol );
+            const QPointF point = plane->translate( QPointF( value, iRow ) ) + topLeft;
+            polygon[ iRow ] = point;
+            addLabel( &labelPaintCache, model->index( iRow, iCol, rootIndex ), nullptr,
+                      PositionPoints( point ), Position::Center, Position::Center, value );
+        }
+    }
+
+    // Check if all of the data value texts / data comments fit into the available space
+    // and zoom out if necessary
+    fittedZoomX = key.zoomX;
+    fittedZoomY = key.zoomY;
+    if ( labelPaintCache.paintReplay.count() ) {
+        QRectF txtRectF;
+        paintDataValueTextsAndMarkers( ctx, labelPaintCache, true, true, &txtRectF );
+        const QRect txtRect = txtRectF.toRect();
+        const QRect curRect = key.planeGeometry;
+        const qreal gapX = qMin( txtRect.left() - curRect.left(), curRect.right()  - txtRect.right() );
+        const qreal gapY = qMin( txtRect.top()  - curRect.top(),  curRect.bottom() - txtRect.bottom() );
+        if ( gapX < 0.0 ) {
+            fittedZoomX = key.zoomX * ( 1.0 + ( gapX - 1.0 ) / curRect.width() );
+        }
+        if ( gapY < 0.0 ) {
+            fittedZoomY = key.zoomY * ( 1.0 + ( gapY - 1.0 ) / curRect.height() );
+        }
+    }
+}
+
 #define d d_func()
 
 PolarDiagram::PolarDiagram( QWidget* parent, PolarCoordinatePlane* plane ) :
@@ -95,9 +210,10 @@ const QPair<QPointF, QPointF> PolarDiagram::calculateDataBoundaries () const
     qreal xMin = 0.0;
     qreal xMax = colCount;
     qreal yMin = 0, yMax = 0;
+    d->syncValueCache();
     for ( int iCol=0; iCol<colCount; ++iCol ) {
         for ( int iRow=0; iRow< rowCount; ++iRow ) {
-            qreal value = model()->data( model()->index( iRow, iCol, rootIndex() ) ).toReal(); // checked
+            const qreal value = d->valueAt( iRow, iCol );
             yMax = qMax( yMax, value );
             yMin = qMin( yMin, value );
         }
@@ -146,63 +262,22 @@ void PolarDiagram::paint( PaintContext* ctx,
         return;
     d->reverseMapper.clear();
 
-    const int rowCount = model()->rowCount( rootIndex() );
-    const int colCount = model()->columnCount( rootIndex() );
+    // The data points and their labels are only laid out again when the data or the
+    // plane changed, so usually both passes just use the results of an earlier paint.
+    d->updateGeometry( ctx );
 
     if ( calculateListAndReturnScale ) {
-        // Check if all of the data value texts / data comments fit into the available space...
-        d->labelPaintCache.clear();
-
-        for ( int iCol = 0; iCol < colCount; ++iCol ) {
-            for ( int iRow=0; iRow < rowCount; ++iRow ) {
-                QModelIndex index = model()->index( iRow, iCol, rootIndex() ); // checked
-                const qreal value = model()->data( index ).toReal();
-                QPointF point = coordinatePlane()->translate(
-                        QPointF( value, iRow ) ) + ctx->rectangle().topLeft();
-                //qDebug() << point;
-                d->addLabel( &d->labelPaintCache, index, nullptr, PositionPoints( point ),
-                             Position::Center, Position::Center, value );
-            }
-        }
-
-        newZoomX = coordinatePlane()->zoomFactorX();
-        newZoomY = coordinatePlane()->zoomFactorY();
-
-        if ( d->labelPaintCache.paintReplay.count() ) {
-            // ...and zoom out if necessary
-            const qreal oldZoomX = newZoomX;
-            const qreal oldZoomY = newZoomY;
-
-            QRectF txtRectF;
-            d->paintDataValueTextsAndMarkers( ctx, d->labelPaintCache, true, true, &txtRectF );
-            const QRect txtRect = txtRectF.toRect();
-            const QRect curRect = coordinatePlane()->geometry();
-            const qreal gapX = qMin( txtRect.left() - curRect.left(), curRect.right()  - txtRect.right() );
-            const qreal gapY = qMin( txtRect.top()  - curRect.top(),  curRect.bottom() - txtRect.bottom() );
-            if ( gapX < 0.0 ) {
-                newZoomX = oldZoomX * ( 1.0 + ( gapX - 1.0 ) / curRect.width() );
-            }
-            if ( gapY < 0.0 ) {
-                newZoomY = oldZoomY * ( 1.0 + ( gapY - 1.0 ) / curRect.height() );
-            }
-        }
+        newZoomX = d->fittedZoomX;
+        newZoomY = d->fittedZoomY;
     } else {
         // Paint the data sets
-        for ( int iCol = 0; iCol < colCount; ++iCol ) {
+        for ( int iCol = 0; iCol < d->datasetPolygons.count(); ++iCol ) {
             //TODO(khz): As of yet PolarDiagram can not show per-segment line attributes
             //           but it draws every polyline in one go - using one color.
             //           This needs to be enhanced to allow for cell-specific settings
             //           in the same way as LineDiagram does it.
             QBrush brush = d->datasetAttrs( iCol, KChart::DatasetBrushRole ).value<QBrush>();
-            QPolygonF polygon;
-            for ( int iRow = 0; iRow < rowCount; ++iRow ) {
-                QModelIndex index = model()->index( iRow, iCol, rootIndex() ); // checked
-                const qreal value = model()->data( index ).toReal();
-                QPointF point = coordinatePlane()->translate( QPointF( value, iRow ) )
-                                + ctx->rectangle().topLeft();
-                polygon.append( point );
-                //qDebug() << point;
-            }
+            QPolygonF polygon = d->datasetPolygons.at( iCol );
             if ( closeDatasets() && !polygon.isEmpty() ) {
                 // close the circle by connecting the last data point to the first
                 polygon.append( polygon.first() );
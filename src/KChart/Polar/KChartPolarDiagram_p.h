@@ -35,6 +35,10 @@
 #include "KChartAbstractPolarDiagram_p.h"
 
 #include "KChartMath_p.h"
+#include "KChartModelDataCache_p.h"
+
+#include <QPolygonF>
+#include <QVector>
 
 
 namespace KChart {
@@ -54,16 +58,56 @@ public:
         showDelimitersAtPosition( rhs.showDelimitersAtPosition ),
         showLabelsAtPosition( rhs.showLabelsAtPosition ),
         rotateCircularLabels( rhs.rotateCircularLabels ),
-        closeDatasets( rhs.closeDatasets )
+        closeDatasets( rhs.closeDatasets ),
+        geometryValid( false ),
+        fittedZoomX( 1.0 ),
+        fittedZoomY( 1.0 )
         {
         }
 
+    /**
+     * Everything the positions of the data points and of their labels depend on.
+     */
+    struct GeometryKey
+    {
+        GeometryKey();
+        bool operator==( const GeometryKey& other ) const;
+
+        uint revision;
+        QRectF rectangle;
+        QRect planeGeometry;
+        qreal zoomX;
+        qreal zoomY;
+        QPointF zoomCenter;
+        qreal startPosition;
+        qreal radiusUnit;
+        qreal angleUnit;
+    };
+
+    GeometryKey geometryKey( PaintContext* ctx ) const;
+    /**
+     * Lays out the data points and their labels and calculates the zoom needed to fit
+     * the labels into the plane, unless that was done already for the current geometry.
+     */
+    void updateGeometry( PaintContext* ctx );
+    void syncValueCache() const;
+    qreal valueAt( int row, int column ) const;
+
 private:
     QMap<int,bool> showDelimitersAtPosition;
     QMap<int,bool> showLabelsAtPosition;
     bool rotateCircularLabels;
     bool closeDatasets;
     LabelPaintCache labelPaintCache;
+
+    // the values as read from the model, and the geometry derived from them by the last
+    // updateGeometry(), reused by all paints until the data or the plane changes
+    mutable ModelDataCache< qreal, Qt::DisplayRole > valueCache;
+    QVector< QPolygonF > datasetPolygons;
+    bool geometryValid;
+    GeometryKey geometry;
+    qreal fittedZoomX;
+    qreal fittedZoomY;
 };
 
 KCHART_IMPL_DERIVED_DIAGRAM( PolarDiagram, AbstractPolarDiagram, PolarCoordinatePlane )
@@ -254,6 +254,23 @@ void RingDiagram::resize( const QSizeF& size)
     AbstractPieDiagram ::resize( size );
 }
 
+// the point of the ellipse of the given level in direction, moved outwards in centerDirection
+// by the explode factor, see RingDiagram::pointOnEllipse()
+static QPointF ringPoint( const QRectF& rect, int levelCount, qreal level, const QPointF& direction,
+                          const QPointF& centerDirection, qreal totalGapFactor, qreal totalExplodeFactor )
+{
+    const qreal offsetX = levelCount > 0 ? level * rect.width() / ( ( levelCount + 1 ) * 2 ) : 0.0;
+    const qreal offsetY = levelCount > 0 ? level * rect.height() / ( ( levelCount + 1 ) * 2 ) : 0.0;
+    const qreal centerOffsetX = levelCount > 0 ? totalExplodeFactor * rect.width() / ( ( levelCount + 1 ) * 2 ) : 0.0;
+    const qreal centerOffsetY = levelCount > 0 ? totalExplodeFactor * rect.height() / ( ( levelCount + 1 ) * 2 ) : 0.0;
+    const qreal gapOffsetX = levelCount > 0 ? totalGapFactor * rect.width() / ( ( levelCount + 1 ) * 2 ) : 0.0;
+    const qreal gapOffsetY = levelCount > 0 ? totalGapFactor * rect.height() / ( ( levelCount + 1 ) * 2 ) : 0.0;
+
+    // the y axis points down
+    return QPointF( ( offsetX + gapOffsetX ) * direction.x() + centerOffsetX * centerDirection.x() + rect.center().x(),
+                    ( offsetY + gapOffsetY ) * -direction.y() + centerOffsetY * -centerDirection.y() + rect.center().y() );
+}
+
 void RingDiagram::drawPieSurface( QPainter* painter, uint dataset, uint slice, qreal granularity )
 {
     // Is there anything to draw at all?
@@ -332,16 +349,29 @@ void RingDiagram::drawPieSurface( QPainter* painter, uint dataset, uint slice, q
             totalRadialGap = maxRadialGap + attrs.gapFactor( false );
             totalRadialExplode = attrs.explode() ? maxRadialExplode + attrs.explodeFactor() : maxRadialExplode;
 
+            // walk along the arcs by rotating the directions, instead of evaluating cos() and
+            // sin() for every point
+            const AngleTable& arcSteps = d->arcSteps( granularity );
+            const QPointF centerDirection = AngleTable::direction( startAngle + angleLen / 2.0 );
+            const int levelCount = rCount * 2;
+            const qreal innerLevel = ( levelCount - int( dataset ) - 1 ) + 1;
+            const qreal outerLevel = ( levelCount - int( dataset ) - 1 ) + 2;
+
+            const QPointF startDirection = AngleTable::direction( actualStartAngle );
+            int iStep = 0;
             while ( degree <= actualAngleLen ) {
-            const QPointF p = pointOnEllipse( drawPosition, dataset, slice, false, actualStartAngle + degree,
-                                              totalRadialGap, totalRadialExplode );
+                const QPointF p = ringPoint( drawPosition, levelCount, innerLevel,
+                                             arcSteps.rotated( startDirection, iStep ), centerDirection,
+                                             totalRadialGap, totalRadialExplode );
                 poly.append( p );
                 degree += granularity;
                 iPoint++;
+                iStep++;
             }
             if ( ! perfectMatch ) {
-                poly.append( pointOnEllipse( drawPosition, dataset, slice, false, actualStartAngle + actualAngleLen,
-                                             totalRadialGap, totalRadialExplode ) );
+                poly.append( ringPoint( drawPosition, levelCount, innerLevel,
+                                        AngleTable::direction( actualStartAngle + actualAngleLen ), centerDirection,
+                                        totalRadialGap, totalRadialExplode ) );
                 iPoint++;
             }
 
@@ -354,17 +384,22 @@ void RingDiagram::drawPieSurface( QPainter* painter, uint dataset, uint slice, q
             degree = actualAngleLen;
 
             const int lastInnerBrinkPoint = iPoint;
+            const QPointF endDirection = AngleTable::direction( actualStartAngle + actualAngleLen );
+            iStep = 0;
             while ( degree >= 0 ) {
-                poly.append( pointOnEllipse( drawPosition, dataset, slice, true, actualStartAngle + degree,
-                                             totalRadialGap, totalRadialExplode ) );
+                poly.append( ringPoint( drawPosition, levelCount, outerLevel,
+                                        arcSteps.rotated( endDirection, -iStep ), centerDirection,
+                                        totalRadialGap, totalRadialExplode ) );
                 perfectMatch = (degree == 0);
                 degree -= granularity;
                 iPoint++;
+                iStep++;
             }
             // if necessary add one more point to fill the last small gap
             if ( ! perfectMatch ) {
-                poly.append( pointOnEllipse( drawPosition, dataset, slice, true, actualStartAngle,
-                                             totalRadialGap, totalRadialExplode ) );
+                poly.append( ringPoint( drawPosition, levelCount, outerLevel,
+                                        AngleTable::direction( actualStartAngle ), centerDirection,
+                                        totalRadialGap, totalRadialExplode ) );
                 iPoint++;
             }
 
@@ -410,21 +445,9 @@ QPointF RingDiagram::pointOnEllipse( const QRectF& rect, int dataset, int slice,
 
     qreal level = outer ? ( rCount - dataset - 1 ) + 2 : ( rCount - dataset - 1 ) + 1;
 
-    const qreal offsetX = rCount > 0 ? level * rect.width() / ( ( rCount + 1 ) * 2 ) : 0.0;
-    const qreal offsetY = rCount > 0 ? level * rect.height() / ( ( rCount + 1 ) * 2 ) : 0.0;
-    const qreal centerOffsetX = rCount > 0 ? totalExplodeFactor * rect.width() / ( ( rCount + 1 ) * 2 ) : 0.0;
-    const qreal centerOffsetY = rCount > 0 ? totalExplodeFactor * rect.height() / ( ( rCount + 1 ) * 2 ) : 0.0;
-    const qreal gapOffsetX = rCount > 0 ? totalGapFactor * rect.width() / ( ( rCount + 1 ) * 2 ) : 0.0;
-    const qreal gapOffsetY = rCount > 0 ? totalGapFactor * rect.height() / ( ( rCount + 1 ) * 2 ) : 0.0;
-
-    qreal explodeAngleRad = DEGTORAD( angle );
-    qreal cosAngle = cos( explodeAngleRad );
-    qreal sinAngle = -sin( explodeAngleRad );
-    qreal explodeAngleCenterRad = DEGTORAD( startAngle + angleLen / 2.0 );
-    qreal cosAngleCenter = cos( explodeAngleCenterRad );
-    qreal sinAngleCenter = -sin( explodeAngleCenterRad );
-    return QPointF( ( offsetX + gapOffsetX ) * cosAngle + centerOffsetX * cosAngleCenter + rect.center().x(),
-                    ( offsetY + gapOffsetY ) * sinAngle + centerOffsetY * sinAngleCenter + rect.center().y() );
+    return ringPoint( rect, rCount, level, AngleTable::direction( angle ),
+                      AngleTable::direction( startAngle + angleLen / 2.0 ),
+                      totalGapFactor, totalExplodeFactor );
 }
 
 /*virtual*/
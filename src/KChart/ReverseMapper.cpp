@@ -20,6 +20,7 @@
 #include "ReverseMapper.h"
 
 #include <math.h>
+#include <limits>
 
 #include <QRect>
 #include <QtDebug>
@@ -35,12 +36,20 @@ using namespace KChart;
 ReverseMapper::ReverseMapper()
     : m_scene( nullptr )
     , m_diagram( nullptr )
+    , m_recording( false )
+    , m_recordedClear( false )
+    , m_firstRow( 0 )
+    , m_lastRow( std::numeric_limits< int >::max() )
 {
 }
 
 ReverseMapper::ReverseMapper( AbstractDiagram* diagram )
     : m_scene( nullptr )
     , m_diagram( diagram )
+    , m_recording( false )
+    , m_recordedClear( false )
+    , m_firstRow( 0 )
+    , m_lastRow( std::numeric_limits< int >::max() )
 {
 }
 
@@ -57,11 +66,43 @@ void ReverseMapper::setDiagram( AbstractDiagram* diagram )
 
 void ReverseMapper::clear()
 {
+    m_firstRow = 0;
+    m_lastRow = std::numeric_limits< int >::max();
+    if ( m_recording ) {
+        m_recordedItems.clear();
+        m_recordedClearedRows.clear();
+        m_recordedClear = true;
+        return;
+    }
     m_itemMap.clear();
     delete m_scene;
     m_scene = new QGraphicsScene();
 }
 
+void ReverseMapper::clearRows( int firstRow, int lastRow )
+{
+    m_firstRow = firstRow;
+    m_lastRow = lastRow;
+    if ( m_recording ) {
+        m_recordedClearedRows.append( qMakePair( firstRow, lastRow ) );
+        return;
+    }
+    if ( !m_scene ) {
+        m_scene = new QGraphicsScene();
+        return;
+    }
+    Q_FOREACH( QGraphicsItem* item, m_scene->items() ) {
+        ChartGraphicsItem* i = qgraphicsitem_cast<ChartGraphicsItem*>( item );
+        if ( i && i->row() >= firstRow && i->row() <= lastRow ) {
+            const QModelIndex index = m_diagram->model()->index( i->row(), i->column(), m_diagram->rootIndex() ); // checked
+            if ( m_itemMap.value( index ) == i ) {
+                m_itemMap.remove( index );
+            }
+            delete i;
+        }
+    }
+}
+
 QModelIndexList ReverseMapper::indexesIn( const QRect& rect ) const
 {
     Q_ASSERT( m_diagram );
@@ -117,8 +158,47 @@ QRectF ReverseMapper::boundingRect( int row, int column ) const
     return m_itemMap.contains( index ) ? m_itemMap[ index ]->polygon().boundingRect() : QRectF();
 }
 
+void ReverseMapper::startRecording()
+{
+    m_recording = true;
+    m_recordedClear = false;
+    m_recordedItems.clear();
+    m_recordedClearedRows.clear();
+}
+
+void ReverseMapper::replayRecording()
+{
+    m_recording = false;
+    const int firstRow = m_firstRow;
+    const int lastRow = m_lastRow;
+    if ( m_recordedClear ) {
+        clear();
+    }
+    for ( const QPair< int, int >& rows : qAsConst( m_recordedClearedRows ) ) {
+        clearRows( rows.first, rows.second );
+    }
+    m_firstRow = firstRow;
+    m_lastRow = lastRow;
+    for ( const RecordedItem& recorded : qAsConst( m_recordedItems ) ) {
+        addPolygon( recorded.row, recorded.column, recorded.polygon );
+    }
+    m_recordedClear = false;
+    m_recordedItems.clear();
+    m_recordedClearedRows.clear();
+}
+
 void ReverseMapper::addItem( ChartGraphicsItem* item )
 {
+    if ( item->row() < m_firstRow || item->row() > m_lastRow ) {
+        delete item;
+        return;
+    }
+    if ( m_recording ) {
+        const RecordedItem recorded = { item->row(), item->column(), item->polygon() };
+        m_recordedItems.append( recorded );
+        delete item;
+        return;
+    }
     Q_ASSERT( m_scene );
     m_scene->addItem( item );
     m_itemMap.insert( m_diagram->model()->index( item->row(), item->column(), m_diagram->rootIndex() ), item ); // checked
@@ -131,6 +211,14 @@ void ReverseMapper::addRect( int row, int column, const QRectF& rect )
 
 void ReverseMapper::addPolygon( int row, int column, const QPolygonF& polygon )
 {
+    if ( row < m_firstRow || row > m_lastRow ) {
+        return;
+    }
+    if ( m_recording ) {
+        const RecordedItem recorded = { row, column, polygon };
+        m_recordedItems.append( recorded );
+        return;
+    }
     ChartGraphicsItem* item = new ChartGraphicsItem( row, column );
     item->setPolygon( polygon );
     addItem( item );
@@ -22,11 +22,13 @@
 
 #include <QModelIndex>
 #include <QHash>
+#include <QPair>
+#include <QPolygonF>
+#include <QVector>
 
 QT_BEGIN_NAMESPACE
 class QRectF;
 class QGraphicsScene;
-class QPolygonF;
 QT_END_NAMESPACE
 
 namespace KChart {
@@ -50,6 +52,9 @@ namespace KChart {
         void setDiagram( AbstractDiagram* diagram );
 
         void clear();
+        // Removes the items of the rows \a firstRow to \a lastRow, and ignores items added for
+        // other rows until the next clear(). For repainting a part of the diagram.
+        void clearRows( int firstRow, int lastRow );
 
         QModelIndexList indexesAt( const QPointF& point ) const;
         QModelIndexList indexesIn( const QRect& rect ) const;
@@ -65,10 +70,29 @@ namespace KChart {
         void addCircle( int row, int column, const QPointF& location, const QSizeF& diameter );
         void addLine( int row, int column, const QPointF& from, const QPointF& to );
 
+        // While recording, clear() and the add methods only take notes, so that a diagram can
+        // be painted outside of the GUI thread. replayRecording() applies the notes and ends
+        // the recording, it must be called in the GUI thread.
+        void startRecording();
+        void replayRecording();
+
     private:
+        struct RecordedItem {
+            int row;
+            int column;
+            QPolygonF polygon;
+        };
+
         QGraphicsScene* m_scene;
         AbstractDiagram* m_diagram;
         QHash<QModelIndex, ChartGraphicsItem*> m_itemMap;
+        bool m_recording;
+        bool m_recordedClear;
+        QVector< RecordedItem > m_recordedItems;
+        QVector< QPair< int, int > > m_recordedClearedRows;
+        // the rows items are added for, see clearRows()
+        int m_firstRow;
+        int m_lastRow;
     };
 
 }
@@ -21,12 +21,206 @@
 #include "KChartAbstractTernaryDiagram_p.h"
 
 #include "KChartTernaryCoordinatePlane.h"
+#include "KChartPaintContext.h"
+#include "KChartPrintingParameters.h"
+#include "TernaryPoint.h"
+
+#include <limits>
+
+#include <QLineF>
+#include <QPainter>
+#include <QtDebug>
 
 using namespace KChart;
 
 AbstractTernaryDiagram::Private::Private()
-    : AbstractDiagram::Private()
+    : AbstractDiagram::Private(),
+      referenceDiagram( nullptr ),
+      dataPointsValid( false ),
+      dataPointsRevision( 0 ),
+      locationsValid( false )
+{
+}
+
+void AbstractTernaryDiagram::Private::updateDataPoints()
+{
+    if ( dataPointsValid && dataPointsRevision == revision ) {
+        return;
+    }
+    dataPointsValid = true;
+    dataPointsRevision = revision;
+    locationsValid = false;
+    dataPoints.clear();
+    pointRuns.clear();
+
+    QAbstractItemModel* model = diagram->model();
+    if ( !model ) {
+        return;
+    }
+    const QModelIndex rootIndex = diagram->rootIndex();
+    if ( valueCache.model() != model ) {
+        valueCache.setModel( model );
+    }
+    if ( valueCache.rootIndex() != rootIndex ) {
+        valueCache.setRootIndex( rootIndex );
+    }
+
+    const int columnCount = model->columnCount( rootIndex );
+    const int rowCount = model->rowCount( rootIndex );
+    // like QVariant::toReal() on missing data, which was used before, take missing values as 0
+    const auto valueAt = [&]( int row, int column ) -> qreal {
+        if ( column >= columnCount ) {
+            return 0.0;
+        }
+        const qreal value = valueCache.data( row, column );
+        return ISNAN( value ) ? 0.0 : qMax< qreal >( value, 0.0 );
+    };
+
+    dataPoints.reserve( rowCount * ( ( columnCount + datasetDimension - 1 ) / datasetDimension ) );
+    for ( int column = 0; column < columnCount; column += datasetDimension ) {
+        for ( int row = 0; row < rowCount; ++row ) {
+            // see if there is data otherwise skip
+            if ( ISNAN( valueCache.data( row, column ) ) ) {
+                continue;
+            }
+            TernaryDataPoint point;
+            point.row = row;
+            point.x = valueAt( row, column );
+            point.y = valueAt( row, column + 1 );
+            point.z = valueAt( row, column + 2 );
+
+            // fix messed up data values (paint as much as possible)
+            const qreal total = point.x + point.y + point.z;
+            if ( fabs( total ) <= 3 * std::numeric_limits< qreal >::epsilon() ) {
+                // ignore and do not paint this point, garbage data
+                qDebug() << "AbstractTernaryDiagram: data point x/y/z:"
+                         << point.x << "/" << point.y << "/" << point.z << "ignored, unusable.";
+                continue;
+            }
+            point.location = ::translate( TernaryPoint( point.x / total, point.y / total ) );
+
+            const QModelIndex index = model->index( row, column, rootIndex ); // checked
+            const QPen pen = diagram->pen( index );
+            const QBrush brush = diagram->brush( index );
+            const DataValueAttributes attributes = diagram->dataValueAttributes( index );
+            if ( pointRuns.isEmpty() || pointRuns.last().column != column || pointRuns.last().pen != pen
+                 || pointRuns.last().brush != brush || pointRuns.last().attributes != attributes ) {
+                TernaryPointRun run;
+                run.column = column;
+                run.first = dataPoints.count();
+                run.count = 0;
+                run.pen = pen;
+                run.brush = brush;
+                run.attributes = attributes;
+                pointRuns.append( run );
+            }
+            ++pointRuns.last().count;
+            dataPoints.append( point );
+        }
+    }
+}
+
+void AbstractTernaryDiagram::Private::updateLocations( const TernaryCoordinatePlane* plane )
+{
+    // the translation of the plane is linear, two points tell whether it changed
+    const QPointF origin = plane->translate( QPointF( 0.0, 0.0 ) );
+    const QPointF unit = plane->translate( QPointF( 1.0, 1.0 ) ) - origin;
+    if ( locationsValid && origin == locationsOrigin && unit == locationsUnit ) {
+        return;
+    }
+    locationsValid = true;
+    locationsOrigin = origin;
+    locationsUnit = unit;
+
+    locations.resize( dataPoints.count() );
+    for ( int i = 0; i < dataPoints.count(); ++i ) {
+        locations[ i ] = plane->translate( dataPoints.at( i ).location );
+    }
+}
+
+void AbstractTernaryDiagram::Private::paintDataPoints( PaintContext* paintContext, bool paintLines )
 {
+    const TernaryCoordinatePlane* plane =
+        static_cast< const TernaryCoordinatePlane* >( paintContext->coordinatePlane() );
+    Q_ASSERT( plane );
+    updateDataPoints();
+    updateLocations( plane );
+
+    QPainter* painter = paintContext->painter();
+    int datasetBegin = 0;
+    while ( datasetBegin < pointRuns.count() ) {
+        int datasetEnd = datasetBegin + 1;
+        while ( datasetEnd < pointRuns.count()
+                && pointRuns.at( datasetEnd ).column == pointRuns.at( datasetBegin ).column ) {
+            ++datasetEnd;
+        }
+
+        if ( paintLines ) {
+            for ( int i = datasetBegin; i < datasetEnd; ++i ) {
+                const TernaryPointRun& run = pointRuns.at( i );
+                painter->setPen( PrintingParameters::scalePen( run.pen ) );
+                painter->setBrush( run.brush );
+                // a line is painted with the pen of the data point it leads to, so each run
+                // but the first starts at the last point of the run before
+                const int first = i == datasetBegin ? run.first : run.first - 1;
+                const int count = run.first + run.count - first;
+                if ( count > 1 ) {
+                    painter->drawPolyline( locations.constData() + first, count );
+                }
+            }
+        }
+        for ( int i = datasetBegin; i < datasetEnd; ++i ) {
+            paintMarkers( painter, pointRuns.at( i ) );
+        }
+        datasetBegin = datasetEnd;
+    }
+}
+
+void AbstractTernaryDiagram::Private::paintMarkers( QPainter* painter, const TernaryPointRun& run )
+{
+    // what AbstractDiagram::paintMarker() does, with the attributes looked up once per run
+    if ( !run.attributes.isVisible() ) {
+        return;
+    }
+    const MarkerAttributes ma = run.attributes.markerAttributes();
+    if ( !ma.isVisible() ) {
+        return;
+    }
+
+    const PainterSaver painterSaver( painter );
+    const QSizeF maSize = markerSize( ma, painter );
+    QBrush brush( run.brush );
+    if ( ma.markerColor().isValid() ) {
+        brush.setColor( ma.markerColor() );
+    }
+
+    const QPointF* points = locations.constData() + run.first;
+    const bool isFourPixels = ma.markerStyle() == MarkerAttributes::Marker4Pixels;
+    if ( isFourPixels || ma.markerStyle() == MarkerAttributes::Marker1Pixel ) {
+        // the tiny markers of charts with many points, painted with one call for the run
+        painter->setPen( PrintingParameters::scalePen( QPen( brush.color().lighter() ) ) );
+        if ( isFourPixels ) {
+            QVector< QLineF > lines;
+            lines.reserve( 3 * run.count );
+            for ( int i = 0; i < run.count; ++i ) {
+                const qreal x = points[ i ].x();
+                const qreal y = points[ i ].y();
+                lines << QLineF( x - 1.0, y - 1.0, x + 1.0, y - 1.0 )
+                      << QLineF( x - 1.0, y, x + 1.0, y )
+                      << QLineF( x - 1.0, y + 1.0, x + 1.0, y + 1.0 );
+            }
+            painter->drawLines( lines );
+        }
+        painter->drawPoints( points, run.count );
+    } else {
+        for ( int i = 0; i < run.count; ++i ) {
+            diagram->paintMarker( painter, ma, brush, ma.pen(), points[ i ], maSize );
+        }
+    }
+
+    for ( int i = 0; i < run.count; ++i ) {
+        reverseMapper.addCircle( dataPoints.at( run.first + i ).row, run.column, points[ i ], 2 * maSize );
+    }
 }
 
 void AbstractTernaryDiagram::init()
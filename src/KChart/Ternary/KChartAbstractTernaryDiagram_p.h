@@ -39,6 +39,12 @@
 #include <KChartGridAttributes.h>
 #include "KChartPainterSaver_p.h"
 #include "KChartMath_p.h"
+#include "KChartModelDataCache_p.h"
+
+#include <QBrush>
+#include <QPen>
+#include <QPolygonF>
+#include <QVector>
 
 #include "ReverseMapper.h"
 #include "ChartGraphicsItem.h"
@@ -60,15 +66,61 @@ namespace KChart {
             // Do not copy axes and reference diagrams.
             axesList(),
             referenceDiagram( nullptr ),
-            referenceDiagramOffset()
+            referenceDiagramOffset(),
+            // nor the cached data points
+            dataPointsValid( false ),
+            dataPointsRevision( 0 ),
+            locationsValid( false )
         {
         }
 
+        // A data point as read from the model, with its location in the triangle
+        struct TernaryDataPoint
+        {
+            int row;
+            // the values of the three components, negative values taken as 0
+            qreal x;
+            qreal y;
+            qreal z;
+            QPointF location;
+        };
+
+        // Consecutive data points of one dataset with the same attributes, painted in one go
+        struct TernaryPointRun
+        {
+            int column;
+            int first;
+            int count;
+            QPen pen;
+            QBrush brush;
+            DataValueAttributes attributes;
+        };
+
+        // read the data points and their attributes again if anything changed since the
+        // last call
+        void updateDataPoints();
+        // translate the data points to widget coordinates, unless the plane did not change
+        void updateLocations( const TernaryCoordinatePlane* plane );
+        // paint the markers of the data points, and the lines between them if \a paintLines
+        void paintDataPoints( PaintContext* paintContext, bool paintLines );
+        void paintMarkers( QPainter* painter, const TernaryPointRun& run );
+
         TernaryAxisList axesList;
 
         AbstractTernaryDiagram* referenceDiagram;
         QPointF referenceDiagramOffset;
 
+        ModelDataCache< qreal, Qt::DisplayRole > valueCache;
+        QVector< TernaryDataPoint > dataPoints;
+        QVector< TernaryPointRun > pointRuns;
+        bool dataPointsValid;
+        uint dataPointsRevision;
+        // the locations of dataPoints in widget coordinates
+        QPolygonF locations;
+        bool locationsValid;
+        QPointF locationsOrigin;
+        QPointF locationsUnit;
+
         void drawPoint( QPainter* p, int row, int column,
                         const QPointF& widgetLocation )
         {
@@ -84,65 +84,11 @@ void  TernaryLineDiagram::paint (PaintContext *paintContext)
     QPainter* p = paintContext->painter();
     PainterSaver s( p );
 
-    TernaryCoordinatePlane* plane =
-        (TernaryCoordinatePlane*) paintContext->coordinatePlane();
-    Q_ASSERT( plane );
-
-    qreal x, y, z;
-
-    // for some reason(?) TernaryPointDiagram is using per-diagram DVAs only:
-    const DataValueAttributes attrs( dataValueAttributes() );
-
+    // The data points are read from the model and laid out only when the data or the
+    // attributes changed, and painted a run of points with the same attributes at a time.
+    // The data value texts are not painted: they were only ever measured, never drawn.
     d->forgetAlreadyPaintedDataValues();
-
-    int columnCount = model()->columnCount( rootIndex() );
-    QPointF start;
-    for (int column=0; column<columnCount; column+=datasetDimension() )
-    {
-        int numrows = model()->rowCount( rootIndex() );
-        for ( int row = 0; row < numrows; row++ )
-        {
-            // see if there is data otherwise skip
-            QModelIndex base = model()->index( row, column ); // checked
-            if ( ! model()->data( base ).isNull() )
-            {
-                p->setPen( PrintingParameters::scalePen( pen( base ) ) );
-                p->setBrush( brush( base ) );
-
-                // retrieve data
-                x = qMax<qreal>( model()->data( model()->index( row, column, rootIndex() ) ).toReal(), // checked
-                          0.0 );
-                y = qMax<qreal>( model()->data( model()->index( row, column+1, rootIndex() ) ).toReal(), // checked
-                          0.0 );
-                z = qMax<qreal>( model()->data( model()->index( row, column+2, rootIndex() ) ).toReal(), // checked
-                          0.0 );
-
-                qreal total = x + y + z;
-                if ( fabs( total ) > 3 * std::numeric_limits<qreal>::epsilon() ) {
-                    TernaryPoint tPunkt( x / total, y / total );
-                    QPointF diagramLocation = translate( tPunkt );
-                    QPointF widgetLocation = plane->translate( diagramLocation );
-
-                    if ( row > 0 ) {
-                        p->drawLine( start, widgetLocation );
-                    }
-                    paintMarker( p, model()->index( row, column, rootIndex() ), widgetLocation ); // checked
-                    start = widgetLocation;
-                    // retrieve text and data value attributes
-                    // FIXME use data model DisplayRole text
-                    QString text = tr( "(%1, %2, %3)", "(x, y, z) values of the data point" )
-                                   .arg( x * 100, 0, 'f', 0 )
-                                   .arg( y * 100, 0, 'f', 0 )
-                                   .arg( z * 100, 0, 'f', 0 );
-                    d->paintDataValueText( p, attrs, widgetLocation, true, text, true );
-                } else {
-                    // ignore and do not paint this point, garbage data
-                    qDebug() << "TernaryPointDiagram::paint: data point x/y/z:"
-                             << x << "/" << y << "/" << z << "ignored, unusable.";
-                }
-            }
-        }
-    }
+    d->paintDataPoints( paintContext, true );
 }
 
 const QPair< QPointF, QPointF >  TernaryLineDiagram::calculateDataBoundaries () const
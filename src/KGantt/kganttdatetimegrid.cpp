@@ -28,6 +28,7 @@
 #include <QPainterPath>
 #include <QStyle>
 #include <QStyleOptionHeader>
+#include <QTimeZone>
 #include <QWidget>
 #include <QString>
 #include <QDebug>
@@ -35,6 +36,7 @@
 #include <QPainterPath>
 
 #include <cassert>
+#include <limits>
 
 using namespace KGantt;
 
@@ -77,6 +79,65 @@ QDateTime DateTimeGrid::Private::chartXtoDateTime( qreal x ) const
     return result;
 }
 
+void DateTimeGrid::Private::updateEpochMapping()
+{
+    // dateTimeToChartX() works on wall clock times, so compare wall clock times here too
+    startEpochMSecs = startDateTime.isValid()
+                      ? startDateTime.toMSecsSinceEpoch() + startDateTime.offsetFromUtc()*1000LL
+                      : 0;
+    chartXPerMSec = dayWidth/( 24.*60.*60.*1000. );
+    if ( !startDateTime.isValid()
+         || startDateTime.timeSpec() == Qt::UTC
+         || startDateTime.timeSpec() == Qt::OffsetFromUTC ) {
+        offsetIntervalStart = std::numeric_limits<qint64>::min();
+        offsetIntervalEnd = std::numeric_limits<qint64>::max();
+        intervalOffsetMSecs = startDateTime.isValid() ? startDateTime.offsetFromUtc()*1000LL : 0;
+    } else {
+        // empty, looked up on first use
+        offsetIntervalStart = offsetIntervalEnd = 0;
+    }
+}
+
+/*
+ * Looks up the UTC offset at \a msecs in the time spec of startDateTime and
+ * the interval around it between the neighbouring daylight saving time
+ * transitions, in which the offset stays the same.
+ */
+void DateTimeGrid::Private::updateOffsetInterval( qint64 msecs ) const
+{
+    const bool local = startDateTime.timeSpec() != Qt::TimeZone;
+    const QTimeZone zone = local ? QTimeZone::systemTimeZone() : startDateTime.timeZone();
+    const QDateTime dt = local ? QDateTime::fromMSecsSinceEpoch( msecs, Qt::LocalTime )
+                               : QDateTime::fromMSecsSinceEpoch( msecs, zone );
+    intervalOffsetMSecs = dt.offsetFromUtc()*1000LL;
+    // without usable transition data, only msecs itself is known to have this offset
+    offsetIntervalStart = msecs;
+    offsetIntervalEnd = msecs + 1;
+    if ( !zone.isValid() || zone.offsetFromUtc( dt )*1000LL != intervalOffsetMSecs ) {
+        return;
+    }
+    if ( !zone.hasTransitions() ) {
+        offsetIntervalStart = std::numeric_limits<qint64>::min();
+        offsetIntervalEnd = std::numeric_limits<qint64>::max();
+        return;
+    }
+    // previousTransition() only finds transitions strictly before the given time
+    const QTimeZone::OffsetData previous = zone.previousTransition( dt.addMSecs( 1 ) );
+    const QTimeZone::OffsetData next = zone.nextTransition( dt );
+    offsetIntervalStart = previous.atUtc.isValid() ? previous.atUtc.toMSecsSinceEpoch()
+                                                   : std::numeric_limits<qint64>::min();
+    offsetIntervalEnd = next.atUtc.isValid() ? next.atUtc.toMSecsSinceEpoch()
+                                             : std::numeric_limits<qint64>::max();
+}
+
+qreal DateTimeGrid::Private::epochMSecsToChartX( qint64 msecs ) const
+{
+    if ( msecs < offsetIntervalStart || msecs >= offsetIntervalEnd ) {
+        updateOffsetInterval( msecs );
+    }
+    return ( msecs + intervalOffsetMSecs - startEpochMSecs ) * chartXPerMSec;
+}
+
 #define d d_func()
 
 
@@ -266,6 +327,7 @@ QDateTime DateTimeGrid::startDateTime() const
 void DateTimeGrid::setStartDateTime( const QDateTime& dt )
 {
     d->startDateTime = dt;
+    d->updateEpochMapping();
     emit gridChanged();
 }
 
@@ -288,10 +350,17 @@ QDateTime DateTimeGrid::mapToDateTime( qreal x ) const
 }
 
 
+qreal DateTimeGrid::mapFromEpochMSecs( qint64 msecs ) const
+{
+    return d->epochMSecsToChartX( msecs );
+}
+
+
 void DateTimeGrid::setDayWidth( qreal w )
 {
     assert( w>0 );
     d->dayWidth = w;
+    d->updateEpochMapping();
     emit gridChanged();
 }
 
@@ -421,6 +490,30 @@ Span DateTimeGrid::mapToChart( const QModelIndex& idx ) const
     assert( model() );
     if ( !idx.isValid() ) return Span();
     assert( idx.model()==model() );
+
+    // Fast path for models serving plain epoch times, no QDateTime involved. Whether the
+    // model serves them is found out once, so that other models do not pay for asking.
+    if ( d->epochRolesModel != model() ) {
+        d->epochRolesModel = model();
+        d->epochRoles = Private::EpochRolesUnknown;
+    }
+    if ( d->epochRoles != Private::EpochRolesNotServed ) {
+        bool ok = false;
+        const qint64 startMSecs = model()->data( idx, StartTimeEpochRole ).toLongLong( &ok );
+        if ( ok ) {
+            d->epochRoles = Private::EpochRolesServed;
+            const qreal sx = d->epochMSecsToChartX( startMSecs );
+            const QVariant eev = model()->data( idx, EndTimeEpochRole );
+            const qint64 endMSecs = eev.toLongLong( &ok );
+            return Span( sx, ( eev.isValid() && ok ) ? d->epochMSecsToChartX( endMSecs )-sx : 0 );
+        }
+        // the times of summaries are calculated by SummaryHandlingProxyModel, without epoch roles
+        if ( d->epochRoles == Private::EpochRolesUnknown
+             && model()->data( idx, ItemTypeRole ).toInt() != TypeSummary ) {
+            d->epochRoles = Private::EpochRolesNotServed;
+        }
+    }
+
     const QVariant sv = model()->data( idx, StartTimeRole );
     const QVariant ev = model()->data( idx, EndTimeRole );
     if ( sv.canConvert( QVariant::DateTime ) &&
@@ -1188,6 +1281,7 @@ void DateTimeGrid::Private::drawTimeLine(QPainter* painter, const QRectF& rect)
 #ifndef KDAB_NO_UNIT_TESTS
 
 #include <QStandardItemModel>
+#include <QTimeZone>
 #include "unittest/test.h"
 
 static std::ostream& operator<<( std::ostream& os, const QDateTime& dt )
@@ -1266,6 +1360,49 @@ KDAB_SCOPED_UNITTEST_SIMPLE( KGantt, DateTimeGrid, "test" ) {
 
         assertEqual( dt, result2 );
     }
+
+    {
+        // the epoch fast path has to agree with the QDateTime mapping, also for start times
+        // with daylight saving time and items on both sides of a transition
+        QStandardItemModel epochModel( 1, 1 );
+        grid.setModel( &epochModel );
+        const QModelIndex idx = epochModel.index( 0, 0 );
+        QList<QDateTime> starts;
+        starts << QDateTime( QDate( 2020, 3, 1 ), QTime( 0, 0 ), Qt::UTC )
+               << QDateTime( QDate( 2020, 3, 27 ), QTime( 12, 0 ), Qt::LocalTime );
+        const QTimeZone zone( "Europe/Berlin" );
+        if ( zone.isValid() ) {
+            starts << QDateTime( QDate( 2020, 3, 27 ), QTime( 12, 0 ), zone );
+        }
+        Q_FOREACH( const QDateTime& gridStart, starts ) {
+            grid.setStartDateTime( gridStart.addDays( -2 ) );
+            // the clocks go forward in the night to 2020-03-29 in much of Europe
+            const QDateTime itemStart = gridStart.addDays( 1 ).addSecs( -3 * 3600 );
+            const QDateTime itemEnd = gridStart.addDays( 3 ).addSecs( 3600 );
+            epochModel.setData( idx, QVariant(), StartTimeEpochRole );
+            epochModel.setData( idx, QVariant(), EndTimeEpochRole );
+            epochModel.setData( idx, itemStart, StartTimeRole );
+            epochModel.setData( idx, itemEnd, EndTimeRole );
+            const Span dateTimeSpan = grid.mapToChart( idx );
+            epochModel.setData( idx, itemStart.toMSecsSinceEpoch(), StartTimeEpochRole );
+            epochModel.setData( idx, itemEnd.toMSecsSinceEpoch(), EndTimeEpochRole );
+            const Span epochSpan = grid.mapToChart( idx );
+            assertTrue( qAbs( epochSpan.start() - dateTimeSpan.start() ) < 1e-6 );
+            assertTrue( qAbs( epochSpan.length() - dateTimeSpan.length() ) < 1e-6 );
+            assertTrue( qAbs( grid.mapFromEpochMSecs( itemEnd.toMSecsSinceEpoch() ) - grid.mapFromDateTime( itemEnd ) ) < 1e-6 );
+
+            // the cached UTC offset has to follow when going back and forth across transitions
+            const qint64 yearStart = gridStart.addMonths( -6 ).toMSecsSinceEpoch();
+            const qint64 step = 7 * 3600 * 1000LL + 1;
+            for ( int i = 0; i < 2 * 366 * 24 / 7; ++i ) {
+                const qint64 msecs = yearStart + ( i % 2 ? i : 2 * 366 * 24 / 7 - i ) * step;
+                const QDateTime dt = gridStart.timeSpec() == Qt::TimeZone
+                                     ? QDateTime::fromMSecsSinceEpoch( msecs, gridStart.timeZone() )
+                                     : QDateTime::fromMSecsSinceEpoch( msecs, gridStart.timeSpec() );
+                assertTrue( qAbs( grid.mapFromEpochMSecs( msecs ) - grid.mapFromDateTime( dt ) ) < 1e-6 );
+            }
+        }
+    }
 }
 
 #endif /* KDAB_NO_UNIT_TESTS */
@@ -88,6 +88,19 @@ namespace KGantt {
          */
         QDateTime mapToDateTime( qreal x ) const;
 
+        /*! Maps a point in time given as \a msecs milliseconds since the
+         * epoch (UTC) to an X value in the scene.
+         *
+         * The result is the same as that of mapFromDateTime() for the point
+         * in time in the time spec of startDateTime(), so that items after a
+         * daylight saving time transition line up with items mapped from
+         * QDateTime values. The mapping is linear between two transitions;
+         * the UTC offset is only looked up again when \a msecs falls
+         * outside of the interval mapped last.
+         * \see KGantt::StartTimeEpochRole
+         */
+        qreal mapFromEpochMSecs( qint64 msecs ) const;
+
         /*! \param ws The start day of the week.
          *
          * A solid line is drawn on the grid to mark the beginning of a new week.
@@ -73,8 +73,16 @@ namespace KGantt {
               hour_lower( DateTimeScaleFormatter::Minute, QString::fromLatin1("m" ) ),
               minute_upper( DateTimeScaleFormatter::Minute, QString::fromLatin1("m" ) ),
               minute_lower( DateTimeScaleFormatter::Second, QString::fromLatin1("s" ) ),
-              timeLine(new DateTimeTimeLine)
+              timeLine(new DateTimeTimeLine),
+              startEpochMSecs( 0 ),
+              chartXPerMSec( 0. ),
+              offsetIntervalStart( 0 ),
+              offsetIntervalEnd( 0 ),
+              intervalOffsetMSecs( 0 ),
+              epochRolesModel( nullptr ),
+              epochRoles( EpochRolesUnknown )
         {
+            updateEpochMapping();
         }
         ~Private()
         {
@@ -86,6 +94,11 @@ namespace KGantt {
         qreal dateTimeToChartX( const QDateTime& dt ) const;
         QDateTime chartXtoDateTime( qreal x ) const;
 
+        void updateEpochMapping();
+        void updateOffsetInterval( qint64 msecs ) const;
+        // the same as dateTimeToChartX() for a date time in the time spec of startDateTime
+        qreal epochMSecsToChartX( qint64 msecs ) const;
+
         int tabHeight( const QString& txt, QWidget* widget = nullptr ) const;
         void getAutomaticFormatters( DateTimeScaleFormatter** lower, DateTimeScaleFormatter** upper);
 
@@ -155,6 +168,20 @@ namespace KGantt {
         DateTimeScaleFormatter minute_upper;
         DateTimeScaleFormatter minute_lower;
         DateTimeTimeLine *timeLine;
+
+        // mapping from milliseconds since the epoch to chart x, kept up to date
+        // with startDateTime and dayWidth. It is linear between two daylight saving
+        // time transitions, the UTC offset of the interval last mapped into is cached.
+        qint64 startEpochMSecs; // wall clock time of startDateTime, as if it were UTC
+        qreal chartXPerMSec;
+        mutable qint64 offsetIntervalStart;
+        mutable qint64 offsetIntervalEnd;
+        mutable qint64 intervalOffsetMSecs;
+
+        // whether the model serves StartTimeEpochRole, found out by mapToChart()
+        enum EpochRoles { EpochRolesUnknown, EpochRolesServed, EpochRolesNotServed };
+        mutable const QAbstractItemModel* epochRolesModel;
+        mutable EpochRoles epochRoles;
     };
 
     inline DateTimeGrid::DateTimeGrid( DateTimeGrid::Private* d ) : AbstractGrid( d ) {}
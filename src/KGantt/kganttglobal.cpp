@@ -69,6 +69,8 @@ QDebug operator<<( QDebug dbg, KGantt::ItemDataRole r)
   case KGantt::TaskCompletionRole: dbg << "KGantt::TaskCompletionRole"; break;
   case KGantt::ItemTypeRole:       dbg << "KGantt::ItemTypeRole"; break;
   case KGantt::LegendRole:         dbg << "KGantt::LegendRole"; break;
+  case KGantt::StartTimeEpochRole: dbg << "KGantt::StartTimeEpochRole"; break;
+  case KGantt::EndTimeEpochRole:   dbg << "KGantt::EndTimeEpochRole"; break;
   default: dbg << static_cast<Qt::ItemDataRole>(r);
   }
   return dbg;
@@ -227,7 +227,9 @@ namespace KGantt {
         TaskCompletionRole  = KGanttRoleBase + 3, ///< Task completetion percentage used by Task items. Should be an integer og a qreal between 0 and 100.
         ItemTypeRole        = KGanttRoleBase + 4, ///< The item type. \see KGantt::ItemType.
         LegendRole          = KGanttRoleBase + 5, ///< The Legend text
-        TextPositionRole    = KGanttRoleBase + 6 ///< The position of the text label on the item. The type of this value is KGantt::StyleOptionGanttItem::Position and the default values is Right.
+        TextPositionRole    = KGanttRoleBase + 6, ///< The position of the text label on the item. The type of this value is KGantt::StyleOptionGanttItem::Position and the default values is Right.
+        StartTimeEpochRole  = KGanttRoleBase + 7, ///< Optional. The start time as qint64 milliseconds since the epoch (UTC). If served, it must describe the same time as StartTimeRole, which should be in the time spec of KGantt::DateTimeGrid::startDateTime(), and lets KGantt::DateTimeGrid place the item without converting a QDateTime. SummaryHandlingProxyModel does not serve it for summaries.
+        EndTimeEpochRole    = KGanttRoleBase + 8 ///< Optional. The end time as qint64 milliseconds since the epoch (UTC). \see StartTimeEpochRole
     };
 
     /*!\enum KGantt::ItemType
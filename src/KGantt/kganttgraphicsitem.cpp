@@ -62,7 +62,8 @@ namespace {
 }
 
 GraphicsItem::GraphicsItem( QGraphicsItem* parent, GraphicsScene* scene )
-    : BASE( parent ),  m_isupdating( false )
+    : BASE( parent ),  m_isupdating( false ),
+      m_pendingStartConstraints( 0 ), m_pendingEndConstraints( 0 ), m_styleOptionValid( false )
 {
   if ( scene )
     scene->addItem( this );
@@ -71,7 +72,8 @@ GraphicsItem::GraphicsItem( QGraphicsItem* parent, GraphicsScene* scene )
 
 GraphicsItem::GraphicsItem( const QModelIndex& idx, QGraphicsItem* parent,
                                             GraphicsScene* scene )
-    : BASE( parent ),  m_index( idx ), m_isupdating( false )
+    : BASE( parent ),  m_index( idx ), m_isupdating( false ),
+      m_pendingStartConstraints( 0 ), m_pendingEndConstraints( 0 ), m_styleOptionValid( false )
 {
   init();
   if ( scene )
@@ -99,41 +101,53 @@ int GraphicsItem::type() const
 
 StyleOptionGanttItem GraphicsItem::getStyleOption() const
 {
-    StyleOptionGanttItem opt;
     if (!m_index.isValid()) {
         // TODO: find out why we get invalid indexes
         //qDebug()<<"GraphicsItem::getStyleOption: Invalid index";
-        return opt;
+        return StyleOptionGanttItem();
     }
-    opt.palette = QApplication::palette();
-    opt.itemRect = rect();
-    opt.boundingRect = boundingRect();
-    QVariant tp = m_index.model()->data( m_index, TextPositionRole );
-    if (tp.isValid()) {
-        opt.displayPosition = static_cast<StyleOptionGanttItem::Position>(tp.toInt());
-    } else {
+    if ( !m_styleOptionValid || m_styleOption.font != QFont() ) {
+        // Resolve everything that comes from the model only once, the
+        // cache is dropped by invalidateStyleOption() when the data changes
+        // and rebuilt when the application font changes
+        m_styleOption = StyleOptionGanttItem();
+        StyleOptionGanttItem& opt = m_styleOption;
+        QVariant tp = m_index.model()->data( m_index, TextPositionRole );
+        if (tp.isValid()) {
+            opt.displayPosition = static_cast<StyleOptionGanttItem::Position>(tp.toInt());
+        } else {
 #if 0
-        qDebug() << "Item" << m_index.model()->data( m_index, Qt::DisplayRole ).toString()
-                 << ", ends="<<m_endConstraints.size() << ", starts="<<m_startConstraints.size();
+            qDebug() << "Item" << m_index.model()->data( m_index, Qt::DisplayRole ).toString()
+                     << ", ends="<<m_endConstraints.size() << ", starts="<<m_startConstraints.size();
 #endif
-        opt.displayPosition = m_endConstraints.size()<m_startConstraints.size()?StyleOptionGanttItem::Left:StyleOptionGanttItem::Right;
+            // count the constraints whose items the scene has not created yet, too
+            const int starts = m_startConstraints.size() + m_pendingStartConstraints;
+            const int ends = m_endConstraints.size() + m_pendingEndConstraints;
+            opt.displayPosition = ends<starts?StyleOptionGanttItem::Left:StyleOptionGanttItem::Right;
 #if 0
-        qDebug() << "choosing" << opt.displayPosition;
+            qDebug() << "choosing" << opt.displayPosition;
 #endif
-    }
-    QVariant da = m_index.model()->data( m_index, Qt::TextAlignmentRole );
-    if ( da.isValid() ) {
-        opt.displayAlignment = static_cast< Qt::Alignment >( da.toInt() );
-    } else {
-        switch ( opt.displayPosition ) {
-        case StyleOptionGanttItem::Left: opt.displayAlignment = Qt::AlignLeft|Qt::AlignVCenter; break;
-        case StyleOptionGanttItem::Right: opt.displayAlignment = Qt::AlignRight|Qt::AlignVCenter; break;
-        case StyleOptionGanttItem::Hidden: // fall through
-        case StyleOptionGanttItem::Center: opt.displayAlignment = Qt::AlignCenter; break;
         }
+        QVariant da = m_index.model()->data( m_index, Qt::TextAlignmentRole );
+        if ( da.isValid() ) {
+            opt.displayAlignment = static_cast< Qt::Alignment >( da.toInt() );
+        } else {
+            switch ( opt.displayPosition ) {
+            case StyleOptionGanttItem::Left: opt.displayAlignment = Qt::AlignLeft|Qt::AlignVCenter; break;
+            case StyleOptionGanttItem::Right: opt.displayAlignment = Qt::AlignRight|Qt::AlignVCenter; break;
+            case StyleOptionGanttItem::Hidden: // fall through
+            case StyleOptionGanttItem::Center: opt.displayAlignment = Qt::AlignCenter; break;
+            }
+        }
+        opt.text = m_index.model()->data( m_index, Qt::DisplayRole ).toString();
+        m_styleOptionValid = true;
     }
+
+    StyleOptionGanttItem opt = m_styleOption;
+    opt.palette = QApplication::palette();
+    opt.itemRect = rect();
+    opt.boundingRect = boundingRect();
     opt.grid = const_cast<AbstractGrid*>(scene()->getGrid());
-    opt.text = m_index.model()->data( m_index, Qt::DisplayRole ).toString();
     if ( isEnabled() ) opt.state  |= QStyle::State_Enabled;
     if ( isSelected() ) opt.state |= QStyle::State_Selected;
     if ( hasFocus() ) opt.state   |= QStyle::State_HasFocus;
@@ -191,10 +205,18 @@ void GraphicsItem::paint( QPainter* painter, const QStyleOptionGraphicsItem* opt
 
 void GraphicsItem::setIndex( const QPersistentModelIndex& idx )
 {
+    if ( m_index != idx )
+        m_styleOptionValid = false;
     m_index=idx;
     update();
 }
 
+void GraphicsItem::invalidateStyleOption()
+{
+    m_styleOptionValid = false;
+    update();
+}
+
 QString GraphicsItem::ganttToolTip() const
 {
     return scene()->itemDelegate()->toolTip( index() );
@@ -232,10 +254,14 @@ QPointF GraphicsItem::endConnector( int relationType ) const
 
 void GraphicsItem::constraintsChanged()
 {
+    // the default text position depends on the number of constraints
+    m_styleOptionValid = false;
     if ( !scene() || !scene()->itemDelegate() ) return;
     const Span bs = scene()->itemDelegate()->itemBoundingSpan( getStyleOption(), index() );
     const QRectF br = boundingRect();
-    setBoundingRect( QRectF( bs.start(), 0., bs.length(), br.height() ) );
+    const QRectF newbr( bs.start(), 0., bs.length(), br.height() );
+    if ( newbr != br )
+        setBoundingRect( newbr );
 }
 
 void GraphicsItem::addStartConstraint( ConstraintGraphicsItem* item )
@@ -254,6 +280,14 @@ void GraphicsItem::addEndConstraint( ConstraintGraphicsItem* item )
     constraintsChanged();
 }
 
+void GraphicsItem::adjustPendingConstraintCount( int startDelta, int endDelta )
+{
+    m_pendingStartConstraints += startDelta;
+    m_pendingEndConstraints += endDelta;
+    assert( m_pendingStartConstraints >= 0 && m_pendingEndConstraints >= 0 );
+    constraintsChanged();
+}
+
 void GraphicsItem::removeStartConstraint( ConstraintGraphicsItem* item )
 {
     assert( item );
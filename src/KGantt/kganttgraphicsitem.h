@@ -66,6 +66,7 @@ namespace KGantt {
 
         const QPersistentModelIndex& index() const { return m_index; }
         void setIndex( const QPersistentModelIndex& idx );
+        void invalidateStyleOption();
 
         bool isEditable() const;
         bool isUpdating() const { return m_isupdating; }
@@ -76,6 +77,7 @@ namespace KGantt {
         void removeEndConstraint( ConstraintGraphicsItem* );
         QList<ConstraintGraphicsItem*> startConstraints() const { return m_startConstraints; }
         QList<ConstraintGraphicsItem*> endConstraints() const { return m_endConstraints; }
+        void adjustPendingConstraintCount( int startDelta, int endDelta );
 
         /*reimp*/ QRectF boundingRect() const override;
         /*reimp*/ void paint( QPainter* painter, const QStyleOptionGraphicsItem* option,
@@ -113,6 +115,10 @@ namespace KGantt {
         GraphicsItem* m_dragtarget;
         QList<ConstraintGraphicsItem*> m_startConstraints;
         QList<ConstraintGraphicsItem*> m_endConstraints;
+        int m_pendingStartConstraints;
+        int m_pendingEndConstraints;
+        mutable StyleOptionGanttItem m_styleOption;
+        mutable bool m_styleOptionValid;
     };
 }
 
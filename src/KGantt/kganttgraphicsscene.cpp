@@ -36,6 +36,7 @@
 #include <QTextDocument>
 #include <QToolTip>
 #include <QSet>
+#include <QtMath>
 
 #include <QDebug>
 
@@ -65,6 +66,8 @@ GraphicsScene::Private::Private( GraphicsScene* _q )
       isPrinting( false ),
       drawColumnLabels( true ),
       labelsWidth( 0.0 ),
+      pendingBandsDirty( false ),
+      pendingCreationScheduled( false ),
       summaryHandlingModel( new SummaryHandlingProxyModel( _q ) ),
       selectionModel( nullptr )
 {
@@ -76,13 +79,29 @@ GraphicsScene::Private::~Private()
     delete grid;
 }
 
+GraphicsScene::Private::ConstraintKey GraphicsScene::Private::constraintKey( const Constraint& c )
+{
+    return ConstraintKey( c.startIndex(), c.endIndex() );
+}
+
 void GraphicsScene::Private::clearConstraintItems()
 {
-    for(ConstraintGraphicsItem *citem : constraintItems) {
+    for ( const PendingConstraint& pc : qAsConst( pendingConstraints ) ) {
+        pc.startItem->adjustPendingConstraintCount( -1, 0 );
+        pc.endItem->adjustPendingConstraintCount( 0, -1 );
+    }
+    pendingConstraints.clear();
+    pendingBands.clear();
+    pendingBandsDirty = false;
+
+    for ( ConstraintGraphicsItem *citem : qAsConst( constraintItems ) ) {
         // remove constraint from items first
-        for(GraphicsItem *item : items) {
-            item->removeStartConstraint(citem);
-            item->removeEndConstraint(citem);
+        const Constraint c = citem->constraint();
+        if ( GraphicsItem* item = items.value( summaryHandlingModel->mapFromSource( c.startIndex() ), nullptr ) ) {
+            item->removeStartConstraint( citem );
+        }
+        if ( GraphicsItem* item = items.value( summaryHandlingModel->mapFromSource( c.endIndex() ), nullptr ) ) {
+            item->removeEndConstraint( citem );
         }
         q->removeItem(citem);
         delete citem;
@@ -107,16 +126,199 @@ void GraphicsScene::Private::createConstraintItem( const Constraint& c )
     GraphicsItem* eitem = q->findItem( summaryHandlingModel->mapFromSource( c.endIndex() ) );
 
     if ( sitem && eitem ) {
-        ConstraintGraphicsItem* citem = new ConstraintGraphicsItem( c );
-        sitem->addStartConstraint( citem );
-        eitem->addEndConstraint( citem );
-        constraintItems.append( citem );
-        q->addItem( citem );
+        addPendingConstraint( c, sitem, eitem );
     }
 
     //q->insertConstraintItem( c, citem );
 }
 
+void GraphicsScene::Private::addPendingConstraint( const Constraint& c, GraphicsItem* sitem, GraphicsItem* eitem )
+{
+    PendingConstraint pc;
+    pc.constraint = c;
+    pc.startItem = sitem;
+    pc.endItem = eitem;
+    pc.firstBand = 0;
+    pc.lastBand = -1;
+    filePendingConstraint( constraintKey( c ), &pc );
+    pendingConstraints.insert( constraintKey( c ), pc );
+    sitem->adjustPendingConstraintCount( 1, 0 );
+    eitem->adjustPendingConstraintCount( 0, 1 );
+}
+
+// Forget the constraints of item that were not created yet, before item goes away
+void GraphicsScene::Private::removePendingConstraints( GraphicsItem* item )
+{
+    if ( pendingConstraints.isEmpty() ) return;
+
+    QList<ConstraintKey> keys;
+    if ( !constraintModel.isNull() && item->index().isValid() ) {
+        const QList<Constraint> clst = constraintModel->constraintsForIndex( summaryHandlingModel->mapToSource( item->index() ) );
+        for ( const Constraint& c : clst ) {
+            keys << constraintKey( c );
+        }
+    } else {
+        // the index is gone already, so look at every pending constraint
+        keys = pendingConstraints.uniqueKeys();
+    }
+
+    for ( const ConstraintKey& key : qAsConst( keys ) ) {
+        QMultiHash<ConstraintKey,PendingConstraint>::iterator it = pendingConstraints.find( key );
+        while ( it != pendingConstraints.end() && it.key() == key ) {
+            if ( it->startItem == item || it->endItem == item ) {
+                if ( it->startItem != item ) it->startItem->adjustPendingConstraintCount( -1, 0 );
+                if ( it->endItem != item ) it->endItem->adjustPendingConstraintCount( 0, -1 );
+                const PendingConstraint pc = *it;
+                it = pendingConstraints.erase( it );
+                unfilePendingConstraint( key, pc );
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+QRectF GraphicsScene::Private::pendingConstraintRect( const PendingConstraint& pc ) const
+{
+    const QRectF srect = pc.startItem->mapToScene( pc.startItem->rect() ).boundingRect();
+    const QRectF erect = pc.endItem->mapToScene( pc.endItem->rect() ).boundingRect();
+    // The delegate routes the line a bit around the items and event items
+    // are drawn centered on their start, so leave some room
+    const qreal margin = 20. + qMax( srect.height(), erect.height() );
+    return srect.united( erect ).adjusted( -margin, -margin, margin, margin );
+}
+
+static const qreal s_pendingBandHeight = 256.;
+
+static int pendingBand( qreal y )
+{
+    return qFloor( y / s_pendingBandHeight );
+}
+
+void GraphicsScene::Private::filePendingConstraint( const ConstraintKey& key, PendingConstraint* pc )
+{
+    if ( pendingBandsDirty ) {
+        // rebuildPendingBands() files it
+        return;
+    }
+    const QRectF rect = pendingConstraintRect( *pc );
+    pc->firstBand = pendingBand( rect.top() );
+    pc->lastBand = pendingBand( rect.bottom() );
+    for ( int band = pc->firstBand; band <= pc->lastBand; ++band ) {
+        pendingBands[ band ].insert( key );
+    }
+}
+
+// Call after pc was removed from pendingConstraints
+void GraphicsScene::Private::unfilePendingConstraint( const ConstraintKey& key, const PendingConstraint& pc )
+{
+    if ( pendingBandsDirty || pendingConstraints.contains( key ) ) {
+        // the other constraints between the same items are filed the same way
+        return;
+    }
+    for ( int band = pc.firstBand; band <= pc.lastBand; ++band ) {
+        QHash<int, QSet<ConstraintKey> >::iterator it = pendingBands.find( band );
+        if ( it != pendingBands.end() ) {
+            it->remove( key );
+            if ( it->isEmpty() ) {
+                pendingBands.erase( it );
+            }
+        }
+    }
+}
+
+void GraphicsScene::Private::rebuildPendingBands()
+{
+    pendingBands.clear();
+    pendingBandsDirty = false;
+    for ( QMultiHash<ConstraintKey,PendingConstraint>::iterator it = pendingConstraints.begin();
+          it != pendingConstraints.end(); ++it ) {
+        filePendingConstraint( it.key(), &it.value() );
+    }
+}
+
+QMultiHash<GraphicsScene::Private::ConstraintKey,GraphicsScene::Private::PendingConstraint>::iterator
+GraphicsScene::Private::createPendingConstraintItem( QMultiHash<ConstraintKey,PendingConstraint>::iterator it )
+{
+    const PendingConstraint pc = *it;
+    const ConstraintKey key = it.key();
+    it = pendingConstraints.erase( it );
+    unfilePendingConstraint( key, pc );
+
+    ConstraintGraphicsItem* citem = new ConstraintGraphicsItem( pc.constraint );
+    pc.startItem->adjustPendingConstraintCount( -1, 0 );
+    pc.endItem->adjustPendingConstraintCount( 0, -1 );
+    pc.startItem->addStartConstraint( citem );
+    pc.endItem->addEndConstraint( citem );
+    constraintItems.insert( key, citem );
+    q->addItem( citem );
+    return it;
+}
+
+void GraphicsScene::Private::createVisibleConstraintItems( const QRectF& rect )
+{
+    if ( pendingConstraints.isEmpty() || rect.isEmpty() ) return;
+    if ( pendingBandsDirty ) {
+        rebuildPendingBands();
+    }
+
+    // only the constraints filed under the bands of rect can be visible
+    QSet<ConstraintKey> candidates;
+    const int firstBand = pendingBand( rect.top() );
+    const int lastBand = pendingBand( rect.bottom() );
+    if ( lastBand - firstBand >= pendingBands.size() ) {
+        for ( QHash<int, QSet<ConstraintKey> >::const_iterator it = pendingBands.constBegin();
+              it != pendingBands.constEnd(); ++it ) {
+            if ( it.key() >= firstBand && it.key() <= lastBand ) {
+                candidates += it.value();
+            }
+        }
+    } else {
+        for ( int band = firstBand; band <= lastBand; ++band ) {
+            QHash<int, QSet<ConstraintKey> >::const_iterator it = pendingBands.constFind( band );
+            if ( it != pendingBands.constEnd() ) {
+                candidates += it.value();
+            }
+        }
+    }
+
+    for ( const ConstraintKey& key : qAsConst( candidates ) ) {
+        QMultiHash<ConstraintKey,PendingConstraint>::iterator it = pendingConstraints.find( key );
+        while ( it != pendingConstraints.end() && it.key() == key ) {
+            if ( pendingConstraintRect( *it ).intersects( rect ) ) {
+                it = createPendingConstraintItem( it );
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+// Remember rect, painted just now, to create the constraint items there once painting is done
+void GraphicsScene::Private::scheduleVisibleConstraintItems( const QRectF& rect )
+{
+    if ( pendingConstraints.isEmpty() ) return;
+    pendingExposedRect |= rect;
+    if ( !pendingCreationScheduled ) {
+        pendingCreationScheduled = true;
+        QMetaObject::invokeMethod( q, "slotCreateVisibleConstraintItems", Qt::QueuedConnection );
+    }
+}
+
+ConstraintGraphicsItem* GraphicsScene::Private::materializeConstraintItem( const Constraint& c )
+{
+    const ConstraintKey key = constraintKey( c );
+    QMultiHash<ConstraintKey,PendingConstraint>::iterator it = pendingConstraints.find( key );
+    while ( it != pendingConstraints.end() && it.key() == key ) {
+        if ( it->constraint == c ) {
+            createPendingConstraintItem( it );
+            break;
+        }
+        ++it;
+    }
+    return findConstraintItem( c );
+}
+
 // Delete the constraint item, and clean up pointers in the start- and end item
 void GraphicsScene::Private::deleteConstraintItem( ConstraintGraphicsItem *citem )
 {
@@ -133,47 +335,49 @@ void GraphicsScene::Private::deleteConstraintItem( ConstraintGraphicsItem *citem
     if ( item ) {
         item->removeEndConstraint( citem );
     }
-    constraintItems.removeAt(constraintItems.indexOf(citem));
+    constraintItems.remove( constraintKey( c ), citem );
     delete citem;
 }
 
 void GraphicsScene::Private::deleteConstraintItem( const Constraint& c )
 {
+    const ConstraintKey key = constraintKey( c );
+    // there may be more constraints between the same items, of other types
+    QMultiHash<ConstraintKey,PendingConstraint>::iterator it = pendingConstraints.find( key );
+    while ( it != pendingConstraints.end() && it.key() == key ) {
+        if ( it->constraint == c ) {
+            it->startItem->adjustPendingConstraintCount( -1, 0 );
+            it->endItem->adjustPendingConstraintCount( 0, -1 );
+            const PendingConstraint pc = *it;
+            pendingConstraints.erase( it );
+            unfilePendingConstraint( key, pc );
+            return;
+        }
+        ++it;
+    }
     deleteConstraintItem( findConstraintItem( c ) );
 }
 
 ConstraintGraphicsItem* GraphicsScene::Private::findConstraintItem( const Constraint& c ) const
 {
-    GraphicsItem* item = items.value( summaryHandlingModel->mapFromSource( c.startIndex() ), nullptr );
-    if ( item ) {
-        const QList<ConstraintGraphicsItem*> clst = item->startConstraints();
-        QList<ConstraintGraphicsItem*>::const_iterator it = clst.begin();
-        for ( ; it != clst.end() ; ++it ) {
-            if ( c.compareIndexes((*it)->constraint()) )
-                break;
-        }
-        if ( it != clst.end() ) {
+    const ConstraintKey key = constraintKey( c );
+    QMultiHash<ConstraintKey,ConstraintGraphicsItem*>::const_iterator it = constraintItems.constFind( key );
+    for ( ; it != constraintItems.constEnd() && it.key() == key; ++it ) {
+        if ( ( *it )->constraint() == c ) {
             return *it;
         }
     }
-    item = items.value( summaryHandlingModel->mapFromSource( c.endIndex() ), nullptr );
-    if ( item ) {
-        const QList<ConstraintGraphicsItem*> clst = item->endConstraints();
-        QList<ConstraintGraphicsItem*>::const_iterator it = clst.begin();
-        for ( ; it != clst.end() ; ++it ) {
-            if ( c.compareIndexes( (*it)->constraint() ) )
-                break;
-        }
-        if ( it != clst.end() ) {
-            return *it;
-        }
-    }
-    return nullptr;
+    // like before, any constraint between the same items will do
+    return constraintItems.value( key, nullptr );
 }
 
 // NOTE: we might get here after indexes are invalidated, so cannot do any controlled cleanup
 void GraphicsScene::Private::clearItems()
 {
+    // the pending constraints only point to the items we are deleting
+    pendingConstraints.clear();
+    pendingBands.clear();
+    pendingBandsDirty = false;
     for(GraphicsItem *item : items) {
         q->removeItem(item);
         delete item;
@@ -455,6 +659,8 @@ void GraphicsScene::updateRow( const QModelIndex& rowidx )
         }
     }
 
+    // the items of the row may move
+    d->pendingBandsDirty = true;
     bool blocked = blockSignals( true );
     for ( int col = 0; col < summaryHandlingModel()->columnCount( rowidx.parent() ); ++col ) {
         const QModelIndex idx = summaryHandlingModel()->index( rowidx.row(), col, rowidx.parent() );
@@ -488,7 +694,7 @@ void GraphicsScene::updateRow( const QModelIndex& rowidx )
 void GraphicsScene::insertItem( const QPersistentModelIndex& idx, GraphicsItem* item )
 {
     if ( !d->constraintModel.isNull() ) {
-        // Create items for constraints
+        // Remember the constraints, their items are created once they get visible
         const QModelIndex sidx = summaryHandlingModel()->mapToSource( idx );
         const QList<Constraint> clst = d->constraintModel->constraintsForIndex( sidx );
         for ( const Constraint& c :  clst ) {
@@ -497,20 +703,12 @@ void GraphicsScene::insertItem( const QPersistentModelIndex& idx, GraphicsItem*
                 other_idx = c.endIndex();
                 GraphicsItem* other_item = d->items.value(summaryHandlingModel()->mapFromSource( other_idx ),nullptr);
                 if ( !other_item ) continue;
-                ConstraintGraphicsItem* citem = new ConstraintGraphicsItem( c );
-                item->addStartConstraint( citem );
-                other_item->addEndConstraint( citem );
-                d->constraintItems.append( citem );
-                addItem( citem );
+                d->addPendingConstraint( c, item, other_item );
             } else if ( c.endIndex() == sidx ) {
                 other_idx = c.startIndex();
                 GraphicsItem* other_item = d->items.value(summaryHandlingModel()->mapFromSource( other_idx ),nullptr);
                 if ( !other_item ) continue;
-                ConstraintGraphicsItem* citem = new ConstraintGraphicsItem( c );
-                other_item->addStartConstraint( citem );
-                item->addEndConstraint( citem );
-                d->constraintItems.append( citem );
-                addItem( citem );
+                d->addPendingConstraint( c, other_item, item );
             } else {
                 assert( 0 ); // Impossible
             }
@@ -537,6 +735,7 @@ void GraphicsScene::removeItem( const QModelIndex& idx )
             for ( ConstraintGraphicsItem* citem : clst ) {
                 d->deleteConstraintItem( citem );
             }
+            d->removePendingConstraints( item );
         }
         // Get rid of the item
         delete item;
@@ -566,6 +765,7 @@ void GraphicsScene::clearItems()
 
 void GraphicsScene::updateItems()
 {
+    d->pendingBandsDirty = true;
     for ( QHash<QPersistentModelIndex,GraphicsItem*>::iterator it = d->items.begin();
           it != d->items.end(); ++it ) {
         GraphicsItem* const item = it.value();
@@ -593,12 +793,14 @@ void GraphicsScene::deleteSubtree( const QModelIndex& _idx )
 
 ConstraintGraphicsItem* GraphicsScene::findConstraintItem( const Constraint& c ) const
 {
-    return d->findConstraintItem( c );
+    // the item may not have been painted yet
+    return const_cast<Private*>( d )->materializeConstraintItem( c );
 }
 
 void GraphicsScene::slotConstraintAdded( const KGantt::Constraint& c )
 {
     d->createConstraintItem( c );
+    update();
 }
 
 void GraphicsScene::slotConstraintRemoved( const KGantt::Constraint& c )
@@ -606,6 +808,14 @@ void GraphicsScene::slotConstraintRemoved( const KGantt::Constraint& c )
     d->deleteConstraintItem( c );
 }
 
+void GraphicsScene::slotCreateVisibleConstraintItems()
+{
+    d->pendingCreationScheduled = false;
+    const QRectF rect = d->pendingExposedRect;
+    d->pendingExposedRect = QRectF();
+    d->createVisibleConstraintItems( rect );
+}
+
 void GraphicsScene::slotGridChanged()
 {
     updateItems();
@@ -651,6 +861,11 @@ void GraphicsScene::helpEvent( QGraphicsSceneHelpEvent *helpEvent )
 
 void GraphicsScene::drawBackground( QPainter* painter, const QRectF& _rect )
 {
+    // Constraint items are only created once they have been painted, not while painting
+    if ( !d->isPrinting ) {
+        d->scheduleVisibleConstraintItems( _rect );
+    }
+
     QRectF scn( sceneRect() );
     QRectF rect( _rect );
     if ( d->isPrinting && d->drawColumnLabels ) {
@@ -854,6 +1069,9 @@ void GraphicsScene::doPrint( QPainter* painter, const QRectF& targetRect,
         yratio = targetRect.width()/scnRect.width();
     }
 
+    // render() collects its items before drawing the background
+    d->createVisibleConstraintItems( scnRect );
+
     qreal offset = scnRect.left();
     int pagecount = 0;
     while ( offset < scnRect.right() ) {
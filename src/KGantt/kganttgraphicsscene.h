@@ -84,7 +84,12 @@ namespace KGantt {
         void clearItems();
         void deleteSubtree( const QModelIndex& );
 
-        ConstraintGraphicsItem* findConstraintItem( const Constraint& ) const;
+        /*! \returns The item of the constraint \a c, or nullptr if there is none.
+         *
+         * Constraint items are created when the area of the constraint is painted
+         * for the first time, or when they are asked for here.
+         */
+        ConstraintGraphicsItem* findConstraintItem( const Constraint& c ) const;
         QList<ConstraintGraphicsItem*> findConstraintItems( const QModelIndex& idx ) const;
 
         void setItemDelegate( ItemDelegate* );
@@ -203,6 +208,7 @@ namespace KGantt {
         void slotConstraintAdded( const KGantt::Constraint& );
         void slotConstraintRemoved( const KGantt::Constraint& );
         void slotGridChanged();
+        void slotCreateVisibleConstraintItems();
         void slotSelectionChanged(const QItemSelection &selected, const QItemSelection &deselected);
         void selectionModelChanged(QAbstractItemModel *);
 
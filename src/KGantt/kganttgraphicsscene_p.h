@@ -22,11 +22,15 @@
 
 #include <QPersistentModelIndex>
 #include <QHash>
+#include <QPair>
 #include <QPointer>
+#include <QRectF>
+#include <QSet>
 #include <QItemSelectionModel>
 #include <QAbstractProxyModel>
 
 #include "kganttgraphicsscene.h"
+#include "kganttconstraint.h"
 #include "kganttconstraintmodel.h"
 #include "kganttdatetimegrid.h"
 
@@ -38,9 +42,36 @@ namespace KGantt {
         explicit Private(GraphicsScene*);
         ~Private();
 
+        /* Constraint items are only created once they become visible,
+         * until then the constraint is kept as a PendingConstraint. It is
+         * filed under the horizontal bands of the scene its area covers,
+         * from firstBand to lastBand, so that finding the visible ones
+         * does not look at all of them. */
+        typedef QPair<QPersistentModelIndex, QPersistentModelIndex> ConstraintKey;
+        struct PendingConstraint {
+            Constraint constraint;
+            GraphicsItem* startItem;
+            GraphicsItem* endItem;
+            int firstBand;
+            int lastBand;
+        };
+
+        static ConstraintKey constraintKey( const Constraint& c );
+
         void clearConstraintItems();
         void resetConstraintItems();
         void createConstraintItem( const Constraint& c );
+        void addPendingConstraint( const Constraint& c, GraphicsItem* sitem, GraphicsItem* eitem );
+        void removePendingConstraints( GraphicsItem* item );
+        QRectF pendingConstraintRect( const PendingConstraint& pc ) const;
+        void filePendingConstraint( const ConstraintKey& key, PendingConstraint* pc );
+        void unfilePendingConstraint( const ConstraintKey& key, const PendingConstraint& pc );
+        void rebuildPendingBands();
+        QMultiHash<ConstraintKey,PendingConstraint>::iterator createPendingConstraintItem(
+            QMultiHash<ConstraintKey,PendingConstraint>::iterator it );
+        void createVisibleConstraintItems( const QRectF& rect );
+        void scheduleVisibleConstraintItems( const QRectF& rect );
+        ConstraintGraphicsItem* materializeConstraintItem( const Constraint& c );
         void deleteConstraintItem( ConstraintGraphicsItem* citem );
         void deleteConstraintItem( const Constraint& c );
         ConstraintGraphicsItem* findConstraintItem( const Constraint& c ) const;
@@ -54,7 +85,14 @@ namespace KGantt {
         GraphicsScene* q;
 
         QHash<QPersistentModelIndex,GraphicsItem*> items;
-        QList<ConstraintGraphicsItem*> constraintItems;
+        QMultiHash<ConstraintKey,ConstraintGraphicsItem*> constraintItems;
+        QMultiHash<ConstraintKey,PendingConstraint> pendingConstraints;
+        QHash<int, QSet<ConstraintKey> > pendingBands;
+        // items were moved, so the bands of the pending constraints need to be found again
+        bool pendingBandsDirty;
+        // painted since the last slotCreateVisibleConstraintItems()
+        QRectF pendingExposedRect;
+        bool pendingCreationScheduled;
         GraphicsItem* dragSource;
 
         QPointer<ItemDelegate> itemDelegate;
@@ -201,8 +201,12 @@ void HeaderWidget::contextMenuEvent( QContextMenuEvent* event )
 }
 
 GraphicsView::Private::Private( GraphicsView* _q )
-  : q( _q ), rowcontroller(nullptr), headerwidget( _q )
+  : q( _q ), rowcontroller(nullptr), headerwidget( _q ),
+    asyncSceneUpdate( false ),
+    sceneUpdateChunkSize( 500 ),
+    sceneUpdateRows( 0 )
 {
+    sceneUpdateTimer.setInterval( 0 );
 }
 
 GraphicsView::Private::~Private()
@@ -253,11 +257,69 @@ void GraphicsView::Private::slotColumnsRemoved( const QModelIndex& parent,  int
     q->updateScene();
 }
 
+void GraphicsView::Private::startSceneUpdate( const QModelIndex& first )
+{
+    // Rows in the visible area first, so there is something to look at right away
+    sceneUpdateRowsAhead.clear();
+    const qreal bottom = q->mapToScene( q->viewport()->rect().bottomLeft() ).y();
+    QModelIndex idx = rowcontroller->indexAt( qMax( 0, static_cast<int>( q->mapToScene( 0, 0 ).y() ) ) );
+    while ( idx.isValid() && rowcontroller->isRowVisible( idx ) ) {
+        q->updateRow( idx );
+        sceneUpdateRowsAhead.insert( idx );
+        if ( rowcontroller->rowGeometry( idx ).end() >= bottom ) break;
+        idx = rowcontroller->indexBelow( idx );
+    }
+    q->updateSceneRect();
+
+    // ... and all rows from the top in chunks
+    sceneUpdateRows = 0;
+    nextSceneUpdateRow = first;
+    sceneUpdateTimer.start();
+}
+
+void GraphicsView::Private::stopSceneUpdate()
+{
+    sceneUpdateTimer.stop();
+    nextSceneUpdateRow = QPersistentModelIndex();
+    sceneUpdateRowsAhead.clear();
+}
+
+void GraphicsView::Private::slotSceneUpdateStep()
+{
+    QModelIndex idx = nextSceneUpdateRow;
+    for ( int i = 0; i < sceneUpdateChunkSize && idx.isValid(); ++i ) {
+        // the rows in the visible area are up to date already
+        if ( !sceneUpdateRowsAhead.remove( idx ) ) {
+            q->updateRow( idx );
+        }
+        ++sceneUpdateRows;
+        idx = rowcontroller->indexBelow( idx );
+        if ( idx.isValid() && !rowcontroller->isRowVisible( idx ) )
+            idx = QModelIndex();
+    }
+    q->updateSceneRect();
+    emit q->sceneUpdateProgress( sceneUpdateRows );
+
+    if ( idx.isValid() ) {
+        nextSceneUpdateRow = idx;
+        return;
+    }
+    stopSceneUpdate();
+    scene.invalidate( QRectF(), QGraphicsScene::BackgroundLayer );
+    emit q->sceneUpdateFinished();
+}
+
 void GraphicsView::Private::slotDataChanged( const QModelIndex& topLeft, const QModelIndex& bottomRight )
 {
     //qDebug() << "GraphicsView::slotDataChanged("<<topLeft<<bottomRight<<")";
     const QModelIndex parent = topLeft.parent();
+    const int columnCount = scene.summaryHandlingModel()->columnCount( parent );
     for ( int row = topLeft.row(); row <= bottomRight.row(); ++row ) {
+        // The roles of an item may be served by any column, see ProxyModel
+        for ( int col = 0; col < columnCount; ++col ) {
+            GraphicsItem* item = scene.findItem( scene.summaryHandlingModel()->index( row, col, parent ) );
+            if ( item ) item->invalidateStyleOption();
+        }
         scene.updateRow( scene.summaryHandlingModel()->index( row, 0, parent ) );
     }
 }
@@ -366,6 +428,8 @@ GraphicsView::GraphicsView( QWidget* parent )
              this, SLOT(updateSceneRect()) );
     connect( &_d->headerwidget, SIGNAL(customContextMenuRequested(QPoint)),
              this, SLOT(slotHeaderContextMenuRequested(QPoint)) );
+    connect( &_d->sceneUpdateTimer, SIGNAL(timeout()),
+             this, SLOT(slotSceneUpdateStep()) );
     setScene( &_d->scene );
 
     // HACK!
@@ -599,6 +663,7 @@ QModelIndex GraphicsView::indexAt( const QPoint& pos ) const
 
 void GraphicsView::clearItems()
 {
+    d->stopSceneUpdate();
     d->scene.clearItems();
 }
 
@@ -638,11 +703,20 @@ void GraphicsView::updateSceneRect()
 
 
 void GraphicsView::updateScene()
+{
+    updateScene( model() ? model()->index( 0, 0, rootIndex() ) : QModelIndex() );
+}
+
+void GraphicsView::updateScene( const QModelIndex& first )
 {
     clearItems();
     if ( !model()) return;
     if ( !rowController()) return;
-    QModelIndex idx = model()->index( 0, 0, rootIndex() );
+    if ( d->asyncSceneUpdate ) {
+        d->startSceneUpdate( first );
+        return;
+    }
+    QModelIndex idx = first;
     do {
         updateRow( idx );
     } while ( ( idx = rowController()->indexBelow( idx ) ) != QModelIndex() && rowController()->isRowVisible(idx) );
@@ -663,6 +737,36 @@ GraphicsItem* GraphicsView::createItem( ItemType type ) const
 #endif
 
 
+void GraphicsView::setAsynchronousSceneUpdate( bool async )
+{
+    if ( d->asyncSceneUpdate == async ) return;
+    d->asyncSceneUpdate = async;
+    // finish a pending update right away
+    while ( !async && isSceneUpdatePending() ) {
+        d->slotSceneUpdateStep();
+    }
+}
+
+bool GraphicsView::asynchronousSceneUpdate() const
+{
+    return d->asyncSceneUpdate;
+}
+
+void GraphicsView::setSceneUpdateChunkSize( int rows )
+{
+    d->sceneUpdateChunkSize = qMax( 1, rows );
+}
+
+int GraphicsView::sceneUpdateChunkSize() const
+{
+    return d->sceneUpdateChunkSize;
+}
+
+bool GraphicsView::isSceneUpdatePending() const
+{
+    return d->sceneUpdateTimer.isActive();
+}
+
 void GraphicsView::deleteSubtree( const QModelIndex& idx )
 {
     d->scene.deleteSubtree( d->scene.summaryHandlingModel()->mapFromSource( idx ) );
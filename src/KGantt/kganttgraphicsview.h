@@ -66,6 +66,7 @@ namespace KGantt {
 
         Q_PRIVATE_SLOT( d, void slotItemClicked( const QModelIndex& idx ) )
         Q_PRIVATE_SLOT( d, void slotItemDoubleClicked( const QModelIndex& idx ) )
+        Q_PRIVATE_SLOT( d, void slotSceneUpdateStep() )
     public:
         /*! Constructor. Creates a new KGantt::GraphicsView with parent
          * \a parent.
@@ -166,6 +167,36 @@ namespace KGantt {
          */
         void updateScene();
 
+        /*! Enables building the scene in chunks from the event loop
+         * if \a async is true. The default is false.
+         *
+         * When enabled, updateScene() first creates the items of the rows
+         * in the visible area and returns. The remaining rows are added
+         * sceneUpdateChunkSize() rows at a time while the application keeps
+         * processing events. sceneUpdateProgress() is emitted after every
+         * chunk and sceneUpdateFinished() when all rows are in the scene.
+         */
+        void setAsynchronousSceneUpdate( bool async );
+
+        /*! \returns true if the scene is built in chunks.
+         * \see setAsynchronousSceneUpdate
+         */
+        bool asynchronousSceneUpdate() const;
+
+        /*! Sets the number of rows added per chunk by an asynchronous
+         * scene update to \a rows. The default is 500.
+         */
+        void setSceneUpdateChunkSize( int rows );
+
+        /*! \returns the number of rows added per chunk by an asynchronous
+         * scene update.
+         */
+        int sceneUpdateChunkSize() const;
+
+        /*! \returns true while an asynchronous scene update has rows left to add.
+         */
+        bool isSceneUpdatePending() const;
+
 #if 0
         TODO: For 3.0
 
@@ -292,6 +323,15 @@ namespace KGantt {
         void setReadOnly( bool );
 
     Q_SIGNALS:
+        /*! \fn void GraphicsView::sceneUpdateProgress( int rows )
+         * Emitted during an asynchronous scene update with the number of
+         * \a rows added so far. */
+        void sceneUpdateProgress( int rows );
+
+        /*! \fn void GraphicsView::sceneUpdateFinished()
+         * Emitted when an asynchronous scene update has added all rows. */
+        void sceneUpdateFinished();
+
         /*! \fn void GraphicsView::activated( const QModelIndex & index ) */
         void activated( const QModelIndex & index );
 
@@ -320,6 +360,12 @@ namespace KGantt {
         /*reimp*/void resizeEvent( QResizeEvent* ) override;
     private:
         friend class View;
+
+        /* Resets the state of the view, walking the rows from first on
+         * using the row controller. For View, whose rows start at the root
+         * of its left view.
+         */
+        void updateScene( const QModelIndex& first );
     };
 }
 
@@ -24,7 +24,10 @@
 #include "kganttgraphicsscene.h"
 #include "kganttdatetimegrid.h"
 
+#include <QPersistentModelIndex>
 #include <QPointer>
+#include <QSet>
+#include <QTimer>
 
 namespace KGantt {
     class HeaderWidget : public QWidget {
@@ -73,10 +76,23 @@ namespace KGantt {
 
         void removeConstraintsRecursive( QAbstractProxyModel *summaryModel, const QModelIndex& index );
 
+        void startSceneUpdate( const QModelIndex& first );
+        void stopSceneUpdate();
+        void slotSceneUpdateStep();
+
         GraphicsView* q;
         AbstractRowController* rowcontroller;
         HeaderWidget headerwidget;
         GraphicsScene scene;
+
+        /* asynchronous scene update */
+        bool asyncSceneUpdate;
+        int sceneUpdateChunkSize;
+        int sceneUpdateRows;
+        QPersistentModelIndex nextSceneUpdateRow;
+        // the visible rows updated ahead, dropped when the chunks reach them
+        QSet<QPersistentModelIndex> sceneUpdateRowsAhead;
+        QTimer sceneUpdateTimer;
     };
 }
 
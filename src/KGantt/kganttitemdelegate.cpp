@@ -56,6 +56,7 @@ using namespace KGantt;
 
 
 ItemDelegate::Private::Private()
+    : textWidthMetrics( QApplication::font() )
 {
     // Brushes
     QLinearGradient taskgrad( 0., 0., 0., QApplication::fontMetrics().height() );
@@ -104,6 +105,23 @@ QPen ItemDelegate::Private::constraintPen( const QPointF& start, const QPointF&
     return pen;
 }
 
+int ItemDelegate::Private::textWidth( const QString& txt, const QFontMetrics& fm ) const
+{
+    if ( !( fm == textWidthMetrics ) ) {
+        textWidths.clear();
+        textWidthMetrics = fm;
+    }
+    QHash<QString, int>::const_iterator it = textWidths.constFind( txt );
+    if ( it != textWidths.constEnd() )
+        return *it;
+    // Keep the cache bounded for models with many distinct labels
+    if ( textWidths.size() >= 10000 )
+        textWidths.clear();
+    const int width = fm.boundingRect( txt ).width();
+    textWidths.insert( txt, width );
+    return width;
+}
+
 
 ItemDelegate::ItemDelegate( QObject* parent )
     : QItemDelegate( parent ), _d( new Private )
@@ -163,7 +181,8 @@ Span ItemDelegate::itemBoundingSpan( const StyleOptionGanttItem& opt,
 {
     if ( !idx.isValid() ) return Span();
 
-    const QString txt = idx.model()->data( idx, Qt::DisplayRole ).toString();
+    // GraphicsItem already resolved the text for us
+    const QString txt = opt.text.isNull() ? idx.model()->data( idx, Qt::DisplayRole ).toString() : opt.text;
     const int typ = idx.model()->data( idx, ItemTypeRole ).toInt();
     QRectF itemRect = opt.itemRect;
 
@@ -175,7 +194,7 @@ Span ItemDelegate::itemBoundingSpan( const StyleOptionGanttItem& opt,
                            itemRect.height() );
     }
 
-    int tw = opt.fontMetrics.boundingRect( txt ).width();
+    int tw = d->textWidth( txt, opt.fontMetrics );
     tw += static_cast<int>( itemRect.height()/2. );
     Span s;
     switch ( opt.displayPosition ) {
@@ -22,6 +22,7 @@
 
 #include "kganttitemdelegate.h"
 
+#include <QFontMetrics>
 #include <QHash>
 
 namespace KGantt {
@@ -30,9 +31,14 @@ namespace KGantt {
         Private();
 
         QPen constraintPen( const QPointF& start, const QPointF& end, const Constraint& constraint, const QStyleOptionGraphicsItem& opt  );
+        int textWidth( const QString& txt, const QFontMetrics& fm ) const;
 
         QHash<ItemType, QBrush> defaultbrush;
         QHash<ItemType, QPen> defaultpen;
+
+        // item label widths, only valid for textWidthMetrics
+        mutable QHash<QString, int> textWidths;
+        mutable QFontMetrics textWidthMetrics;
     };
 }
 
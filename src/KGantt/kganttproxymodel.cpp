@@ -170,6 +170,11 @@ QVariant ProxyModel::data( const QModelIndex& proxyIdx, int role ) const
     QHash<int, int>::const_iterator it = d->roleMap.find( role );
     if ( it != d->roleMap.end() ) srole = *it;
     it = d->columnMap.find( role );
+    if ( it == d->columnMap.end() ) {
+        // unless mapped explicitly, the epoch roles live next to their QDateTime counterparts
+        if ( role == StartTimeEpochRole ) it = d->columnMap.find( StartTimeRole );
+        else if ( role == EndTimeEpochRole ) it = d->columnMap.find( EndTimeRole );
+    }
     if ( it != d->columnMap.end() ) scol = *it;
 
 #if 0
@@ -198,6 +198,11 @@ QVariant SummaryHandlingProxyModel::data( const QModelIndex& proxyIndex, int rol
   //qDebug() << "SummaryHandlingProxyModel::data("<<proxyIndex<<role<<")";
     const QModelIndex sidx = mapToSource( proxyIndex );
     const QAbstractItemModel* model = sourceModel();
+    if ( d->isSummary(sidx) && ( role==StartTimeEpochRole || role==EndTimeEpochRole ) ) {
+        // what the source model serves would not match the calculated StartTimeRole and
+        // EndTimeRole below; without epoch times, DateTimeGrid maps those instead
+        return QVariant();
+    }
     if ( d->isSummary(sidx) && ( role==StartTimeRole || role==EndTimeRole )) {
       //qDebug() << "requested summary";
         QPair<QDateTime,QDateTime> result;
@@ -142,6 +142,12 @@ void View::Private::updateScene()
     gfxview->clearItems();
     if ( !model) return;
 
+    if ( gfxview->asynchronousSceneUpdate() ) {
+        // the row controller walks the rows of the left view for us
+        gfxview->updateScene( ganttProxyModel.mapFromSource( model->index( 0, 0, leftWidget->rootIndex() ) ) );
+        return;
+    }
+
     if ( QTreeView* tw = qobject_cast<QTreeView*>(leftWidget)) {
       QModelIndex idx = ganttProxyModel.mapFromSource( model->index( 0, 0, leftWidget->rootIndex() ) );
       do {
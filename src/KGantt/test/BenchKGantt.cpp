@@ -0,0 +1,400 @@
+/*
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KGantt library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#undef QT_NO_CAST_FROM_ASCII
+
+#include "BenchKGantt.h"
+
+#include "kganttglobal.h"
+#include "kganttview.h"
+#include "kganttgraphicsview.h"
+#include "kganttconstraint.h"
+#include "kganttconstraintmodel.h"
+#include "kganttdatetimegrid.h"
+#include "kganttsummaryhandlingproxymodel.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QPainter>
+#include <QStandardItemModel>
+
+
+using namespace KGantt;
+
+namespace {
+
+// number of children of each summary in the synthesized projects
+const int Fanout = 10;
+
+/*
+ * Runs \a body once to warm up, then times \a iterations runs of it. The time
+ * per iteration is reported to QTest and kept in \a results for the JSON report,
+ * under the current test function and data tag, so a test function that QTest
+ * runs again replaces its earlier result. Destructive bodies pass 0 for
+ * \a warmUps.
+ */
+template<typename Body>
+void measure( QMap<QString, QJsonObject>* results, const QJsonObject& parameters,
+              int iterations, Body body, int warmUps = 1 )
+{
+    for ( int i = 0; i < warmUps; ++i ) {
+        body();
+    }
+    QElapsedTimer timer;
+    timer.start();
+    for ( int i = 0; i < iterations; ++i ) {
+        body();
+    }
+    const qreal msecs = timer.nsecsElapsed() / 1000000.0 / iterations;
+    QTest::setBenchmarkResult( msecs, QTest::WalltimeMilliseconds );
+
+    QJsonObject result;
+    result.insert( "benchmark", QString::fromLatin1( QTest::currentTestFunction() ) );
+    result.insert( "dataTag", QString::fromLatin1( QTest::currentDataTag() ) );
+    result.insert( "parameters", parameters );
+    result.insert( "iterations", iterations );
+    result.insert( "msecsPerIteration", msecs );
+    results->insert( QString::fromLatin1( QTest::currentTestFunction() ) + QLatin1Char( '/' )
+                     + QString::fromLatin1( QTest::currentDataTag() ), result );
+}
+
+QList<QStandardItem*> createRow( const QString& name, ItemType type,
+                                 const QDateTime& start, const QDateTime& end )
+{
+    // column 0 carries the gantt roles for the SummaryHandlingProxyModel,
+    // columns 1 to 3 are what the default ProxyModel of the View expects
+    QList<QStandardItem*> items;
+    QStandardItem* item = new QStandardItem( name );
+    item->setData( type, ItemTypeRole );
+    item->setData( start, StartTimeRole );
+    item->setData( end, EndTimeRole );
+    items << item;
+    items << new QStandardItem( QString::number( type ) );
+    item = new QStandardItem();
+    item->setData( start, StartTimeRole );
+    items << item;
+    item = new QStandardItem();
+    item->setData( end, EndTimeRole );
+    items << item;
+    return items;
+}
+
+void addTasks( QStandardItem* parent, int count, int level, int depth,
+               QList<QPersistentModelIndex>* leaves, int* taskNumber )
+{
+    static const QDateTime projectStart( QDate( 2020, 1, 6 ), QTime( 8, 0 ) );
+    if ( level == depth - 1 || count <= Fanout ) {
+        for ( int i = 0; i < count; ++i ) {
+            const int number = ( *taskNumber )++;
+            const QDateTime start = projectStart.addDays( number % 365 ).addSecs( 3600 * ( number % 8 ) );
+            const QList<QStandardItem*> row = createRow( QString( "Task %1" ).arg( number ), TypeTask,
+                                                         start, start.addDays( 1 + number % 5 ) );
+            parent->appendRow( row );
+            leaves->append( row.first()->index() );
+        }
+        return;
+    }
+    const int perSummary = ( count + Fanout - 1 ) / Fanout;
+    for ( int remaining = count; remaining > 0; remaining -= perSummary ) {
+        const QList<QStandardItem*> row = createRow( QString( "Summary %1" ).arg( *taskNumber ), TypeSummary,
+                                                     projectStart, projectStart );
+        parent->appendRow( row );
+        addTasks( row.first(), qMin( perSummary, remaining ), level + 1, depth, leaves, taskNumber );
+    }
+}
+
+// Fills \a model with a project of \a tasks leaf tasks nested \a depth levels deep
+// and returns the indexes of the leaf tasks.
+QList<QPersistentModelIndex> createProject( QStandardItemModel* model, int tasks, int depth )
+{
+    model->setHorizontalHeaderLabels( QStringList() << "Title" << "Type" << "Start" << "End" );
+    QList<QPersistentModelIndex> leaves;
+    int taskNumber = 0;
+    addTasks( model->invisibleRootItem(), tasks, 0, depth, &leaves, &taskNumber );
+    return leaves;
+}
+
+QList<Constraint> createConstraints( const QList<QPersistentModelIndex>& leaves, int count )
+{
+    QList<Constraint> constraints;
+    const int n = leaves.count();
+    if ( n < 2 ) return constraints;
+    constraints.reserve( count );
+    for ( int i = 0; i < count; ++i ) {
+        const int from = i % n;
+        int to = ( from + 1 + ( i / n ) * 7 ) % n;
+        if ( to == from ) to = ( to + 1 ) % n;
+        constraints << Constraint( leaves.at( from ), leaves.at( to ) );
+    }
+    return constraints;
+}
+
+QJsonObject projectParameters( int tasks, int constraints, int depth )
+{
+    QJsonObject parameters;
+    parameters.insert( "tasks", tasks );
+    parameters.insert( "constraints", constraints );
+    parameters.insert( "depth", depth );
+    return parameters;
+}
+
+}
+
+void BenchKGantt::cleanupTestCase()
+{
+    QString fileName = QString::fromLocal8Bit( qgetenv( "KGANTT_BENCHMARK_JSON" ) );
+    if ( fileName.isEmpty() ) fileName = "kgantt-benchmarks.json";
+    QFile file( fileName );
+    QVERIFY2( file.open( QIODevice::WriteOnly | QIODevice::Truncate ), qPrintable( file.errorString() ) );
+    QJsonObject report;
+    report.insert( "qtVersion", QString::fromLatin1( qVersion() ) );
+    QJsonArray resultArray;
+    Q_FOREACH( const QJsonObject& result, results ) {
+        resultArray.append( result );
+    }
+    report.insert( "results", resultArray );
+    file.write( QJsonDocument( report ).toJson() );
+}
+
+void BenchKGantt::addProjectData()
+{
+    QTest::addColumn<int>( "tasks" );
+    QTest::addColumn<int>( "constraints" );
+    QTest::addColumn<int>( "depth" );
+
+    QTest::newRow( "1k tasks, flat" ) << 1000 << 1000 << 1;
+    QTest::newRow( "10k tasks, depth 3" ) << 10000 << 10000 << 3;
+    QTest::newRow( "50k tasks, depth 5" ) << 50000 << 50000 << 5;
+}
+
+void BenchKGantt::benchmarkConstraintModelAdd_data()
+{
+    addProjectData();
+}
+
+void BenchKGantt::benchmarkConstraintModelAdd()
+{
+    QFETCH( int, tasks );
+    QFETCH( int, constraints );
+    QFETCH( int, depth );
+
+    QStandardItemModel model;
+    const QList<Constraint> list = createConstraints( createProject( &model, tasks, depth ), constraints );
+
+    measure( &results, projectParameters( tasks, constraints, depth ), 5, [&list] {
+        ConstraintModel constraintModel;
+        Q_FOREACH( const Constraint& c, list ) {
+            constraintModel.addConstraint( c );
+        }
+    } );
+}
+
+void BenchKGantt::benchmarkConstraintModelLookup_data()
+{
+    addProjectData();
+}
+
+void BenchKGantt::benchmarkConstraintModelLookup()
+{
+    QFETCH( int, tasks );
+    QFETCH( int, constraints );
+    QFETCH( int, depth );
+
+    QStandardItemModel model;
+    const QList<QPersistentModelIndex> leaves = createProject( &model, tasks, depth );
+    const QList<Constraint> list = createConstraints( leaves, constraints );
+    ConstraintModel constraintModel;
+    Q_FOREACH( const Constraint& c, list ) {
+        constraintModel.addConstraint( c );
+    }
+
+    measure( &results, projectParameters( tasks, constraints, depth ), 10, [&] {
+        Q_FOREACH( const QPersistentModelIndex& idx, leaves ) {
+            constraintModel.constraintsForIndex( idx );
+        }
+        Q_FOREACH( const Constraint& c, list ) {
+            constraintModel.hasConstraint( c );
+        }
+    } );
+}
+
+void BenchKGantt::benchmarkConstraintModelRemove_data()
+{
+    addProjectData();
+}
+
+void BenchKGantt::benchmarkConstraintModelRemove()
+{
+    QFETCH( int, tasks );
+    QFETCH( int, constraints );
+    QFETCH( int, depth );
+
+    QStandardItemModel model;
+    const QList<Constraint> list = createConstraints( createProject( &model, tasks, depth ), constraints );
+    ConstraintModel constraintModel;
+    Q_FOREACH( const Constraint& c, list ) {
+        constraintModel.addConstraint( c );
+    }
+
+    // removing is destructive, so it can only be measured once
+    measure( &results, projectParameters( tasks, constraints, depth ), 1, [&] {
+        Q_FOREACH( const Constraint& c, list ) {
+            constraintModel.removeConstraint( c );
+        }
+    }, 0 );
+    QVERIFY( constraintModel.constraints().isEmpty() );
+}
+
+void BenchKGantt::benchmarkUpdateScene_data()
+{
+    addProjectData();
+}
+
+void BenchKGantt::benchmarkUpdateScene()
+{
+    QFETCH( int, tasks );
+    QFETCH( int, constraints );
+    QFETCH( int, depth );
+
+    QStandardItemModel model;
+    const QList<QPersistentModelIndex> leaves = createProject( &model, tasks, depth );
+    View view;
+    view.setModel( &model );
+    view.setConstraintModel( new ConstraintModel( &view ) );
+    Q_FOREACH( const Constraint& c, createConstraints( leaves, constraints ) ) {
+        view.constraintModel()->addConstraint( c );
+    }
+    view.expandAll();
+
+    measure( &results, projectParameters( tasks, constraints, depth ), 5, [&view] {
+        view.graphicsView()->updateScene();
+    } );
+}
+
+void BenchKGantt::benchmarkSummaryRecalculation_data()
+{
+    addProjectData();
+}
+
+void BenchKGantt::benchmarkSummaryRecalculation()
+{
+    QFETCH( int, tasks );
+    QFETCH( int, constraints );
+    QFETCH( int, depth );
+
+    QStandardItemModel model;
+    const QList<QPersistentModelIndex> leaves = createProject( &model, tasks, depth );
+    SummaryHandlingProxyModel proxy;
+    proxy.setSourceModel( &model );
+
+    // fill the summary cache
+    for ( int row = 0; row < proxy.rowCount(); ++row ) {
+        proxy.data( proxy.index( row, 0 ), EndTimeRole );
+    }
+
+    // edit the deepest leaf of the first summary and ask for the top level summary again
+    const QModelIndex leaf = proxy.mapFromSource( leaves.first() );
+    QModelIndex top = leaf;
+    while ( top.parent().isValid() ) top = top.parent();
+    const QDateTime end = proxy.data( leaf, EndTimeRole ).toDateTime();
+    int i = 0;
+
+    measure( &results, projectParameters( tasks, constraints, depth ), 1000, [&] {
+        proxy.setData( leaf, end.addDays( ++i % 100 ), EndTimeRole );
+        proxy.data( top, EndTimeRole );
+    } );
+}
+
+void BenchKGantt::benchmarkGridScrolling_data()
+{
+    QTest::addColumn<int>( "scale" );
+
+    QTest::newRow( "hours" ) << int( DateTimeGrid::ScaleHour );
+    QTest::newRow( "days" ) << int( DateTimeGrid::ScaleDay );
+    QTest::newRow( "weeks" ) << int( DateTimeGrid::ScaleWeek );
+    QTest::newRow( "months" ) << int( DateTimeGrid::ScaleMonth );
+}
+
+void BenchKGantt::benchmarkGridScrolling()
+{
+    QFETCH( int, scale );
+
+    QStandardItemModel model;
+    createProject( &model, 1000, 2 );
+    View view;
+    view.setModel( &model );
+    view.expandAll();
+    DateTimeGrid* grid = qobject_cast<DateTimeGrid*>( view.grid() );
+    QVERIFY( grid );
+    grid->setScale( static_cast<DateTimeGrid::Scale>( scale ) );
+
+    QImage image( 1200, 800, QImage::Format_ARGB32_Premultiplied );
+    QPainter painter( &image );
+    const QRectF headerRect( 0, 0, image.width(), 40 );
+    const QRectF sceneRect = view.graphicsView()->sceneRect();
+    const qreal step = image.width() / 10.0;
+
+    QJsonObject parameters;
+    parameters.insert( "scale", scale );
+    measure( &results, parameters, 20, [&] {
+        // scroll one screen width to the right, a tenth at a time
+        for ( int i = 0; i < 10; ++i ) {
+            const qreal offset = i * step;
+            const QRectF exposed( offset, 0, image.width(), image.height() );
+            grid->paintHeader( &painter, headerRect, exposed, offset );
+            grid->paintGrid( &painter, sceneRect, exposed, view.graphicsView()->rowController() );
+        }
+    } );
+}
+
+void BenchKGantt::benchmarkPrint_data()
+{
+    addProjectData();
+}
+
+void BenchKGantt::benchmarkPrint()
+{
+    QFETCH( int, tasks );
+    QFETCH( int, constraints );
+    QFETCH( int, depth );
+
+    QStandardItemModel model;
+    const QList<QPersistentModelIndex> leaves = createProject( &model, tasks, depth );
+    View view;
+    view.setModel( &model );
+    view.setConstraintModel( new ConstraintModel( &view ) );
+    Q_FOREACH( const Constraint& c, createConstraints( leaves, constraints ) ) {
+        view.constraintModel()->addConstraint( c );
+    }
+    view.expandAll();
+
+    QImage image( 2000, 1400, QImage::Format_ARGB32_Premultiplied );
+    QPainter painter( &image );
+
+    measure( &results, projectParameters( tasks, constraints, depth ), 3, [&] {
+        view.graphicsView()->print( &painter, QRectF( image.rect() ) );
+    } );
+}
+
+QTEST_MAIN(BenchKGantt)
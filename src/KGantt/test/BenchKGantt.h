@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2001-2015 Klaralvdalens Datakonsult AB.  All rights reserved.
+ *
+ * This file is part of the KGantt library.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef BENCHKGANTT_H
+#define BENCHKGANTT_H
+
+#include <QtTest>
+#include <QJsonObject>
+#include <QMap>
+
+/*
+ * Benchmarks for the KGantt scene, model and printing paths.
+ *
+ * Each benchmark times a fixed number of iterations after a warm-up run and
+ * reports the result to QTestLib. The results are also written as JSON to
+ * the file named by the KGANTT_BENCHMARK_JSON environment variable
+ * (kgantt-benchmarks.json in the current directory by default).
+ */
+class BenchKGantt : public QObject
+{
+    Q_OBJECT
+private:
+    // by test function and data tag
+    QMap<QString, QJsonObject> results;
+
+    void addProjectData();
+
+private Q_SLOTS:
+    void cleanupTestCase();
+
+    void benchmarkConstraintModelAdd_data();
+    void benchmarkConstraintModelAdd();
+    void benchmarkConstraintModelLookup_data();
+    void benchmarkConstraintModelLookup();
+    void benchmarkConstraintModelRemove_data();
+    void benchmarkConstraintModelRemove();
+
+    void benchmarkUpdateScene_data();
+    void benchmarkUpdateScene();
+
+    void benchmarkSummaryRecalculation_data();
+    void benchmarkSummaryRecalculation();
+
+    void benchmarkGridScrolling_data();
+    void benchmarkGridScrolling();
+
+    void benchmarkPrint_data();
+    void benchmarkPrint();
+};
+#endif
@@ -27,6 +27,7 @@
 #include "kganttgraphicsview.h"
 #include "kganttgraphicsscene.h"
 #include "kganttgraphicsitem.h"
+#include "kganttconstraintgraphicsitem.h"
 #include "kganttconstraintmodel.h"
 #include "kgantttreeviewrowcontroller.h"
 #include "kganttlistviewrowcontroller.h"
@@ -35,7 +36,11 @@
 #include "kganttdatetimegrid.h"
 #include "kgantttreeviewrowcontroller.h"
 
+#include <QCoreApplication>
+#include <QImage>
 #include <QListView>
+#include <QPainter>
+#include <QSignalSpy>
 #include <QTreeView>
 
 
@@ -233,6 +238,27 @@ void TestKGanttView::testTreeView()
     QCOMPARE(view->graphicsView()->scene()->items().count(), 1);
 }
 
+void TestKGanttView::testAsynchronousSceneUpdate()
+{
+    initTreeModel();
+    view->expandAll();
+    QCOMPARE(view->graphicsView()->scene()->items().count(), 3);
+
+    GraphicsView *gfxview = view->graphicsView();
+    gfxview->setAsynchronousSceneUpdate(true);
+    gfxview->setSceneUpdateChunkSize(1);
+    QSignalSpy progressSpy(gfxview, SIGNAL(sceneUpdateProgress(int)));
+    QSignalSpy finishedSpy(gfxview, SIGNAL(sceneUpdateFinished()));
+
+    gfxview->updateScene();
+    QVERIFY(gfxview->isSceneUpdatePending());
+    QVERIFY(finishedSpy.wait());
+    QVERIFY(!gfxview->isSceneUpdatePending());
+    QCOMPARE(progressSpy.count(), 3);
+    QCOMPARE(progressSpy.last().at(0).toInt(), 3);
+    QCOMPARE(gfxview->scene()->items().count(), 3);
+}
+
 void TestKGanttView::initListModel()
 {
     QList<QStandardItem*> items;
@@ -270,6 +296,17 @@ void TestKGanttView::testListView()
     initListModel();
 }
 
+// Constraint items are created once they have been painted for the first time
+static int paintedItemCount(View *view)
+{
+    QGraphicsScene *scene = view->graphicsView()->scene();
+    QImage image(100, 100, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    scene->render(&painter);
+    QCoreApplication::processEvents();
+    return scene->items().count();
+}
+
 void TestKGanttView::testConstraints()
 {
     initTreeModel();
@@ -283,27 +320,51 @@ void TestKGanttView::testConstraints()
     QCOMPARE(model->constraints().count(), 1);
     QVERIFY(model->hasConstraint(Constraint(idx1, idx2)));
     
-    QCOMPARE(view->graphicsView()->scene()->items().count(), 1);
+    QCOMPARE(paintedItemCount(view), 1);
     view->expandAll();
-    QCOMPARE(view->graphicsView()->scene()->items().count(), 4);
+    QCOMPARE(paintedItemCount(view), 4);
     view->collapseAll();
-    QCOMPARE(view->graphicsView()->scene()->items().count(), 1); // constraint item also removed
+    QCOMPARE(paintedItemCount(view), 1); // constraint item also removed
     QCOMPARE(model->constraints().count(), 1); // the constraint is not removed
 
     view->expandAll();
     model->removeConstraint(model->constraints().first());
-    QCOMPARE(view->graphicsView()->scene()->items().count(), 3); // constraint item also removed
+    QCOMPARE(paintedItemCount(view), 3); // constraint item also removed
     QCOMPARE(model->constraints().count(), 0); // the constraint is removed
 
     model->addConstraint(Constraint(idx1, idx2));
-    QCOMPARE(view->graphicsView()->scene()->items().count(), 4);
+    // the constraint item is only created when it gets painted...
+    QCOMPARE(view->graphicsView()->scene()->items().count(), 3);
+    QCOMPARE(paintedItemCount(view), 4);
+
+    // ...or asked for
+    model->removeConstraint(Constraint(idx1, idx2));
+    QCOMPARE(paintedItemCount(view), 3);
+    model->addConstraint(Constraint(idx1, idx2));
+    GraphicsScene *scene = qobject_cast<GraphicsScene*>(view->graphicsView()->scene());
+    QVERIFY(scene);
+    QVERIFY(scene->findConstraintItem(Constraint(idx1, idx2)));
+    QCOMPARE(scene->items().count(), 4);
+    QCOMPARE(paintedItemCount(view), 4);
+
+    // removing one of two pending constraints between the same items keeps the other one
+    model->removeConstraint(Constraint(idx1, idx2));
+    QCOMPARE(paintedItemCount(view), 3);
+    const Constraint startStart(idx1, idx2, Constraint::TypeSoft, Constraint::StartStart);
+    model->addConstraint(Constraint(idx1, idx2));
+    model->addConstraint(startStart);
+    model->removeConstraint(Constraint(idx1, idx2));
+    ConstraintGraphicsItem *citem = scene->findConstraintItem(startStart);
+    QVERIFY(citem);
+    QCOMPARE(citem->constraint(), startStart);
+    QCOMPARE(paintedItemCount(view), 4);
 
     QVERIFY(itemModel->removeRows(idx1.row(), 1, idx1.parent()));
-    QCOMPARE(view->graphicsView()->scene()->items().count(), 2); // constraint item also removed
+    QCOMPARE(paintedItemCount(view), 2); // constraint item also removed
     QCOMPARE(model->constraints().count(), 0); // the constraint is also removed
 
     itemModel->clear();
-    QCOMPARE(view->graphicsView()->scene()->items().count(), 0);
+    QCOMPARE(paintedItemCount(view), 0);
     initTreeModel();
 
     idx1 = itemModel->index(0, 0, itemModel->index(0, 0));
@@ -315,13 +376,13 @@ void TestKGanttView::testConstraints()
 
     // adding new items shall not affect existing constraints
     initTreeModel(); // add more items, will also collapseAll()
-    QCOMPARE(view->graphicsView()->scene()->items().count(), 2);
+    QCOMPARE(paintedItemCount(view), 2);
     view->expandAll();
-    QCOMPARE(view->graphicsView()->scene()->items().count(), 7);
+    QCOMPARE(paintedItemCount(view), 7);
 
     // removing items wo constraints shall not affect existing constraints
     QVERIFY(itemModel->removeRows(0, 1, itemModel->index(1, 0)));
-    QCOMPARE(view->graphicsView()->scene()->items().count(), 6);
+    QCOMPARE(paintedItemCount(view), 6);
 
     // must be possible to add constraints between items with different parent
     QPersistentModelIndex idx3 = itemModel->index(0, 0, itemModel->index(1, 0));
@@ -329,12 +390,12 @@ void TestKGanttView::testConstraints()
     model->addConstraint(Constraint(idx2, idx3));
     QCOMPARE(model->constraints().count(), 2);
     QVERIFY(model->hasConstraint(Constraint(idx2, idx3)));
-    QCOMPARE(view->graphicsView()->scene()->items().count(), 7);
+    QCOMPARE(paintedItemCount(view), 7);
 
     // removing summary item shall also remove child item + any constraints to the child item
     QVERIFY(itemModel->removeRows(1, 1));
     QCOMPARE(model->constraints().count(), 1);
-    QCOMPARE(view->graphicsView()->scene()->items().count(), 4);
+    QCOMPARE(paintedItemCount(view), 4);
     
 }
 
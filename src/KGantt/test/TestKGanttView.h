@@ -52,6 +52,8 @@ private Q_SLOTS:
 
     void testTreeView();
 
+    void testAsynchronousSceneUpdate();
+
     void testListView();
 
     void testConstraints();